@@ -0,0 +1,60 @@
+#include "AffineTransform.h"
+#include <cmath>
+
+AffineTransform AffineTransform::translation(double dx, double dy) {
+    AffineTransform t;
+    t.tx = dx;
+    t.ty = dy;
+    return t;
+}
+
+AffineTransform AffineTransform::rotationDeg(double angleDeg) {
+    constexpr double PI = 3.14159265358979323846;
+    const double rad = angleDeg * PI / 180.0;
+    const double cosA = std::cos(rad);
+    const double sinA = std::sin(rad);
+
+    AffineTransform t;
+    t.a = cosA; t.b = -sinA;
+    t.c = sinA; t.d = cosA;
+    return t;
+}
+
+AffineTransform AffineTransform::scaling(double sx, double sy) {
+    AffineTransform t;
+    t.a = sx;
+    t.d = sy;
+    return t;
+}
+
+// Returns next * this, i.e. the matrix product that applies *this first.
+AffineTransform AffineTransform::then(const AffineTransform& next) const {
+    AffineTransform r;
+    r.a = next.a * a + next.b * c;
+    r.b = next.a * b + next.b * d;
+    r.tx = next.a * tx + next.b * ty + next.tx;
+    r.c = next.c * a + next.d * c;
+    r.d = next.c * b + next.d * d;
+    r.ty = next.c * tx + next.d * ty + next.ty;
+    return r;
+}
+
+void AffineTransform::applyToBits(const float* xy, size_t pointCount, INT* outXY) const {
+    for (size_t i = 0; i < pointCount; ++i) {
+        const double x = xy[2 * i];
+        const double y = xy[2 * i + 1];
+        outXY[2 * i] = static_cast<INT>(std::round(a * x + b * y + tx));
+        outXY[2 * i + 1] = static_cast<INT>(std::round(c * x + d * y + ty));
+    }
+}
+
+void AffineTransform::applyToBits3D(const float* xyz, size_t pointCount, double zScale, INT* outXYZ) const {
+    for (size_t i = 0; i < pointCount; ++i) {
+        const double x = xyz[3 * i];
+        const double y = xyz[3 * i + 1];
+        const double z = xyz[3 * i + 2];
+        outXYZ[3 * i] = static_cast<INT>(std::round(a * x + b * y + tx));
+        outXYZ[3 * i + 1] = static_cast<INT>(std::round(c * x + d * y + ty));
+        outXYZ[3 * i + 2] = static_cast<INT>(std::round(z * zScale));
+    }
+}
\ No newline at end of file
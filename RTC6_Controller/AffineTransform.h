@@ -0,0 +1,52 @@
+#pragma once
+
+#include "RTC6impl.h" // For INT
+#include <cstddef>
+
+/**
+ * @brief A 2D affine transform: x' = a*x + b*y + tx, y' = c*x + d*y + ty.
+ *
+ * GeometryHandler fuses every per-layer stage (part scale, WorkPlane rotation,
+ * WorkPlane offset, machine calibration and the mm-to-bits factor) into one
+ * instance of this struct when a layer begins, then quantizes it into the
+ * FixedPointTransform that converts the points.
+ */
+struct AffineTransform {
+    double a = 1.0;
+    double b = 0.0;
+    double tx = 0.0;
+    double c = 0.0;
+    double d = 1.0;
+    double ty = 0.0;
+
+    static AffineTransform translation(double dx, double dy);
+    static AffineTransform rotationDeg(double angleDeg);
+    static AffineTransform scaling(double sx, double sy);
+
+    /**
+     * @brief Composes two transforms.
+     * @param next The transform to apply after this one.
+     * @return A transform equivalent to applying *this first, then `next`.
+     */
+    AffineTransform then(const AffineTransform& next) const;
+
+    /**
+     * @brief Transforms interleaved (x, y) float pairs and rounds them to integer bits.
+     *
+     * Double-precision reference for FixedPointTransform::applyToBits, which is the
+     * kernel GeometryHandler runs. Rounding is half away from zero, matching std::round.
+     *
+     * @param xy Pointer to `pointCount` interleaved x/y pairs.
+     * @param pointCount The number of points (not floats) to convert.
+     * @param outXY Destination for `pointCount` interleaved integer x/y pairs.
+     */
+    void applyToBits(const float* xy, size_t pointCount, INT* outXY) const;
+
+    /**
+     * @brief 3D variant of applyToBits for interleaved (x, y, z) float triples.
+     *
+     * x and y go through the affine transform; z is only multiplied by `zScale`,
+     * since WorkPlane rotation and offset act in the scan plane.
+     */
+    void applyToBits3D(const float* xyz, size_t pointCount, double zScale, INT* outXYZ) const;
+};
\ No newline at end of file
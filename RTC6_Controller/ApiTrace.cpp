@@ -0,0 +1,366 @@
+#include "ApiTrace.h"
+#include "Rtc6Constants.h"
+#include "Rtc6Exception.h"
+#include <chrono>
+#include <cstring>
+
+namespace {
+    int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    INT asInt(UINT value) { return static_cast<INT>(value); }
+    UINT asUint(INT value) { return static_cast<UINT>(value); }
+
+    // Longer waits sleep; the last part is spun so calls keep their recorded spacing.
+    constexpr int64_t REPLAY_SPIN_NS = 2000000;
+}
+
+// --- RecordingRtcApi ---
+
+RecordingRtcApi::RecordingRtcApi(InterfaceRtcApi& target, std::ostream& out, size_t capacity)
+    : m_target(target),
+    m_out(out),
+    m_buffer(capacity),
+    m_startNs(nowNs()) {
+    m_batch.reserve(m_buffer.capacity());
+    const ApiTraceHeader header;
+    m_out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_thread = std::thread(&RecordingRtcApi::writerLoop, this);
+}
+
+RecordingRtcApi::~RecordingRtcApi() {
+    m_stopping.store(true);
+    m_thread.join();
+    m_out.flush();
+}
+
+void RecordingRtcApi::record(ApiCall call, uint8_t listNo, INT a, INT b, INT c, double value) {
+    ApiTraceRecord record;
+    record.timestampNs = nowNs() - m_startNs;
+    record.call = call;
+    record.listNo = listNo;
+    record.args[0] = a;
+    record.args[1] = b;
+    record.args[2] = c;
+    record.value = value;
+    if (!m_buffer.tryPush(record)) {
+        m_stalls.fetch_add(1, std::memory_order_relaxed);
+        while (!m_buffer.tryPush(record)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void RecordingRtcApi::flush() {
+    const size_t target = m_buffer.pushedCount();
+    while (m_written.load(std::memory_order_acquire) < target) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+void RecordingRtcApi::writerLoop() {
+    for (;;) {
+        if (!drainBatch()) {
+            if (m_stopping.load()) {
+                while (drainBatch()) {}
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+// Writes everything currently in the buffer with a single stream write.
+bool RecordingRtcApi::drainBatch() {
+    m_batch.clear();
+    ApiTraceRecord record;
+    while (m_batch.size() < m_buffer.capacity() && m_buffer.tryPop(record)) {
+        m_batch.push_back(record);
+    }
+    if (m_batch.empty()) {
+        return false;
+    }
+    m_out.write(reinterpret_cast<const char*>(m_batch.data()),
+        static_cast<std::streamsize>(m_batch.size() * sizeof(ApiTraceRecord)));
+    m_out.flush();
+    m_written.fetch_add(m_batch.size(), std::memory_order_release);
+    return true;
+}
+
+// The call is recorded before it is forwarded, so the timestamp is when the host issued it.
+// read_status, get_list_space, get_out_pointer and get_input_pointer are recorded after,
+// together with what the board returned.
+
+void RecordingRtcApi::api_auto_change() {
+    record(ApiCall::AutoChange, 0);
+    m_target.api_auto_change();
+}
+
+void RecordingRtcApi::api_set_start_list(UINT listNo) {
+    m_loadingList = static_cast<uint8_t>(listNo);
+    record(ApiCall::SetStartList, m_loadingList);
+    m_target.api_set_start_list(listNo);
+}
+
+void RecordingRtcApi::api_set_end_of_list() {
+    record(ApiCall::SetEndOfList, m_loadingList);
+    m_loadingList = 0;
+    m_target.api_set_end_of_list();
+}
+
+void RecordingRtcApi::api_execute_list(UINT listNo) {
+    record(ApiCall::ExecuteList, static_cast<uint8_t>(listNo));
+    m_target.api_execute_list(listNo);
+}
+
+UINT RecordingRtcApi::api_read_status() {
+    const UINT status = m_target.api_read_status();
+    record(ApiCall::ReadStatus, 0, asInt(status));
+    return status;
+}
+
+UINT RecordingRtcApi::api_get_list_space() {
+    const UINT space = m_target.api_get_list_space();
+    record(ApiCall::GetListSpace, m_loadingList, asInt(space));
+    return space;
+}
+
+void RecordingRtcApi::api_jump_abs(INT x, INT y) {
+    record(ApiCall::JumpAbs, m_loadingList, x, y);
+    m_target.api_jump_abs(x, y);
+}
+
+void RecordingRtcApi::api_mark_abs(INT x, INT y) {
+    record(ApiCall::MarkAbs, m_loadingList, x, y);
+    m_target.api_mark_abs(x, y);
+}
+
+void RecordingRtcApi::api_jump_abs_3d(INT x, INT y, INT z) {
+    record(ApiCall::JumpAbs3D, m_loadingList, x, y, z);
+    m_target.api_jump_abs_3d(x, y, z);
+}
+
+void RecordingRtcApi::api_mark_abs_3d(INT x, INT y, INT z) {
+    record(ApiCall::MarkAbs3D, m_loadingList, x, y, z);
+    m_target.api_mark_abs_3d(x, y, z);
+}
+
+void RecordingRtcApi::api_laser_on_list(UINT period) {
+    record(ApiCall::LaserOnList, m_loadingList, asInt(period));
+    m_target.api_laser_on_list(period);
+}
+
+void RecordingRtcApi::api_set_defocus_list(INT offset) {
+    record(ApiCall::SetDefocusList, m_loadingList, offset);
+    m_target.api_set_defocus_list(offset);
+}
+
+void RecordingRtcApi::api_set_mark_speed(double speed) {
+    record(ApiCall::SetMarkSpeed, m_loadingList, 0, 0, 0, speed);
+    m_target.api_set_mark_speed(speed);
+}
+
+void RecordingRtcApi::api_set_laser_power(UINT port, UINT power) {
+    record(ApiCall::SetLaserPower, m_loadingList, asInt(port), asInt(power));
+    m_target.api_set_laser_power(port, power);
+}
+
+void RecordingRtcApi::api_set_jump_speed(double speed) {
+    record(ApiCall::SetJumpSpeed, m_loadingList, 0, 0, 0, speed);
+    m_target.api_set_jump_speed(speed);
+}
+
+void RecordingRtcApi::api_set_scanner_delays(UINT jump, UINT mark, UINT polygon) {
+    record(ApiCall::SetScannerDelays, m_loadingList, asInt(jump), asInt(mark), asInt(polygon));
+    m_target.api_set_scanner_delays(jump, mark, polygon);
+}
+
+void RecordingRtcApi::api_set_laser_delays(INT laserOnDelay, UINT laserOffDelay) {
+    record(ApiCall::SetLaserDelays, m_loadingList, laserOnDelay, asInt(laserOffDelay));
+    m_target.api_set_laser_delays(laserOnDelay, laserOffDelay);
+}
+
+void RecordingRtcApi::api_set_sky_writing_mode(UINT mode) {
+    record(ApiCall::SetSkyWritingMode, m_loadingList, asInt(mode));
+    m_target.api_set_sky_writing_mode(mode);
+}
+
+void RecordingRtcApi::api_set_sky_writing_para(double timelag, INT laserOnShift, UINT nPrev, UINT nPost) {
+    record(ApiCall::SetSkyWritingPara, m_loadingList, laserOnShift, asInt(nPrev), asInt(nPost), timelag);
+    m_target.api_set_sky_writing_para(timelag, laserOnShift, nPrev, nPost);
+}
+
+void RecordingRtcApi::api_set_sky_writing_limit(double cosAngle) {
+    record(ApiCall::SetSkyWritingLimit, m_loadingList, 0, 0, 0, cosAngle);
+    m_target.api_set_sky_writing_limit(cosAngle);
+}
+
+void RecordingRtcApi::api_set_wobbel_mode(UINT transversal, UINT longitudinal, double freq, INT mode) {
+    record(ApiCall::SetWobbelMode, m_loadingList, asInt(transversal), asInt(longitudinal), mode, freq);
+    m_target.api_set_wobbel_mode(transversal, longitudinal, freq, mode);
+}
+
+void RecordingRtcApi::api_set_jump_mode(INT flag) {
+    record(ApiCall::SetJumpMode, m_loadingList, flag);
+    m_target.api_set_jump_mode(flag);
+}
+
+void RecordingRtcApi::api_list_repeat() {
+    record(ApiCall::ListRepeat, m_loadingList);
+    m_target.api_list_repeat();
+}
+
+void RecordingRtcApi::api_list_until(UINT number) {
+    record(ApiCall::ListUntil, m_loadingList, asInt(number));
+    m_target.api_list_until(number);
+}
+
+void RecordingRtcApi::api_jump_rel(INT dx, INT dy) {
+    record(ApiCall::JumpRel, m_loadingList, dx, dy);
+    m_target.api_jump_rel(dx, dy);
+}
+
+void RecordingRtcApi::api_mark_rel(INT dx, INT dy) {
+    record(ApiCall::MarkRel, m_loadingList, dx, dy);
+    m_target.api_mark_rel(dx, dy);
+}
+
+// Subroutines go into the protected area; their commands are traced with list number 0.
+void RecordingRtcApi::api_load_sub(UINT index) {
+    m_loadingList = 0;
+    record(ApiCall::LoadSub, 0, asInt(index));
+    m_target.api_load_sub(index);
+}
+
+void RecordingRtcApi::api_list_return() {
+    record(ApiCall::ListReturn, m_loadingList);
+    m_target.api_list_return();
+}
+
+void RecordingRtcApi::api_sub_call(UINT index) {
+    record(ApiCall::SubCall, m_loadingList, asInt(index));
+    m_target.api_sub_call(index);
+}
+
+void RecordingRtcApi::api_load_list(UINT listNo, UINT pos) {
+    m_loadingList = static_cast<uint8_t>(listNo);
+    record(ApiCall::LoadList, m_loadingList, asInt(pos));
+    m_target.api_load_list(listNo, pos);
+}
+
+void RecordingRtcApi::api_stop_execution() {
+    record(ApiCall::StopExecution, 0);
+    m_target.api_stop_execution();
+}
+
+void RecordingRtcApi::api_get_out_pointer(UINT& listNo, UINT& pos) {
+    m_target.api_get_out_pointer(listNo, pos);
+    record(ApiCall::GetOutPointer, static_cast<uint8_t>(listNo), asInt(pos));
+}
+
+UINT RecordingRtcApi::api_get_input_pointer() {
+    const UINT pos = m_target.api_get_input_pointer();
+    record(ApiCall::GetInputPointer, m_loadingList, asInt(pos));
+    return pos;
+}
+
+// --- Reading and replaying ---
+
+std::vector<ApiTraceRecord> readApiTrace(std::istream& in) {
+    const ApiTraceHeader expected;
+    ApiTraceHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0) {
+        throw FileParseError("Not an RTC6 API trace.");
+    }
+    if (header.version != expected.version || header.recordSize != expected.recordSize) {
+        throw FileParseError("Unsupported RTC6 API trace version " + std::to_string(header.version) + ".");
+    }
+
+    std::vector<ApiTraceRecord> records;
+    ApiTraceRecord record;
+    while (in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        if (record.call >= ApiCall::Count) {
+            throw FileParseError("Unknown call in RTC6 API trace at record " + std::to_string(records.size()) + ".");
+        }
+        records.push_back(record);
+    }
+    if (in.gcount() != 0) {
+        throw FileParseError("RTC6 API trace ends inside a record.");
+    }
+    return records;
+}
+
+ReplayStats replayApiTrace(const std::vector<ApiTraceRecord>& records, InterfaceRtcApi& target, ReplaySpeed speed) {
+    constexpr UINT BUSY_MASK = Rtc6Constants::Status::BUSY1 | Rtc6Constants::Status::BUSY2;
+    ReplayStats stats;
+    if (records.empty()) {
+        return stats;
+    }
+
+    const int64_t startNs = nowNs();
+    const int64_t firstRecordNs = records.front().timestampNs;
+    for (const auto& r : records) {
+        if (speed == ReplaySpeed::Original) {
+            const int64_t dueNs = startNs + (r.timestampNs - firstRecordNs);
+            const int64_t aheadNs = dueNs - nowNs();
+            if (aheadNs > REPLAY_SPIN_NS) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(aheadNs - REPLAY_SPIN_NS));
+            }
+            while (nowNs() < dueNs) {}
+        }
+
+        switch (r.call) {
+        case ApiCall::AutoChange:         target.api_auto_change(); break;
+        case ApiCall::SetStartList:       target.api_set_start_list(r.listNo); break;
+        case ApiCall::SetEndOfList:       target.api_set_end_of_list(); break;
+        case ApiCall::ExecuteList:        target.api_execute_list(r.listNo); break;
+        case ApiCall::ReadStatus: {
+            const UINT recordedBusy = asUint(r.args[0]) & BUSY_MASK;
+            while ((target.api_read_status() & BUSY_MASK & ~recordedBusy) != 0) {
+                ++stats.extraStatusPolls;
+            }
+            break;
+        }
+        case ApiCall::GetListSpace:       target.api_get_list_space(); break;
+        case ApiCall::JumpAbs:            target.api_jump_abs(r.args[0], r.args[1]); break;
+        case ApiCall::MarkAbs:            target.api_mark_abs(r.args[0], r.args[1]); break;
+        case ApiCall::JumpAbs3D:          target.api_jump_abs_3d(r.args[0], r.args[1], r.args[2]); break;
+        case ApiCall::MarkAbs3D:          target.api_mark_abs_3d(r.args[0], r.args[1], r.args[2]); break;
+        case ApiCall::LaserOnList:        target.api_laser_on_list(asUint(r.args[0])); break;
+        case ApiCall::SetDefocusList:     target.api_set_defocus_list(r.args[0]); break;
+        case ApiCall::SetMarkSpeed:       target.api_set_mark_speed(r.value); break;
+        case ApiCall::SetLaserPower:      target.api_set_laser_power(asUint(r.args[0]), asUint(r.args[1])); break;
+        case ApiCall::SetJumpSpeed:       target.api_set_jump_speed(r.value); break;
+        case ApiCall::SetScannerDelays:   target.api_set_scanner_delays(asUint(r.args[0]), asUint(r.args[1]), asUint(r.args[2])); break;
+        case ApiCall::SetLaserDelays:     target.api_set_laser_delays(r.args[0], asUint(r.args[1])); break;
+        case ApiCall::SetSkyWritingMode:  target.api_set_sky_writing_mode(asUint(r.args[0])); break;
+        case ApiCall::SetSkyWritingPara:  target.api_set_sky_writing_para(r.value, r.args[0], asUint(r.args[1]), asUint(r.args[2])); break;
+        case ApiCall::SetSkyWritingLimit: target.api_set_sky_writing_limit(r.value); break;
+        case ApiCall::SetWobbelMode:      target.api_set_wobbel_mode(asUint(r.args[0]), asUint(r.args[1]), r.value, r.args[2]); break;
+        case ApiCall::SetJumpMode:        target.api_set_jump_mode(r.args[0]); break;
+        case ApiCall::ListRepeat:         target.api_list_repeat(); break;
+        case ApiCall::ListUntil:          target.api_list_until(asUint(r.args[0])); break;
+        case ApiCall::JumpRel:            target.api_jump_rel(r.args[0], r.args[1]); break;
+        case ApiCall::MarkRel:            target.api_mark_rel(r.args[0], r.args[1]); break;
+        case ApiCall::LoadSub:            target.api_load_sub(asUint(r.args[0])); break;
+        case ApiCall::ListReturn:         target.api_list_return(); break;
+        case ApiCall::SubCall:            target.api_sub_call(asUint(r.args[0])); break;
+        case ApiCall::LoadList:           target.api_load_list(r.listNo, asUint(r.args[0])); break;
+        case ApiCall::StopExecution:      target.api_stop_execution(); break;
+        case ApiCall::GetOutPointer: {
+            UINT listNo = 0;
+            UINT pos = 0;
+            target.api_get_out_pointer(listNo, pos);
+            break;
+        }
+        case ApiCall::GetInputPointer:    target.api_get_input_pointer(); break;
+        case ApiCall::Count:              break;
+        }
+        ++stats.calls;
+    }
+    stats.elapsedUs = static_cast<double>(nowNs() - startNs) / 1000.0;
+    return stats;
+}
\ No newline at end of file
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "InterfaceRtcApi.h"
+#include "LockFreeRingBuffer.h"
+#include <atomic>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief The InterfaceRtcApi functions, as stored in a trace.
+ *
+ * Stored as one byte; append new calls at the end so older traces still read correctly.
+ */
+enum class ApiCall : uint8_t {
+    AutoChange,
+    SetStartList,
+    SetEndOfList,
+    ExecuteList,
+    ReadStatus,
+    GetListSpace,
+    JumpAbs,
+    MarkAbs,
+    JumpAbs3D,
+    MarkAbs3D,
+    LaserOnList,
+    SetDefocusList,
+    SetMarkSpeed,
+    SetLaserPower,
+    SetJumpSpeed,
+    SetScannerDelays,
+    SetLaserDelays,
+    SetSkyWritingMode,
+    SetSkyWritingPara,
+    SetSkyWritingLimit,
+    SetWobbelMode,
+    SetJumpMode,
+    ListRepeat,
+    ListUntil,
+    JumpRel,
+    MarkRel,
+    LoadSub,
+    ListReturn,
+    SubCall,
+    LoadList,
+    StopExecution,
+    GetOutPointer,
+    GetInputPointer,
+    Count
+};
+
+/**
+ * @brief One InterfaceRtcApi call in a trace. 32 bytes, written as-is.
+ */
+struct ApiTraceRecord {
+    int64_t timestampNs = 0;    // Since the recorder was created.
+    ApiCall call = ApiCall::AutoChange;
+    uint8_t listNo = 0;         // List being loaded, or the list argument; 0 if none.
+    uint16_t reserved = 0;
+    INT args[3] = { 0, 0, 0 };  // Integer arguments in call order. For read_status,
+                                // get_list_space, get_out_pointer and get_input_pointer, the
+                                // value the board returned (get_out_pointer: the position;
+                                // its list is listNo).
+    double value = 0.0;         // The floating-point argument, if the call has one.
+};
+static_assert(sizeof(ApiTraceRecord) == 32, "ApiTraceRecord is a file format");
+
+/**
+ * @brief File header of a trace. Records follow it directly, in host byte order.
+ */
+struct ApiTraceHeader {
+    static constexpr uint32_t VERSION = 1;
+
+    char magic[8] = { 'R', 'T', 'C', '6', 'T', 'R', 'C', '\0' };
+    uint32_t version = VERSION;
+    uint32_t recordSize = sizeof(ApiTraceRecord);
+};
+
+/**
+ * @brief An InterfaceRtcApi decorator that forwards every call to another InterfaceRtcApi
+ *        and appends it to a binary trace.
+ *
+ * A call costs a timestamp and a push of a fixed-size record into a lock-free ring buffer;
+ * a background thread writes the records in batches. Unlike the Logger, the recorder never
+ * drops a record, because a trace with gaps cannot be replayed: if the buffer is full, the
+ * caller waits for the writer and the wait is counted.
+ */
+class RecordingRtcApi : public InterfaceRtcApi {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 65536;
+
+    /**
+     * @param target The API the calls are forwarded to.
+     * @param out Binary stream the trace is written to. Must outlive the recorder.
+     * @param capacity Records buffered between the caller and the writer thread.
+     */
+    RecordingRtcApi(InterfaceRtcApi& target, std::ostream& out, size_t capacity = DEFAULT_CAPACITY);
+    ~RecordingRtcApi();
+
+    RecordingRtcApi(const RecordingRtcApi&) = delete;
+    RecordingRtcApi& operator=(const RecordingRtcApi&) = delete;
+
+    void api_auto_change() override;
+    void api_set_start_list(UINT listNo) override;
+    void api_set_end_of_list() override;
+    void api_execute_list(UINT listNo) override;
+    UINT api_read_status() override;
+    UINT api_get_list_space() override;
+    void api_jump_abs(INT x, INT y) override;
+    void api_mark_abs(INT x, INT y) override;
+    void api_jump_abs_3d(INT x, INT y, INT z) override;
+    void api_mark_abs_3d(INT x, INT y, INT z) override;
+    void api_laser_on_list(UINT period) override;
+    void api_set_defocus_list(INT offset) override;
+    void api_set_mark_speed(double speed) override;
+    void api_set_laser_power(UINT port, UINT power) override;
+    void api_set_jump_speed(double speed) override;
+    void api_set_scanner_delays(UINT jump, UINT mark, UINT polygon) override;
+    void api_set_laser_delays(INT laserOnDelay, UINT laserOffDelay) override;
+    void api_set_sky_writing_mode(UINT mode) override;
+    void api_set_sky_writing_para(double timelag, INT laserOnShift, UINT nPrev, UINT nPost) override;
+    void api_set_sky_writing_limit(double cosAngle) override;
+    void api_set_wobbel_mode(UINT transversal, UINT longitudinal, double freq, INT mode) override;
+    void api_set_jump_mode(INT flag) override;
+    void api_list_repeat() override;
+    void api_list_until(UINT number) override;
+    void api_jump_rel(INT dx, INT dy) override;
+    void api_mark_rel(INT dx, INT dy) override;
+    void api_load_sub(UINT index) override;
+    void api_list_return() override;
+    void api_sub_call(UINT index) override;
+    void api_load_list(UINT listNo, UINT pos) override;
+    void api_stop_execution() override;
+    void api_get_out_pointer(UINT& listNo, UINT& pos) override;
+    UINT api_get_input_pointer() override;
+
+    /**
+     * @brief Blocks until every call recorded before this one has been written to the stream.
+     */
+    void flush();
+
+    // Calls that had to wait because the ring buffer was full.
+    uint64_t getStallCount() const { return m_stalls.load(std::memory_order_relaxed); }
+
+private:
+    void record(ApiCall call, uint8_t listNo, INT a = 0, INT b = 0, INT c = 0, double value = 0.0);
+    void writerLoop();
+    bool drainBatch();
+
+    InterfaceRtcApi& m_target;
+    std::ostream& m_out;
+    uint8_t m_loadingList = 0;
+    LockFreeRingBuffer<ApiTraceRecord> m_buffer;
+    std::vector<ApiTraceRecord> m_batch;    // Writer thread only.
+    std::atomic<uint64_t> m_stalls{ 0 };
+    std::atomic<size_t> m_written{ 0 };
+    std::atomic<bool> m_stopping{ false };
+    int64_t m_startNs;
+    std::thread m_thread;
+};
+
+/**
+ * @brief Reads a whole trace written by RecordingRtcApi.
+ * @throws FileParseError if the header is missing or from another version, or the
+ *         trace ends inside a record.
+ */
+std::vector<ApiTraceRecord> readApiTrace(std::istream& in);
+
+enum class ReplaySpeed {
+    Original,   // Each call is issued at its recorded offset from the first one.
+    Maximum     // Calls are issued back to back.
+};
+
+struct ReplayStats {
+    uint64_t calls = 0;
+    uint64_t extraStatusPolls = 0;  // read_status calls added while waiting for the target.
+    double elapsedUs = 0.0;
+};
+
+/**
+ * @brief Issues the recorded calls on a target InterfaceRtcApi, in order.
+ *
+ * The host only loaded or started a list after read_status showed the board was ready, so
+ * a recorded read_status is repeated on the target until the target is no busier than the
+ * recording: no BUSY bit that was clear in the recording is still set. A target that is
+ * faster than the recorded board is never held back.
+ */
+ReplayStats replayApiTrace(const std::vector<ApiTraceRecord>& records, InterfaceRtcApi& target, ReplaySpeed speed);
\ No newline at end of file
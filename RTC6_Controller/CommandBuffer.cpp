@@ -0,0 +1,152 @@
+#include "CommandBuffer.h"
+
+void CommandBuffer::addJumpAbsolute(INT x, INT y) {
+    m_commands.push_back({ ListCommand::Type::Jump, x, y });
+}
+
+void CommandBuffer::addMarkAbsolute(INT x, INT y) {
+    m_commands.push_back({ ListCommand::Type::Mark, x, y });
+}
+
+void CommandBuffer::addJumpAbsolute3D(INT x, INT y, INT z) {
+    m_commands.push_back({ ListCommand::Type::Jump3D, x, y, z });
+}
+
+void CommandBuffer::addMarkAbsolute3D(INT x, INT y, INT z) {
+    m_commands.push_back({ ListCommand::Type::Mark3D, x, y, z });
+}
+
+void CommandBuffer::addLaserOn(UINT period_10us) {
+    m_commands.push_back({ ListCommand::Type::LaserOn, static_cast<INT>(period_10us) });
+}
+
+void CommandBuffer::addSetFocusOffset(INT offset_bits) {
+    m_commands.push_back({ ListCommand::Type::SetFocusOffset, offset_bits });
+}
+
+void CommandBuffer::addSetMarkSpeed(double speed_mm_s) {
+    m_commands.push_back({ ListCommand::Type::SetMarkSpeed, 0, 0, 0, speed_mm_s });
+}
+
+void CommandBuffer::addSetLaserPower(UINT port, UINT power) {
+    m_commands.push_back({ ListCommand::Type::SetLaserPower, static_cast<INT>(port), static_cast<INT>(power) });
+}
+
+void CommandBuffer::addSetJumpSpeed(double speed_mm_s) {
+    m_commands.push_back({ ListCommand::Type::SetJumpSpeed, 0, 0, 0, speed_mm_s });
+}
+
+void CommandBuffer::addSetScannerDelays(UINT jump_10us, UINT mark_10us, UINT polygon_10us) {
+    m_commands.push_back({ ListCommand::Type::SetScannerDelays,
+        static_cast<INT>(jump_10us), static_cast<INT>(mark_10us), static_cast<INT>(polygon_10us) });
+}
+
+void CommandBuffer::addSetLaserDelays(INT laserOn_64thUs, UINT laserOff_64thUs) {
+    m_commands.push_back({ ListCommand::Type::SetLaserDelays, laserOn_64thUs, static_cast<INT>(laserOff_64thUs) });
+}
+
+void CommandBuffer::addSetSkyWritingMode(UINT mode) {
+    m_commands.push_back({ ListCommand::Type::SetSkyWritingMode, static_cast<INT>(mode) });
+}
+
+void CommandBuffer::addSetSkyWritingParams(double timelagUs, INT laserOnShift_64thUs, UINT nPrev_10us, UINT nPost_10us) {
+    m_commands.push_back({ ListCommand::Type::SetSkyWritingParams,
+        laserOnShift_64thUs, static_cast<INT>(nPrev_10us), static_cast<INT>(nPost_10us), timelagUs });
+}
+
+void CommandBuffer::addSetSkyWritingLimit(double cosAngle) {
+    m_commands.push_back({ ListCommand::Type::SetSkyWritingLimit, 0, 0, 0, cosAngle });
+}
+
+void CommandBuffer::addSetWobbleMode(UINT transversal_bits, UINT longitudinal_bits, double freqHz, INT mode) {
+    m_commands.push_back({ ListCommand::Type::SetWobbleMode,
+        static_cast<INT>(transversal_bits), static_cast<INT>(longitudinal_bits), mode, freqHz });
+}
+
+void CommandBuffer::addListRepeat() {
+    m_commands.push_back({ ListCommand::Type::ListRepeat });
+}
+
+void CommandBuffer::addListUntil(UINT passes) {
+    m_commands.push_back({ ListCommand::Type::ListUntil, static_cast<INT>(passes) });
+}
+
+void CommandBuffer::beginShape() {
+    m_commands.push_back({ ListCommand::Type::ShapeBegin });
+}
+
+void CommandBuffer::endShape() {
+    m_commands.push_back({ ListCommand::Type::ShapeEnd });
+}
+
+void CommandBuffer::replay(const std::vector<ListCommand>& commands, InterfaceListHandler& target) {
+    for (const auto& cmd : commands) {
+        switch (cmd.type) {
+        case ListCommand::Type::Jump:
+            target.addJumpAbsolute(cmd.x, cmd.y);
+            break;
+        case ListCommand::Type::Mark:
+            target.addMarkAbsolute(cmd.x, cmd.y);
+            break;
+        case ListCommand::Type::Jump3D:
+            target.addJumpAbsolute3D(cmd.x, cmd.y, cmd.z);
+            break;
+        case ListCommand::Type::Mark3D:
+            target.addMarkAbsolute3D(cmd.x, cmd.y, cmd.z);
+            break;
+        case ListCommand::Type::LaserOn:
+            target.addLaserOn(static_cast<UINT>(cmd.x));
+            break;
+        case ListCommand::Type::SetFocusOffset:
+            target.addSetFocusOffset(cmd.x);
+            break;
+        case ListCommand::Type::SetMarkSpeed:
+            target.addSetMarkSpeed(cmd.value);
+            break;
+        case ListCommand::Type::SetLaserPower:
+            target.addSetLaserPower(static_cast<UINT>(cmd.x), static_cast<UINT>(cmd.y));
+            break;
+        case ListCommand::Type::SetJumpSpeed:
+            target.addSetJumpSpeed(cmd.value);
+            break;
+        case ListCommand::Type::SetScannerDelays:
+            target.addSetScannerDelays(static_cast<UINT>(cmd.x), static_cast<UINT>(cmd.y), static_cast<UINT>(cmd.z));
+            break;
+        case ListCommand::Type::SetLaserDelays:
+            target.addSetLaserDelays(cmd.x, static_cast<UINT>(cmd.y));
+            break;
+        case ListCommand::Type::SetSkyWritingMode:
+            target.addSetSkyWritingMode(static_cast<UINT>(cmd.x));
+            break;
+        case ListCommand::Type::SetSkyWritingParams:
+            target.addSetSkyWritingParams(cmd.value, cmd.x, static_cast<UINT>(cmd.y), static_cast<UINT>(cmd.z));
+            break;
+        case ListCommand::Type::SetSkyWritingLimit:
+            target.addSetSkyWritingLimit(cmd.value);
+            break;
+        case ListCommand::Type::SetWobbleMode:
+            target.addSetWobbleMode(static_cast<UINT>(cmd.x), static_cast<UINT>(cmd.y), cmd.value, cmd.z);
+            break;
+        case ListCommand::Type::SetJumpMode:
+            // Chosen by the ListHandler from the jump lengths, so it is never recorded here.
+            break;
+        case ListCommand::Type::ListRepeat:
+            target.addListRepeat();
+            break;
+        case ListCommand::Type::ListUntil:
+            target.addListUntil(static_cast<UINT>(cmd.x));
+            break;
+        case ListCommand::Type::ShapeBegin:
+            target.beginShape();
+            break;
+        case ListCommand::Type::ShapeEnd:
+            target.endShape();
+            break;
+        case ListCommand::Type::JumpRel:
+        case ListCommand::Type::MarkRel:
+        case ListCommand::Type::SubCall:
+            // Produced by the ListHandler when it instances a shape, so never recorded here.
+            break;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "InterfaceListHandler.h"
+#include "RTC6impl.h" // For UINT, INT
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief One recorded list command, as produced by the InterfaceListHandler add* calls.
+ *
+ * The operands are stored generically; which ones are meaningful depends on the type:
+ * - Jump/Mark: x, y.  Jump3D/Mark3D: x, y, z.
+ * - LaserOn: x = period in 10 us.  SetFocusOffset: x = offset bits.
+ * - SetLaserPower: x = port, y = power.  SetMarkSpeed/SetJumpSpeed: value = speed in mm/s.
+ * - SetScannerDelays: x = jump, y = mark, z = polygon delay in 10 us.
+ * - SetLaserDelays: x = laser-on, y = laser-off delay in 1/64 us.
+ * - SetSkyWritingMode: x = mode.  SetSkyWritingLimit: value = cosine of the limit angle.
+ * - SetSkyWritingParams: value = time lag in us, x = laser-on shift in 1/64 us,
+ *   y = run-in (Nprev) and z = run-out (Npost) in 10 us.
+ * - SetWobbleMode: x = transversal, y = longitudinal amplitude in bits, z = shape, value = frequency in Hz.
+ * - SetJumpMode: x = 1 for jump mode, 0 for normal jumps. Chosen by the ListHandler itself.
+ * - ListRepeat: no operands.  ListUntil: x = passes of the commands since the ListRepeat.
+ * - JumpRel/MarkRel: x, y = offset from the current position. SubCall: x = subroutine index.
+ *   Written by the ListHandler for instanced shapes, never recorded here.
+ * - ShapeBegin/ShapeEnd: no operands. Bracket the moves of one block's geometry; they are
+ *   consumed by the ListHandler and never reach the board.
+ */
+struct ListCommand {
+    enum class Type : uint8_t {
+        Jump,
+        Mark,
+        Jump3D,
+        Mark3D,
+        LaserOn,
+        SetFocusOffset,
+        SetMarkSpeed,
+        SetLaserPower,
+        SetJumpSpeed,
+        SetScannerDelays,
+        SetLaserDelays,
+        SetSkyWritingMode,
+        SetSkyWritingParams,
+        SetSkyWritingLimit,
+        SetWobbleMode,
+        SetJumpMode,
+        ListRepeat,
+        ListUntil,
+        JumpRel,
+        MarkRel,
+        SubCall,
+        ShapeBegin,
+        ShapeEnd
+    };
+
+    Type type = Type::Jump;
+    INT x = 0;
+    INT y = 0;
+    INT z = 0;
+    double value = 0.0;
+
+    bool operator==(const ListCommand& other) const = default;
+};
+
+/**
+ * @brief An InterfaceListHandler that records list commands instead of sending them to a board.
+ *
+ * This is the intermediate representation between compiling geometry and emitting it:
+ * a GeometryHandler can be pointed at a CommandBuffer on any thread, and the recorded
+ * commands are later replayed into the real ListHandler with replay().
+ *
+ * Only the list command methods are meaningful. The workflow and status methods
+ * exist to satisfy the interface and do not touch any hardware.
+ */
+class CommandBuffer : public InterfaceListHandler {
+public:
+    CommandBuffer() = default;
+
+    // Workflow Management (no-ops for a recording)
+    bool setupAutoChangeMode() override { return true; }
+    void reArmAutoChange() override {}
+    bool beginListPreparation() override { m_commands.clear(); return true; }
+    void endListPreparation() override {}
+    bool executeCurrentListAndCycle() override { return false; }
+    void retainLayerForRepeat(bool) override {}
+    bool repeatLastLayer() override { return false; }
+
+    // Status
+    bool isListBusy(UINT) const override { return false; }
+    bool waitForListCompletion(UINT) override { return false; }
+    LatencyHistogram getHandoverLatency() const override { return LatencyHistogram(); }
+    UINT getCurrentFillListId() const override { return 0; }
+    UINT getListCommandCount() const override { return static_cast<UINT>(m_commands.size()); }
+    ScanTimeEstimate getListTimeEstimate() const override { return ScanTimeEstimator::estimate(m_commands); }
+    UINT getLastExecutedListId() const override { return 0; }
+
+    // List Command Abstractions
+    void addJumpAbsolute(INT x, INT y) override;
+    void addMarkAbsolute(INT x, INT y) override;
+    void addJumpAbsolute3D(INT x, INT y, INT z) override;
+    void addMarkAbsolute3D(INT x, INT y, INT z) override;
+    void addLaserOn(UINT period_10us) override;
+    void addSetFocusOffset(INT offset_bits) override;
+    void addSetMarkSpeed(double speed_mm_s) override;
+    void addSetLaserPower(UINT port, UINT power) override;
+    void addSetJumpSpeed(double speed_mm_s) override;
+    void addSetScannerDelays(UINT jump_10us, UINT mark_10us, UINT polygon_10us) override;
+    void addSetLaserDelays(INT laserOn_64thUs, UINT laserOff_64thUs) override;
+    void addSetSkyWritingMode(UINT mode) override;
+    void addSetSkyWritingParams(double timelagUs, INT laserOnShift_64thUs, UINT nPrev_10us, UINT nPost_10us) override;
+    void addSetSkyWritingLimit(double cosAngle) override;
+    void addSetWobbleMode(UINT transversal_bits, UINT longitudinal_bits, double freqHz, INT mode) override;
+    void addListRepeat() override;
+    void addListUntil(UINT passes) override;
+    void beginShape() override;
+    void endShape() override;
+
+    std::vector<ListCommand>& commands() { return m_commands; }
+    const std::vector<ListCommand>& commands() const { return m_commands; }
+    void clear() { m_commands.clear(); }
+
+    /**
+     * @brief Re-issues recorded commands, in order, through another list handler.
+     * @param commands The recorded commands.
+     * @param target The handler that receives the add* calls, usually the real ListHandler.
+     */
+    static void replay(const std::vector<ListCommand>& commands, InterfaceListHandler& target);
+
+private:
+    std::vector<ListCommand> m_commands;
+};
\ No newline at end of file
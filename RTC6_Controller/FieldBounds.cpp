@@ -0,0 +1,170 @@
+#include "FieldBounds.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define FIELD_BOUNDS_USE_SSE2 1
+#endif
+
+#ifdef FIELD_BOUNDS_USE_SSE2
+namespace {
+    // SSE2 has no packed 32-bit integer min/max, so select with a compare mask.
+    inline __m128i min_epi32(__m128i a, __m128i b) {
+        const __m128i aLess = _mm_cmplt_epi32(a, b);
+        return _mm_or_si128(_mm_and_si128(aLess, a), _mm_andnot_si128(aLess, b));
+    }
+
+    inline __m128i max_epi32(__m128i a, __m128i b) {
+        const __m128i aGreater = _mm_cmpgt_epi32(a, b);
+        return _mm_or_si128(_mm_and_si128(aGreater, a), _mm_andnot_si128(aGreater, b));
+    }
+}
+#endif
+
+BitBounds FieldBounds::computeBitBounds(const INT* values, size_t pointCount, size_t stride) {
+    BitBounds b{ std::numeric_limits<INT>::max(), std::numeric_limits<INT>::max(),
+                 std::numeric_limits<INT>::min(), std::numeric_limits<INT>::min() };
+    size_t i = 0;
+
+    if (stride == 3) {
+        b.zMin = std::numeric_limits<INT>::max();
+        b.zMax = std::numeric_limits<INT>::min();
+        for (size_t p = 0; p < pointCount; ++p) {
+            b.zMin = std::min(b.zMin, values[3 * p + 2]);
+            b.zMax = std::max(b.zMax, values[3 * p + 2]);
+        }
+    }
+
+#ifdef FIELD_BOUNDS_USE_SSE2
+    if (stride == 2 && pointCount >= 2) {
+        // Lanes hold x0 y0 x1 y1, so lanes 0/2 track x and lanes 1/3 track y.
+        __m128i vMin = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+        __m128i vMax = vMin;
+        for (i = 2; i + 2 <= pointCount; i += 2) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + 2 * i));
+            vMin = min_epi32(vMin, v);
+            vMax = max_epi32(vMax, v);
+        }
+        alignas(16) INT mins[4];
+        alignas(16) INT maxs[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(mins), vMin);
+        _mm_store_si128(reinterpret_cast<__m128i*>(maxs), vMax);
+        b.xMin = std::min(mins[0], mins[2]);
+        b.yMin = std::min(mins[1], mins[3]);
+        b.xMax = std::max(maxs[0], maxs[2]);
+        b.yMax = std::max(maxs[1], maxs[3]);
+    }
+#endif
+
+    for (; i < pointCount; ++i) {
+        const INT x = values[stride * i];
+        const INT y = values[stride * i + 1];
+        b.xMin = std::min(b.xMin, x);
+        b.yMin = std::min(b.yMin, y);
+        b.xMax = std::max(b.xMax, x);
+        b.yMax = std::max(b.yMax, y);
+    }
+    return b;
+}
+
+bool FieldBounds::isInsideField(const BitBounds& bounds) {
+    if (bounds.isEmpty()) return true;
+    return bounds.xMin >= FIELD_MIN_BITS && bounds.xMax <= FIELD_MAX_BITS
+        && bounds.yMin >= FIELD_MIN_BITS && bounds.yMax <= FIELD_MAX_BITS
+        && bounds.zMin >= FIELD_MIN_BITS && bounds.zMax <= FIELD_MAX_BITS;
+}
+
+size_t FieldBounds::countOutsideField(const INT* values, size_t pointCount, size_t stride) {
+    size_t outside = 0;
+    for (size_t i = 0; i < pointCount; ++i) {
+        if (!containsPoint(values + stride * i, stride)) {
+            ++outside;
+        }
+    }
+    return outside;
+}
+
+bool FieldBounds::containsPoint(const INT* point, size_t dims) {
+    for (size_t axis = 0; axis < dims; ++axis) {
+        if (point[axis] < FIELD_MIN_BITS || point[axis] > FIELD_MAX_BITS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Narrows the parameter range [t0, t1] of from + t * (to - from) axis by axis to the
+// part where every coordinate stays inside the field.
+bool FieldBounds::clipSegmentToField(const INT* from, const INT* to, size_t dims, ClippedSegment& out) {
+    double t0 = 0.0;
+    double t1 = 1.0;
+    for (size_t axis = 0; axis < dims; ++axis) {
+        const double start = from[axis];
+        const double delta = static_cast<double>(to[axis]) - start;
+        if (delta == 0.0) {
+            if (start < FIELD_MIN_BITS || start > FIELD_MAX_BITS) {
+                return false;
+            }
+            continue;
+        }
+        double tLow = (FIELD_MIN_BITS - start) / delta;
+        double tHigh = (FIELD_MAX_BITS - start) / delta;
+        if (tLow > tHigh) {
+            std::swap(tLow, tHigh);
+        }
+        t0 = std::max(t0, tLow);
+        t1 = std::min(t1, tHigh);
+        if (t0 > t1) {
+            return false;
+        }
+    }
+
+    for (size_t axis = 0; axis < dims; ++axis) {
+        const double start = from[axis];
+        const double delta = static_cast<double>(to[axis]) - start;
+        // The clamp only absorbs rounding at the field edge.
+        out.start[axis] = std::clamp(static_cast<INT>(std::lround(start + t0 * delta)), FIELD_MIN_BITS, FIELD_MAX_BITS);
+        out.end[axis] = std::clamp(static_cast<INT>(std::lround(start + t1 * delta)), FIELD_MIN_BITS, FIELD_MAX_BITS);
+    }
+    out.startClipped = t0 > 0.0;
+    out.endClipped = t1 < 1.0;
+    return true;
+}
+
+MmBounds FieldBounds::computeMmBounds(const float* values, size_t pointCount, size_t stride) {
+    MmBounds b{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+    size_t i = 0;
+
+#ifdef FIELD_BOUNDS_USE_SSE2
+    if (stride == 2 && pointCount >= 2) {
+        __m128 vMin = _mm_loadu_ps(values);
+        __m128 vMax = vMin;
+        for (i = 2; i + 2 <= pointCount; i += 2) {
+            const __m128 v = _mm_loadu_ps(values + 2 * i);
+            vMin = _mm_min_ps(vMin, v);
+            vMax = _mm_max_ps(vMax, v);
+        }
+        alignas(16) float mins[4];
+        alignas(16) float maxs[4];
+        _mm_store_ps(mins, vMin);
+        _mm_store_ps(maxs, vMax);
+        b.xMin = std::min(mins[0], mins[2]);
+        b.yMin = std::min(mins[1], mins[3]);
+        b.xMax = std::max(maxs[0], maxs[2]);
+        b.yMax = std::max(maxs[1], maxs[3]);
+    }
+#endif
+
+    for (; i < pointCount; ++i) {
+        const float x = values[stride * i];
+        const float y = values[stride * i + 1];
+        b.xMin = std::min(b.xMin, x);
+        b.yMin = std::min(b.yMin, y);
+        b.xMax = std::max(b.xMax, x);
+        b.yMax = std::max(b.yMax, y);
+    }
+    return b;
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "RTC6impl.h" // For INT
+#include <cstddef>
+
+/**
+ * @brief Axis-aligned bounding box of converted coordinates, in RTC6 bits.
+ *
+ * An empty box (no points) has xMin > xMax. z stays 0 for (x, y) buffers.
+ */
+struct BitBounds {
+    INT xMin;
+    INT yMin;
+    INT xMax;
+    INT yMax;
+    INT zMin = 0;
+    INT zMax = 0;
+
+    bool isEmpty() const { return xMin > xMax; }
+};
+
+/**
+ * @brief Axis-aligned bounding box of part coordinates, in millimeters.
+ */
+struct MmBounds {
+    float xMin;
+    float yMin;
+    float xMax;
+    float yMax;
+
+    bool isEmpty() const { return !(xMin <= xMax); }
+};
+
+/**
+ * @brief The part of a segment that lies inside the scan field.
+ *
+ * Only the first `dims` coordinates passed to FieldBounds::clipSegmentToField() are set.
+ */
+struct ClippedSegment {
+    INT start[3];
+    INT end[3];
+    bool startClipped;  // The segment enters the field at `start` instead of starting there.
+    bool endClipped;    // The segment leaves the field at `end` instead of ending there.
+};
+
+/**
+ * @brief Bounding-box and scan-field checks for coordinate buffers.
+ *
+ * The min/max reductions run with SSE2 on x64 (two interleaved x/y points per
+ * iteration) and fall back to scalar loops elsewhere or for x/y/z buffers. The z axis
+ * of x/y/z buffers has the same signed 20-bit range as x and y. They run
+ * over buffers that were just written by the coordinate conversion, so they only add
+ * one pass over data that is already in cache.
+ */
+class FieldBounds {
+public:
+    // The RTC6 scan field is a signed 20-bit range in each axis.
+    static constexpr INT FIELD_MIN_BITS = -(1 << 19);
+    static constexpr INT FIELD_MAX_BITS = (1 << 19) - 1;
+
+    /**
+     * @brief Computes the bounding box of interleaved integer points.
+     * @param values Interleaved points with `stride` values each; x and y come first.
+     * @param pointCount The number of points (not values).
+     * @param stride 2 for (x, y) buffers, 3 for (x, y, z) buffers.
+     */
+    static BitBounds computeBitBounds(const INT* values, size_t pointCount, size_t stride);
+
+    // True if the whole box lies inside the RTC6 scan field.
+    static bool isInsideField(const BitBounds& bounds);
+
+    // The number of points with a coordinate outside the scan field.
+    static size_t countOutsideField(const INT* values, size_t pointCount, size_t stride);
+
+    // True if the first `dims` coordinates of the point lie inside the scan field.
+    static bool containsPoint(const INT* point, size_t dims);
+
+    /**
+     * @brief Cuts a segment to the scan field (Liang-Barsky).
+     * @param from The segment's start point, `dims` coordinates.
+     * @param to The segment's end point, `dims` coordinates.
+     * @param dims 2 to clip x/y only, 3 to clip z as well.
+     * @param out The part inside the field, rounded to whole bits.
+     * @return False if no part of the segment lies inside the field.
+     */
+    static bool clipSegmentToField(const INT* from, const INT* to, size_t dims, ClippedSegment& out);
+
+    /**
+     * @brief Computes the x/y bounding box of interleaved float part coordinates.
+     */
+    static MmBounds computeMmBounds(const float* values, size_t pointCount, size_t stride);
+};
\ No newline at end of file
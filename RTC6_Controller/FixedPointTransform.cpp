@@ -0,0 +1,126 @@
+#include "FixedPointTransform.h"
+#include "Rtc6Exception.h"
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+// MSVC compiles SSE4.1 intrinsics for any x64 target; the controller PCs all support it.
+#if defined(__SSE4_1__) || (defined(_M_X64) && !defined(_M_ARM64EC))
+#include <smmintrin.h>
+#define FIXED_POINT_TRANSFORM_USE_SSE41 1
+#endif
+
+namespace {
+    constexpr double INPUT_SCALE = static_cast<double>(int64_t(1) << FixedPointTransform::INPUT_FRACTION_BITS);
+    constexpr double COEFF_SCALE = static_cast<double>(int64_t(1) << FixedPointTransform::COEFF_FRACTION_BITS);
+    constexpr double PRODUCT_SCALE = static_cast<double>(int64_t(1) << FixedPointTransform::PRODUCT_SHIFT);
+}
+
+FixedPointTransform FixedPointTransform::fromAffine(const AffineTransform& transform) {
+    FixedPointTransform f;
+    f.a = std::llround(transform.a * COEFF_SCALE);
+    f.b = std::llround(transform.b * COEFF_SCALE);
+    f.c = std::llround(transform.c * COEFF_SCALE);
+    f.d = std::llround(transform.d * COEFF_SCALE);
+    f.tx = std::llround(transform.tx * PRODUCT_SCALE);
+    f.ty = std::llround(transform.ty * PRODUCT_SCALE);
+    return f;
+}
+
+// A clamped coordinate would be scanned at a wrong but plausible position, which no
+// out-of-field policy can tell from a real one, so it is rejected instead.
+int64_t FixedPointTransform::toFixedInput(float valueMm) {
+    const double v = valueMm;
+    // Written so that NaN fails the check too.
+    if (!(std::fabs(v) <= INPUT_LIMIT_MM)) {
+        std::stringstream ss;
+        ss << "Coordinate " << v << " mm is not a number within +/-" << INPUT_LIMIT_MM << " mm.";
+        throw GeometryError(ss.str());
+    }
+    // Scaling by a power of two is exact, so this only truncates below 1/2^20 mm.
+    return static_cast<int64_t>(v * INPUT_SCALE);
+}
+
+INT FixedPointTransform::roundToBits(int64_t accumulator) {
+    constexpr int64_t half = int64_t(1) << (PRODUCT_SHIFT - 1);
+    if (accumulator >= 0) {
+        return static_cast<INT>((accumulator + half) >> PRODUCT_SHIFT);
+    }
+    return -static_cast<INT>((-accumulator + half) >> PRODUCT_SHIFT);
+}
+
+bool FixedPointTransform::hasInt32Multipliers() const {
+    const auto fits = [](int64_t v) {
+        return v >= std::numeric_limits<int32_t>::min() && v <= std::numeric_limits<int32_t>::max();
+    };
+    return fits(a) && fits(b) && fits(c) && fits(d);
+}
+
+void FixedPointTransform::applyToBits(const float* xy, size_t pointCount, INT* outXY) const {
+    size_t i = 0;
+
+#ifdef FIXED_POINT_TRANSFORM_USE_SSE41
+    // Two points (four floats) per iteration. An input within ±INPUT_LIMIT_MM is at most
+    // 2^30 in Q20, so with 32-bit multipliers _mm_mul_epi32 forms the exact int64 products
+    // and the result is bit-identical to the scalar loop. A point toFixedInput would reject
+    // leaves the loop, so the scalar loop below throws for it.
+    if (hasInt32Multipliers()) {
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const __m128 limit = _mm_set1_ps(static_cast<float>(INPUT_LIMIT_MM));
+        const __m128 inputScale = _mm_set1_ps(static_cast<float>(INPUT_SCALE));
+        const __m128i va = _mm_set1_epi64x(a);
+        const __m128i vb = _mm_set1_epi64x(b);
+        const __m128i vc = _mm_set1_epi64x(c);
+        const __m128i vd = _mm_set1_epi64x(d);
+        const __m128i vtx = _mm_set1_epi64x(tx);
+        const __m128i vty = _mm_set1_epi64x(ty);
+        const __m128i half = _mm_set1_epi64x(int64_t(1) << (PRODUCT_SHIFT - 1));
+
+        // roundToBits on both 64-bit lanes: SSE4.1 has no 64-bit arithmetic shift, so the
+        // magnitude is shifted and the sign put back.
+        const auto round = [half](__m128i acc) {
+            const __m128i sign = _mm_shuffle_epi32(_mm_srai_epi32(acc, 31), _MM_SHUFFLE(3, 3, 1, 1));
+            const __m128i magnitude = _mm_sub_epi64(_mm_xor_si128(acc, sign), sign);
+            const __m128i bits = _mm_srli_epi64(_mm_add_epi64(magnitude, half), PRODUCT_SHIFT);
+            return _mm_sub_epi64(_mm_xor_si128(bits, sign), sign);
+        };
+
+        for (; i + 2 <= pointCount; i += 2) {
+            const __m128 raw = _mm_loadu_ps(xy + 2 * i);                           // x0 y0 x1 y1
+            if (_mm_movemask_ps(_mm_cmple_ps(_mm_and_ps(raw, absMask), limit)) != 0xF) {
+                break; // Also taken for NaN, which fails every comparison.
+            }
+            // Scaling by a power of two is exact, so truncating matches toFixedInput.
+            const __m128i fixed = _mm_cvttps_epi32(_mm_mul_ps(raw, inputScale));
+            const __m128i xs = fixed;                                               // x0 in lane 0, x1 in lane 2
+            const __m128i ys = _mm_srli_epi64(fixed, 32);                           // y0 in lane 0, y1 in lane 2
+
+            const __m128i accX = _mm_add_epi64(_mm_add_epi64(_mm_mul_epi32(va, xs), _mm_mul_epi32(vb, ys)), vtx);
+            const __m128i accY = _mm_add_epi64(_mm_add_epi64(_mm_mul_epi32(vc, xs), _mm_mul_epi32(vd, ys)), vty);
+
+            // The low 32 bits of each 64-bit result are the INT; interleave them as x y x y.
+            const __m128i packed = _mm_blend_epi16(round(accX), _mm_slli_epi64(round(accY), 32), 0xCC);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(outXY + 2 * i), packed);
+        }
+    }
+#endif
+
+    for (; i < pointCount; ++i) {
+        const int64_t x = toFixedInput(xy[2 * i]);
+        const int64_t y = toFixedInput(xy[2 * i + 1]);
+        outXY[2 * i] = roundToBits(a * x + b * y + tx);
+        outXY[2 * i + 1] = roundToBits(c * x + d * y + ty);
+    }
+}
+
+void FixedPointTransform::applyToBits3D(const float* xyz, size_t pointCount, double zScale, INT* outXYZ) const {
+    const int64_t zCoeff = std::llround(zScale * COEFF_SCALE);
+    for (size_t i = 0; i < pointCount; ++i) {
+        const int64_t x = toFixedInput(xyz[3 * i]);
+        const int64_t y = toFixedInput(xyz[3 * i + 1]);
+        const int64_t z = toFixedInput(xyz[3 * i + 2]);
+        outXYZ[3 * i] = roundToBits(a * x + b * y + tx);
+        outXYZ[3 * i + 1] = roundToBits(c * x + d * y + ty);
+        outXYZ[3 * i + 2] = roundToBits(zCoeff * z);
+    }
+}
\ No newline at end of file
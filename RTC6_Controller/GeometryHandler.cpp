@@ -1,16 +1,84 @@
 #include "GeometryHandler.h"
-#include <iostream>
+#include "Logger.h"
 #include <cmath>
+#include <algorithm>
+#include <iterator>
+#include <limits>
 
 #include "MachineConfig.h"
+#include "Rtc6Constants.h"
+#include "Rtc6Exception.h"
+#include <sstream>
 
 GeometryHandler::GeometryHandler(InterfaceListHandler& listHandler)
-	: m_listHandler(listHandler) {
-	std::cout << "[GeometryHandler] Instance created." << std::endl;
+	: m_listHandler(listHandler),
+	m_layerToBits(FixedPointTransform::fromAffine(buildLayerTransform(0.0, 0.0, 0.0))) {
+	Logger::instance().log(LogLevel::Info, LogEvent::GeometryHandlerCreated);
 }
 
 GeometryHandler::~GeometryHandler() = default;
 
+void GeometryHandler::beginWorkPlane(const open_vector_format::WorkPlane& workPlane) {
+	m_layerToBits = FixedPointTransform::fromAffine(
+		buildLayerTransform(workPlane.x_pos_in_mm(), workPlane.y_pos_in_mm(), workPlane.z_rot_in_deg()));
+	m_shortVectorStats = ShortVectorStats{};
+}
+
+/**
+ * @brief Builds the fused transform that takes OVF part coordinates (mm) straight to RTC6 bits.
+ *
+ * The stages are applied in this order:
+ * 1.  Per-axis field scale (MachineConfig::FIELD_SCALE_X/Y).
+ * 2.  Rotation about the origin by the WorkPlane's z_rot_in_deg.
+ * 3.  Translation by the WorkPlane's x_pos_in_mm / y_pos_in_mm.
+ * 4.  The machine calibration matrix (MachineConfig::CALIBRATION_MATRIX).
+ * 5.  The mm-to-bits conversion factor.
+ *
+ * Folding everything into one matrix means the per-point cost is the same as the
+ * plain mm-to-bits conversion, no matter how many stages are active. The result is
+ * composed in double precision and then quantized once by FixedPointTransform.
+ */
+AffineTransform GeometryHandler::buildLayerTransform(double xPosMm, double yPosMm, double zRotDeg) {
+	const double* m = MachineConfig::CALIBRATION_MATRIX;
+	AffineTransform calibration;
+	calibration.a = m[0]; calibration.b = m[1]; calibration.tx = m[2];
+	calibration.c = m[3]; calibration.d = m[4]; calibration.ty = m[5];
+
+	const double factor = MachineConfig::MM_TO_BITS_CONVERSION_FACTOR;
+
+	return AffineTransform::scaling(MachineConfig::FIELD_SCALE_X, MachineConfig::FIELD_SCALE_Y)
+		.then(AffineTransform::rotationDeg(zRotDeg))
+		.then(AffineTransform::translation(xPosMm, yPosMm))
+		.then(calibration)
+		.then(AffineTransform::scaling(factor, factor));
+}
+
+
+/**
+ * @brief Translates a VectorBlock and runs it 1 + repeats times.
+ *
+ * A repeated block is emitted once, wrapped in a list loop (list_repeat/list_until),
+ * so its repeats cost neither list memory nor transfer time.
+ */
+void GeometryHandler::processVectorBlock(
+	const open_vector_format::VectorBlock& block,
+	const open_vector_format::MarkingParams& params)
+{
+	const uint64_t repeats = block.repeats();
+	if (repeats == 0) {
+		emitVectorBlock(block, params);
+		return;
+	}
+	if (repeats >= std::numeric_limits<UINT>::max()) {
+		std::stringstream ss;
+		ss << "Vector block repeats " << repeats << " times, more than a list loop can run.";
+		throw GeometryError(ss.str());
+	}
+
+	m_listHandler.addListRepeat();
+	emitVectorBlock(block, params);
+	m_listHandler.addListUntil(static_cast<UINT>(repeats + 1));
+}
 
 /**
  * @brief Translates a single OVF VectorBlock into a sequence of RTC6 list commands.
@@ -27,17 +95,23 @@ GeometryHandler::~GeometryHandler() = default;
  *     Based on the type, it iterates through the points and calls the appropriate
  *     jump and mark commands on the ListHandler.
  *
+ * All coordinates pass through the fused per-layer transform set up by
+ * beginWorkPlane(), so WorkPlane offsets and rotation are applied on the fly.
+ *
  * Tracks:
  * - Laser speed in mm/s
  * - Focus offset in mm (converted to bits)
  * - Laser power in percentage (converted to DAC value)
+ * - Jump speed, scanner delays and laser delays (see emitTimingParams())
+ * - Sky-writing mode and its parameters (see emitSkyWritingParams())
+ * - Wobble shape, amplitude and frequency (see emitWobbleParams())
  * 
  * @param block The OVF VectorBlock to process, containing the geometry data. Passed
  *              by const reference for high efficiency.
  * @param params The OVF MarkingParams for this block, containing the laser settings.
  *               Passed by const reference.
  */
-void GeometryHandler::processVectorBlock(
+void GeometryHandler::emitVectorBlock(
 	const open_vector_format::VectorBlock& block,
 	const open_vector_format::MarkingParams& params)
 {
@@ -47,6 +121,9 @@ void GeometryHandler::processVectorBlock(
 
 	double powerPercent = (params.laser_power_in_w() / MachineConfig::MAX_LASER_POWER_W) * 100.0;
 	m_listHandler.addSetLaserPower(1, powerToDAC(powerPercent));
+	emitTimingParams(params);
+	emitSkyWritingParams(params);
+	emitWobbleParams(params);
 
 	// 2. Process the geometry based on its type
 	switch (block.vector_data_case()) {
@@ -54,25 +131,131 @@ void GeometryHandler::processVectorBlock(
 		const auto& points = block.line_sequence().points();
 		if (points.size() < 4) return;
 
-		m_listHandler.addJumpAbsolute(mmToBits(points[0]), mmToBits(points[1]));
-		for (int i = 2; i < points.size(); i += 2) {
-			m_listHandler.addMarkAbsolute(mmToBits(points[i]), mmToBits(points[i + 1]));
+		const INT* bits = convertPoints(points);
+		m_listHandler.beginShape();
+		if (m_clipToField) {
+			emitClippedSegments(static_cast<size_t>(points.size()) / 2, 2, false, false);
+		}
+		else {
+			m_listHandler.addJumpAbsolute(bits[0], bits[1]);
+			for (int i = 2; i + 1 < points.size(); i += 2) {
+				m_listHandler.addMarkAbsolute(bits[i], bits[i + 1]);
+			}
 		}
+		m_listHandler.endShape();
 		break;
 	}
 
 	case open_vector_format::VectorBlock::kHatches: {
 		const auto& points = block._hatches().points();
 		if (points.size() < 4) return;
-		for (int i = 0; i < points.size(); i += 4) {
-			m_listHandler.addJumpAbsolute(mmToBits(points[i]), mmToBits(points[i + 1]));
-			m_listHandler.addMarkAbsolute(mmToBits(points[i + 2]), mmToBits(points[i + 3]));
+
+		const INT* bits = convertPoints(points);
+		const size_t hatchCount = filterShortHatches(static_cast<size_t>(points.size()) / 4, block, params);
+		m_listHandler.beginShape();
+		if (m_clipToField) {
+			emitClippedSegments(hatchCount * 2, 2, false, true);
+		}
+		else {
+			for (size_t i = 0; i < hatchCount * 4; i += 4) {
+				m_listHandler.addJumpAbsolute(bits[i], bits[i + 1]);
+				m_listHandler.addMarkAbsolute(bits[i + 2], bits[i + 3]);
+			}
+		}
+		m_listHandler.endShape();
+		break;
+	}
+
+	// 3D blocks go straight to the RTC6 3D list commands, so a z move costs no
+	// extra defocus command. z is converted with the dedicated z bit scale.
+	case open_vector_format::VectorBlock::kLineSequence3D: {
+		const auto& points = block.line_sequence_3d().points();
+		if (points.size() < 6) return;
+
+		const INT* bits = convertPoints3D(points);
+		if (m_clipToField) {
+			emitClippedSegments(static_cast<size_t>(points.size()) / 3, 3, true, false);
+			break;
+		}
+		m_listHandler.addJumpAbsolute3D(bits[0], bits[1], bits[2]);
+		for (int i = 3; i + 2 < points.size(); i += 3) {
+			m_listHandler.addMarkAbsolute3D(bits[i], bits[i + 1], bits[i + 2]);
+		}
+		break;
+	}
+
+	case open_vector_format::VectorBlock::kHatches3D: {
+		const auto& points = block.hatches_3d().points();
+		if (points.size() < 6) return;
+
+		const INT* bits = convertPoints3D(points);
+		if (m_clipToField) {
+			emitClippedSegments(static_cast<size_t>(points.size()) / 6 * 2, 3, true, true);
+			break;
+		}
+		for (int i = 0; i + 5 < points.size(); i += 6) {
+			m_listHandler.addJumpAbsolute3D(bits[i], bits[i + 1], bits[i + 2]);
+			m_listHandler.addMarkAbsolute3D(bits[i + 3], bits[i + 4], bits[i + 5]);
+		}
+		break;
+	}
+
+	// Each point costs exactly one jump plus one laser-on command. Exposure
+	// repetitions are folded into the laser-on period instead of being unrolled.
+	case open_vector_format::VectorBlock::kPointSequence: {
+		const auto& points = block.point_sequence().points();
+		if (points.size() < 2) return;
+
+		const UINT period = pointExposurePeriod(params);
+		const INT* bits = convertPoints(points);
+		for (int i = 0; i + 1 < points.size(); i += 2) {
+			if (m_clipToField && !FieldBounds::containsPoint(bits + i, 2)) {
+				continue;
+			}
+			m_listHandler.addJumpAbsolute(bits[i], bits[i + 1]);
+			if (period > 0) {
+				m_listHandler.addLaserOn(period);
+			}
+		}
+		break;
+	}
+
+	case open_vector_format::VectorBlock::kPointSequence3D: {
+		const auto& points = block.point_sequence_3d().points();
+		if (points.size() < 3) return;
+
+		const UINT period = pointExposurePeriod(params);
+		const INT* bits = convertPoints3D(points);
+		for (int i = 0; i + 2 < points.size(); i += 3) {
+			if (m_clipToField && !FieldBounds::containsPoint(bits + i, 3)) {
+				continue;
+			}
+			m_listHandler.addJumpAbsolute3D(bits[i], bits[i + 1], bits[i + 2]);
+			if (period > 0) {
+				m_listHandler.addLaserOn(period);
+			}
+		}
+		break;
+	}
+
+	case open_vector_format::VectorBlock::kLineSequenceParaAdapt: {
+		INT activePower = static_cast<INT>(powerToDAC(powerPercent));
+		INT activeFocus = mmToBits(params.laser_focus_shift_in_mm());
+		emitParaAdaptSequence(block.line_sequence_para_adapt(), activePower, activeFocus);
+		break;
+	}
+
+	case open_vector_format::VectorBlock::kHatchParaAdapt: {
+		// The active values carry over between hatches, since the board keeps the last one set.
+		INT activePower = static_cast<INT>(powerToDAC(powerPercent));
+		INT activeFocus = mmToBits(params.laser_focus_shift_in_mm());
+		for (const auto& hatch : block._hatchparaadapt().hatchaslinesequence()) {
+			emitParaAdaptSequence(hatch, activePower, activeFocus);
 		}
 		break;
 	}
 
 	// ToDo: Implement other cases as needed
-	// case open_vector_format::VectorBlock::kPointSequence: { ... }
 	// case open_vector_format::VectorBlock::kArcs: { ... }
 
 	default:
@@ -86,6 +269,328 @@ int GeometryHandler::mmToBits(double mm) const {
 	return static_cast<int>(std::round(mm * MachineConfig::MM_TO_BITS_CONVERSION_FACTOR));
 }
 
+const INT* GeometryHandler::convertPoints(const google::protobuf::RepeatedField<float>& points) {
+	const size_t pointCount = static_cast<size_t>(points.size()) / 2;
+	if (m_bitBuffer.size() < pointCount * 2) {
+		m_bitBuffer.resize(pointCount * 2);
+	}
+	m_layerToBits.applyToBits(points.data(), pointCount, m_bitBuffer.data());
+	enforceFieldBounds(pointCount, 2);
+	return m_bitBuffer.data();
+}
+
+const INT* GeometryHandler::convertPoints3D(const google::protobuf::RepeatedField<float>& points, double zScale) {
+	const size_t pointCount = static_cast<size_t>(points.size()) / 3;
+	if (m_bitBuffer.size() < pointCount * 3) {
+		m_bitBuffer.resize(pointCount * 3);
+	}
+	m_layerToBits.applyToBits3D(points.data(), pointCount, zScale, m_bitBuffer.data());
+	enforceFieldBounds(pointCount, 3);
+	return m_bitBuffer.data();
+}
+
+/**
+ * @brief Verifies that the points just converted into m_bitBuffer lie inside the scan field.
+ *
+ * Runs the vectorized bounding-box pass over the freshly written (cache-hot) buffer,
+ * including z for (x, y, z) buffers. Out-of-field geometry is either rejected with a
+ * GeometryError or, with the Clip policy, flagged in m_clipToField so the block is
+ * emitted through the clipping paths.
+ */
+void GeometryHandler::enforceFieldBounds(size_t pointCount, size_t stride) {
+	m_clipToField = false;
+	const BitBounds bounds = FieldBounds::computeBitBounds(m_bitBuffer.data(), pointCount, stride);
+	if (FieldBounds::isInsideField(bounds)) {
+		return;
+	}
+
+	if (m_outOfFieldPolicy == MachineConfig::OutOfFieldPolicy::Clip) {
+		const size_t outside = FieldBounds::countOutsideField(m_bitBuffer.data(), pointCount, stride);
+		Logger::instance().log(LogLevel::Warning, LogEvent::FieldClipped, outside);
+		m_clipToField = true;
+		return;
+	}
+
+	const double factor = MachineConfig::MM_TO_BITS_CONVERSION_FACTOR;
+	std::stringstream ss;
+	ss << "Vector block exceeds the scan field: x [" << bounds.xMin << ", " << bounds.xMax
+		<< "], y [" << bounds.yMin << ", " << bounds.yMax << "]";
+	if (stride == 3) {
+		ss << ", z [" << bounds.zMin << ", " << bounds.zMax << "]";
+	}
+	ss << " bits (x [" << bounds.xMin / factor << ", "
+		<< bounds.xMax / factor << "], y [" << bounds.yMin / factor << ", " << bounds.yMax / factor
+		<< "] mm); the field is [" << FieldBounds::FIELD_MIN_BITS << ", " << FieldBounds::FIELD_MAX_BITS
+		<< "] bits. Check the WorkPlane position/rotation, FIELD_SCALE, CALIBRATION_MATRIX and MM_TO_BITS_CONVERSION_FACTOR.";
+	throw GeometryError(ss.str());
+}
+
+/**
+ * @brief Clip policy: emits a polyline or a set of hatches from m_bitBuffer cut to the scan field.
+ *
+ * A mark that leaves the field stops at the exit point and the next part inside starts
+ * with a jump to its re-entry point, so nothing is marked along the field edge.
+ *
+ * @param pointCount The number of points in m_bitBuffer.
+ * @param stride 2 for (x, y) buffers, 3 for (x, y, z) buffers.
+ * @param use3D Clips z as well and emits 3D jumps and marks.
+ * @param hatches True for independent start/end pairs, false for one polyline.
+ */
+void GeometryHandler::emitClippedSegments(size_t pointCount, size_t stride, bool use3D, bool hatches) {
+	const size_t dims = use3D ? 3 : 2;
+	bool penAtStart = false;
+	ClippedSegment segment;
+	for (size_t i = 0; i + 1 < pointCount; i += hatches ? 2 : 1) {
+		if (hatches) {
+			penAtStart = false;
+		}
+		if (FieldBounds::clipSegmentToField(&m_bitBuffer[stride * i], &m_bitBuffer[stride * (i + 1)], dims, segment)) {
+			emitClippedSegment(segment, use3D, penAtStart);
+		}
+		else {
+			penAtStart = false;
+		}
+	}
+}
+
+// Jumps to the segment's start unless the pen already stands there, then marks to its end.
+// `penAtStart` tells whether the pen stands at the start of the following segment.
+void GeometryHandler::emitClippedSegment(const ClippedSegment& segment, bool use3D, bool& penAtStart) {
+	if (use3D) {
+		if (!penAtStart || segment.startClipped) {
+			m_listHandler.addJumpAbsolute3D(segment.start[0], segment.start[1], segment.start[2]);
+		}
+		m_listHandler.addMarkAbsolute3D(segment.end[0], segment.end[1], segment.end[2]);
+	}
+	else {
+		if (!penAtStart || segment.startClipped) {
+			m_listHandler.addJumpAbsolute(segment.start[0], segment.start[1]);
+		}
+		m_listHandler.addMarkAbsolute(segment.end[0], segment.end[1]);
+	}
+	penAtStart = !segment.endClipped;
+}
+
+/**
+ * @brief Runs the short-vector filter over the hatches currently in m_bitBuffer.
+ *
+ * The thresholds are chosen by the block's part area (MachineConfig::SHORT_VECTOR_THRESHOLDS,
+ * unless overridden with setShortVectorThresholds())
+ * and the layer statistics are updated, including an estimate of the scan time saved:
+ * the mark time of every dropped segment plus a fixed per-vector overhead for every
+ * segment that no longer needs its own jump and mark.
+ *
+ * @return The number of hatches left at the front of m_bitBuffer.
+ */
+size_t GeometryHandler::filterShortHatches(size_t hatchCount,
+	const open_vector_format::VectorBlock& block,
+	const open_vector_format::MarkingParams& params)
+{
+	const int partArea = block.lpbf_metadata().part_area();
+	if (partArea < 0 || partArea >= static_cast<int>(m_shortVectorThresholds.size())) {
+		return hatchCount;
+	}
+	const auto& thresholds = m_shortVectorThresholds[partArea];
+	if (thresholds.minLengthMm <= 0.0) {
+		return hatchCount;
+	}
+	const double factor = MachineConfig::MM_TO_BITS_CONVERSION_FACTOR;
+
+	const ShortVectorFilter::Result result = ShortVectorFilter::filterHatches(
+		m_bitBuffer.data(), hatchCount, thresholds.minLengthMm * factor, thresholds.mergeToleranceMm * factor);
+
+	const double droppedLengthMm = result.droppedLengthBits / factor;
+	const double markSpeed = params.laser_speed_in_mm_per_s();
+	m_shortVectorStats.droppedVectors += result.droppedVectors;
+	m_shortVectorStats.mergedVectors += result.mergedVectors;
+	m_shortVectorStats.droppedMarkLengthMm += droppedLengthMm;
+	m_shortVectorStats.estimatedTimeSavedUs +=
+		(result.droppedVectors + result.mergedVectors) * MachineConfig::ESTIMATED_VECTOR_OVERHEAD_US
+		+ (markSpeed > 0.0 ? droppedLengthMm / markSpeed * 1.0e6 : 0.0);
+
+	return result.hatchCount;
+}
+
+/**
+ * @brief Maps the block's jump speed and delays to list commands.
+ *
+ * proto3 cannot tell an explicit 0 from a missing field, so a zero jump speed and an
+ * all-zero delay group mean "not specified" and leave the board's current setting alone.
+ * Repeats of the values already active are dropped by the ListHandler, so blocks that
+ * share a parameter set cost no extra list commands. With the ScanaheadAuto delay model
+ * the board derives all delays itself, so only the jump speed is written.
+ */
+void GeometryHandler::emitTimingParams(const open_vector_format::MarkingParams& params) {
+	if (params.jump_speed_in_mm_s() > 0.0f) {
+		m_listHandler.addSetJumpSpeed(params.jump_speed_in_mm_s());
+	}
+
+	if (m_delayModel == MachineConfig::DelayModel::ScanaheadAuto) {
+		return;
+	}
+
+	if (params.jump_delay_in_us() > 0.0f || params.mark_delay_in_us() > 0.0f || params.polygon_delay_in_us() > 0.0f) {
+		m_listHandler.addSetScannerDelays(
+			scannerDelayToBits(params.jump_delay_in_us()),
+			scannerDelayToBits(params.mark_delay_in_us()),
+			scannerDelayToBits(params.polygon_delay_in_us()));
+	}
+
+	if (params.laser_on_delay_in_us() != 0.0f || params.laser_off_delay_in_us() > 0.0f) {
+		const double bitsPerUs = Rtc6Constants::Units::LASER_DELAY_BITS_PER_US;
+		m_listHandler.addSetLaserDelays(
+			static_cast<INT>(std::round(params.laser_on_delay_in_us() * bitsPerUs)),
+			static_cast<UINT>(std::round(std::max(0.0f, params.laser_off_delay_in_us()) * bitsPerUs)));
+	}
+}
+
+/**
+ * @brief Maps MarkingParams::marking_mode and the sky-writing fields to list commands.
+ *
+ * The mode is sent for every block, including NO_SKY, so a block without sky-writing
+ * switches it off again after one that used it. The ListHandler drops the repeats, so the
+ * board only sees a mode command when the mode actually changes between blocks. The time
+ * lag and run-in/run-out only matter while a sky-writing mode is on, and the angle limit
+ * only for SKY_3, so they are skipped otherwise.
+ */
+void GeometryHandler::emitSkyWritingParams(const open_vector_format::MarkingParams& params) {
+	const UINT mode = static_cast<UINT>(params.marking_mode());
+	if (mode != open_vector_format::MarkingParams::NO_SKY) {
+		m_listHandler.addSetSkyWritingParams(
+			std::max(0.0f, params.time_lag_in_us()),
+			static_cast<INT>(std::round(params.laser_on_shift_in_us() * Rtc6Constants::Units::LASER_DELAY_BITS_PER_US)),
+			scannerDelayToBits(params.n_prev_in_us()),
+			scannerDelayToBits(params.n_post_in_us()));
+		if (mode == open_vector_format::MarkingParams::SKY_3) {
+			m_listHandler.addSetSkyWritingLimit(std::clamp(static_cast<double>(params.limit()), -1.0, 1.0));
+		}
+	}
+	m_listHandler.addSetSkyWritingMode(mode);
+}
+
+/**
+ * @brief Maps MarkingParams::wobble_mode and the wob_* fields to set_wobbel_mode.
+ *
+ * Like the sky-writing mode, the command is sent for every block and the ListHandler
+ * only writes it when shape, amplitude or frequency change, so a wobbled contour costs
+ * one command per parameter change. NO_WOBBLE, or a wobble without amplitude or
+ * frequency, is sent as all zeros, which switches wobbling off.
+ */
+void GeometryHandler::emitWobbleParams(const open_vector_format::MarkingParams& params) {
+	INT mode = Rtc6Constants::Wobbel::MODE_ELLIPSE;
+	switch (params.wobble_mode()) {
+	case open_vector_format::MarkingParams::STANDING_EIGHT_WOBBLE:
+		mode = Rtc6Constants::Wobbel::MODE_STANDING_EIGHT;
+		break;
+	case open_vector_format::MarkingParams::LYING_EIGHT_WOBBLE:
+		mode = Rtc6Constants::Wobbel::MODE_LYING_EIGHT;
+		break;
+	default:
+		break;
+	}
+
+	const auto amplitudeToBits = [](float amplitudeMm) {
+		return static_cast<UINT>(std::round(std::max(0.0f, amplitudeMm) * MachineConfig::MM_TO_BITS_CONVERSION_FACTOR));
+	};
+	const UINT transversal = amplitudeToBits(params.wob_amp_trans_in_mm());
+	const UINT longitudinal = amplitudeToBits(params.wob_amp_long_in_mm());
+	const double freqHz = std::max(0.0f, params.wob_frequency_in_hz());
+
+	if (params.wobble_mode() == open_vector_format::MarkingParams::NO_WOBBLE
+		|| freqHz <= 0.0 || (transversal == 0 && longitudinal == 0)) {
+		m_listHandler.addSetWobbleMode(0, 0, 0.0, Rtc6Constants::Wobbel::MODE_ELLIPSE);
+		return;
+	}
+	m_listHandler.addSetWobbleMode(transversal, longitudinal, freqHz, mode);
+}
+
+// Scanner delays are set in 10 us steps; negative values are treated as 0.
+UINT GeometryHandler::scannerDelayToBits(double delayUs) {
+	if (delayUs <= 0.0) return 0;
+	return static_cast<UINT>(std::round(delayUs / Rtc6Constants::Units::SCANNER_DELAY_US_PER_BIT));
+}
+
+// Converts an exposure time in microseconds to the RTC6 laser_on_list period (10 us per bit).
+UINT GeometryHandler::exposureTimeToPeriod(double timeUs) const {
+	if (timeUs <= 0.0) return 0;
+	return static_cast<UINT>(std::round(timeUs / 10.0));
+}
+
+/**
+ * @brief Emits a LineSequenceParaAdapt, changing laser power or defocus along the way.
+ *
+ * Each vertex is (x, y, value), where value is the goal the parameter reaches at the
+ * end of the vector. The linear ramp along a segment is approximated by the mean of
+ * its start and end values, quantized to the hardware unit (power DAC or defocus bits).
+ * A set command is only emitted when the quantized value differs from the one already
+ * active, so tessellated ramps with small steps produce few extra list commands.
+ *
+ * Adaptation of pulse length or repetition rate is not supported by this controller;
+ * those sequences are marked with the block's base parameters.
+ *
+ * @param activePower In/out: the power DAC value currently set on the board.
+ * @param activeFocus In/out: the defocus bits currently set on the board.
+ */
+void GeometryHandler::emitParaAdaptSequence(
+	const open_vector_format::VectorBlock::LineSequenceParaAdapt& sequence,
+	INT& activePower, INT& activeFocus)
+{
+	using Adapted = open_vector_format::VectorBlock::LineSequenceParaAdapt;
+	const auto& points = sequence.points_with_paras();
+	if (points.size() < 6) return;
+
+	const bool adaptPower = sequence.parameter() == Adapted::LASER_POWER_IN_W;
+	const bool adaptFocus = sequence.parameter() == Adapted::LASER_FOCUS_SHIFT_IN_MM;
+
+	auto quantize = [&](double value) -> INT {
+		if (adaptPower) {
+			return static_cast<INT>(powerToDAC((value / MachineConfig::MAX_LASER_POWER_W) * 100.0));
+		}
+		return mmToBits(value);
+	};
+
+	INT& activeValue = adaptPower ? activePower : activeFocus;
+
+	// The third component of each converted triple is unused; parameters are quantized from the source values.
+	const INT* bits = convertPoints3D(points, 0.0);
+	bool penAtStart = false;
+	if (!m_clipToField) {
+		m_listHandler.addJumpAbsolute(bits[0], bits[1]);
+	}
+	ClippedSegment segment;
+	for (int i = 3; i + 2 < points.size(); i += 3) {
+		if (m_clipToField && !FieldBounds::clipSegmentToField(bits + i - 3, bits + i, 2, segment)) {
+			penAtStart = false;
+			continue;
+		}
+		if (adaptPower || adaptFocus) {
+			const INT segmentValue = quantize((points[i - 1] + points[i + 2]) / 2.0);
+			if (segmentValue != activeValue) {
+				if (adaptPower) {
+					m_listHandler.addSetLaserPower(1, static_cast<UINT>(segmentValue));
+				}
+				else {
+					m_listHandler.addSetFocusOffset(segmentValue);
+				}
+				activeValue = segmentValue;
+			}
+		}
+		if (m_clipToField) {
+			emitClippedSegment(segment, false, penAtStart);
+		}
+		else {
+			m_listHandler.addMarkAbsolute(bits[i], bits[i + 1]);
+		}
+	}
+}
+
+// Total laser-on period for one point: exposure time multiplied by the number of
+// exposure cycles, so N repetitions still cost a single list command.
+UINT GeometryHandler::pointExposurePeriod(const open_vector_format::MarkingParams& params) const {
+	const double repetitions = std::max(1.0, std::round(static_cast<double>(params.point_exposure_repetitions())));
+	return exposureTimeToPeriod(params.point_exposure_time_in_us() * repetitions);
+}
+
 UINT GeometryHandler::powerToDAC(double percent) const {
 	if (percent < 0.0) percent = 0.0;
 	if (percent > 100.0) percent = 100.0;
@@ -2,7 +2,13 @@
 
 #include "InterfaceGeometryHandler.h"
 #include "InterfaceListHandler.h"
+#include "AffineTransform.h"
+#include "FixedPointTransform.h"
+#include "ShortVectorFilter.h"
+#include "FieldBounds.h"
+#include "MachineConfig.h"
 #include "open_vector_format.pb.h"
+#include <array>
 #include <vector>
 
 // Forward declaration for the test class
@@ -13,22 +19,84 @@ public:
     GeometryHandler(InterfaceListHandler& listHandler);
     ~GeometryHandler();
 
+    // Precomputes the fused part-to-bits transform for this layer.
+    void beginWorkPlane(const open_vector_format::WorkPlane& workPlane) override;
+
     // The new, more generic processing method.
-    // It takes the official Protobuf objects as direct input.
+    // It takes the official Protobuf objects as direct input. A block with repeats is
+    // emitted once inside a list loop.
     void processVectorBlock(
         const open_vector_format::VectorBlock& block,
         const open_vector_format::MarkingParams& params
     ) override;
 
+    // Commands are emitted directly, so there is nothing left to do at the end of a layer.
+    void endWorkPlane() override {}
+
+    ShortVectorStats getShortVectorStats() const override { return m_shortVectorStats; }
+
+    // Overrides MachineConfig::OUT_OF_FIELD_POLICY for this handler.
+    void setOutOfFieldPolicy(MachineConfig::OutOfFieldPolicy policy) { m_outOfFieldPolicy = policy; }
+
+    // Overrides the MachineConfig::SHORT_VECTOR_THRESHOLDS entry of one part area for this handler.
+    void setShortVectorThresholds(open_vector_format::VectorBlock::PartArea area, MachineConfig::ShortVectorThresholds thresholds) {
+        m_shortVectorThresholds[area] = thresholds;
+    }
+
+    // Overrides MachineConfig::DELAY_MODEL for this handler.
+    void setDelayModel(MachineConfig::DelayModel model) { m_delayModel = model; }
+
 private:
     // This allows your unit test to access the private helper methods.
     friend class GeometryHandler_LogicTest;
 
     InterfaceListHandler& m_listHandler;
-    static constexpr double BITS_PER_MM = 1000.0;
     static constexpr double MAX_LASER_POWER_W = 100.0; // Define max power for conversion
 
+    // Fused scale -> rotation -> offset -> calibration -> mm-to-bits transform for the current layer,
+    // quantized to integer multipliers so the per-point path uses integer arithmetic only.
+    FixedPointTransform m_layerToBits;
+    // Reused scratch buffer holding the converted (x, y) bit pairs of the current block.
+    std::vector<INT> m_bitBuffer;
+    // What the short-vector filter removed in the current layer.
+    ShortVectorStats m_shortVectorStats;
+    MachineConfig::OutOfFieldPolicy m_outOfFieldPolicy = MachineConfig::OUT_OF_FIELD_POLICY;
+    // Set by enforceFieldBounds() when the block in m_bitBuffer has to be emitted clipped.
+    bool m_clipToField = false;
+    MachineConfig::DelayModel m_delayModel = MachineConfig::DELAY_MODEL;
+    std::array<MachineConfig::ShortVectorThresholds, 3> m_shortVectorThresholds = {
+        MachineConfig::SHORT_VECTOR_THRESHOLDS[0],
+        MachineConfig::SHORT_VECTOR_THRESHOLDS[1],
+        MachineConfig::SHORT_VECTOR_THRESHOLDS[2]
+    };
+
+    // Emits one pass of the block.
+    void emitVectorBlock(const open_vector_format::VectorBlock& block,
+        const open_vector_format::MarkingParams& params);
+
     // These helpers remain unchanged but are now private
     int mmToBits(double mm) const;
     UINT powerToDAC(double percent) const;
+
+    // Converts interleaved (x, y) mm coordinates through m_layerToBits into m_bitBuffer.
+    const INT* convertPoints(const google::protobuf::RepeatedField<float>& points);
+    // Same for interleaved (x, y, z) coordinates; z is multiplied by zScale only.
+    const INT* convertPoints3D(const google::protobuf::RepeatedField<float>& points,
+        double zScale = MachineConfig::Z_MM_TO_BITS_CONVERSION_FACTOR);
+    void enforceFieldBounds(size_t pointCount, size_t stride);
+    void emitClippedSegments(size_t pointCount, size_t stride, bool use3D, bool hatches);
+    void emitClippedSegment(const ClippedSegment& segment, bool use3D, bool& penAtStart);
+    size_t filterShortHatches(size_t hatchCount,
+        const open_vector_format::VectorBlock& block,
+        const open_vector_format::MarkingParams& params);
+    UINT exposureTimeToPeriod(double timeUs) const;
+    void emitTimingParams(const open_vector_format::MarkingParams& params);
+    void emitSkyWritingParams(const open_vector_format::MarkingParams& params);
+    void emitWobbleParams(const open_vector_format::MarkingParams& params);
+    static UINT scannerDelayToBits(double delayUs);
+    UINT pointExposurePeriod(const open_vector_format::MarkingParams& params) const;
+    void emitParaAdaptSequence(
+        const open_vector_format::VectorBlock::LineSequenceParaAdapt& sequence,
+        INT& activePower, INT& activeFocus);
+    static AffineTransform buildLayerTransform(double xPosMm, double yPosMm, double zRotDeg);
 };
\ No newline at end of file
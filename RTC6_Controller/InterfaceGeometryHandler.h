@@ -1,10 +1,20 @@
 #pragma once
 #include "open_vector_format.pb.h"
+#include "ShortVectorFilter.h"
 
 class InterfaceGeometryHandler {
 public:
     virtual ~InterfaceGeometryHandler() = default;
 
+    /**
+     * @brief Prepares the handler for the vector blocks of a new work plane (layer).
+     *
+     * Called once per layer before any processVectorBlock() call, so per-layer
+     * state such as the WorkPlane position and rotation is computed only once.
+     * @param workPlane The OVF WorkPlane whose blocks are about to be processed.
+     */
+    virtual void beginWorkPlane(const open_vector_format::WorkPlane& workPlane) = 0;
+
     /**
      * @brief Processes a single geometric block and its associated parameters,
      *        translating them into low-level list commands.
@@ -14,4 +24,18 @@ public:
     virtual void processVectorBlock(
         const open_vector_format::VectorBlock& block,
         const open_vector_format::MarkingParams& params) = 0;
+
+    /**
+     * @brief Finishes the current work plane.
+     *
+     * Called once per layer after the last processVectorBlock() call and before the
+     * list is closed. Implementations that defer work (e.g. compile blocks in parallel)
+     * must have emitted all of the layer's commands when this returns.
+     */
+    virtual void endWorkPlane() = 0;
+
+    /**
+     * @brief Returns what the short-vector filter removed since the last beginWorkPlane().
+     */
+    virtual ShortVectorStats getShortVectorStats() const = 0;
 };
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "ProcessData.h" // For the Point struct
 #include <vector>
 #include "RTC6impl.h" // For UINT, INT
+#include "ScanTimeEstimator.h"
+#include "LatencyHistogram.h"
 
 class InterfaceListHandler {
 public:
@@ -15,16 +17,47 @@ public:
     virtual bool beginListPreparation() = 0;
     virtual void endListPreparation() = 0;
     virtual bool executeCurrentListAndCycle() = 0;
+    // Keep the commands of the layers prepared from now on, so that repeatLastLayer()
+    // can stream a layer again that did not fit into one list.
+    virtual void retainLayerForRepeat(bool retain) = 0;
+    // Runs the layer executed last once more, after its previous pass. Returns false if
+    // there is nothing to repeat.
+    virtual bool repeatLastLayer() = 0;
 
     // Status
     virtual bool isListBusy(UINT listIdToCheck) const = 0;
+    // Blocks until the list is idle. Returns true if it was still busy when called.
+    virtual bool waitForListCompletion(UINT listId) = 0;
+    // Time from a list ending to the host noticing, for every wait that had to block.
+    virtual LatencyHistogram getHandoverLatency() const = 0;
     virtual UINT getCurrentFillListId() const = 0;
+    virtual UINT getListCommandCount() const = 0;
+    virtual ScanTimeEstimate getListTimeEstimate() const = 0;
 
     // List Command Abstractions
     virtual void addJumpAbsolute(INT x, INT y) = 0;
     virtual void addMarkAbsolute(INT x, INT y) = 0;
+    virtual void addJumpAbsolute3D(INT x, INT y, INT z) = 0;
+    virtual void addMarkAbsolute3D(INT x, INT y, INT z) = 0;
+    virtual void addLaserOn(UINT period_10us) = 0;
     virtual void addSetFocusOffset(INT offset_bits) = 0;
     virtual void addSetMarkSpeed(double speed_mm_s) = 0;
     virtual void addSetLaserPower(UINT port, UINT power) = 0;
+    virtual void addSetJumpSpeed(double speed_mm_s) = 0;
+    virtual void addSetScannerDelays(UINT jump_10us, UINT mark_10us, UINT polygon_10us) = 0;
+    virtual void addSetLaserDelays(INT laserOn_64thUs, UINT laserOff_64thUs) = 0;
+    virtual void addSetSkyWritingMode(UINT mode) = 0;
+    virtual void addSetSkyWritingParams(double timelagUs, INT laserOnShift_64thUs, UINT nPrev_10us, UINT nPost_10us) = 0;
+    virtual void addSetSkyWritingLimit(double cosAngle) = 0;
+    // Amplitudes in bits; transversal and longitudinal 0 switch wobbling off.
+    virtual void addSetWobbleMode(UINT transversal_bits, UINT longitudinal_bits, double freqHz, INT mode) = 0;
+    // The commands added between addListRepeat() and addListUntil() run `passes` times.
+    // Loops do not nest.
+    virtual void addListRepeat() = 0;
+    virtual void addListUntil(UINT passes) = 0;
+    // Only 2D jumps and marks may be added between beginShape() and endShape(). A shape that
+    // repeats elsewhere, translated, may then be stored once on the board and called.
+    virtual void beginShape() = 0;
+    virtual void endShape() = 0;
     virtual UINT getLastExecutedListId() const = 0;
 };
\ No newline at end of file
@@ -10,9 +10,34 @@ public:
     virtual void api_set_end_of_list() = 0;
     virtual void api_execute_list(UINT listNo) = 0;
     virtual UINT api_read_status() = 0;
+    virtual UINT api_get_list_space() = 0;
     virtual void api_jump_abs(INT x, INT y) = 0;
     virtual void api_mark_abs(INT x, INT y) = 0;
+    virtual void api_jump_abs_3d(INT x, INT y, INT z) = 0;
+    virtual void api_mark_abs_3d(INT x, INT y, INT z) = 0;
+    virtual void api_laser_on_list(UINT period) = 0;
     virtual void api_set_defocus_list(INT offset) = 0;
     virtual void api_set_mark_speed(double speed) = 0;
     virtual void api_set_laser_power(UINT port, UINT power) = 0;
+    virtual void api_set_jump_speed(double speed) = 0;
+    virtual void api_set_scanner_delays(UINT jump, UINT mark, UINT polygon) = 0;
+    virtual void api_set_laser_delays(INT laserOnDelay, UINT laserOffDelay) = 0;
+    virtual void api_set_sky_writing_mode(UINT mode) = 0;
+    virtual void api_set_sky_writing_para(double timelag, INT laserOnShift, UINT nPrev, UINT nPost) = 0;
+    virtual void api_set_sky_writing_limit(double cosAngle) = 0;
+    virtual void api_set_wobbel_mode(UINT transversal, UINT longitudinal, double freq, INT mode) = 0;
+    virtual void api_set_jump_mode(INT flag) = 0;
+    virtual void api_list_repeat() = 0;
+    virtual void api_list_until(UINT number) = 0;
+    virtual void api_jump_rel(INT dx, INT dy) = 0;
+    virtual void api_mark_rel(INT dx, INT dy) = 0;
+    virtual void api_load_sub(UINT index) = 0;
+    virtual void api_list_return() = 0;
+    virtual void api_sub_call(UINT index) = 0;
+    virtual void api_load_list(UINT listNo, UINT pos) = 0;
+    virtual void api_stop_execution() = 0;
+    // The list and position the board is executing, or executed last.
+    virtual void api_get_out_pointer(UINT& listNo, UINT& pos) = 0;
+    // The position the next list command is written to.
+    virtual UINT api_get_input_pointer() = 0;
 };
\ No newline at end of file
@@ -0,0 +1,34 @@
+#include "JobTimeEstimator.h"
+
+JobTimeEstimator::JobTimeEstimator(int totalLayers, int recoatingDelayMs)
+    : m_totalLayers(totalLayers),
+    m_recoatingDelayMs(recoatingDelayMs) {
+}
+
+void JobTimeEstimator::addLayerEstimate(const ScanTimeEstimate& estimate) {
+    m_modelledScanUs += estimate.totalUs();
+    ++m_preparedLayers;
+}
+
+void JobTimeEstimator::addMeasurement(double modelledUs, double measuredUs) {
+    if (modelledUs <= 0.0 || measuredUs <= 0.0) return;
+    m_calibrationModelledUs += modelledUs;
+    m_calibrationMeasuredUs += measuredUs;
+}
+
+double JobTimeEstimator::getCalibrationFactor() const {
+    if (m_calibrationModelledUs <= 0.0) return 1.0;
+    return m_calibrationMeasuredUs / m_calibrationModelledUs;
+}
+
+double JobTimeEstimator::calibratedLayerUs(const ScanTimeEstimate& estimate) const {
+    return estimate.totalUs() * getCalibrationFactor();
+}
+
+double JobTimeEstimator::estimatedJobUs() const {
+    double scanUs = m_modelledScanUs;
+    if (m_preparedLayers > 0 && m_preparedLayers < m_totalLayers) {
+        scanUs += (m_modelledScanUs / m_preparedLayers) * (m_totalLayers - m_preparedLayers);
+    }
+    return scanUs * getCalibrationFactor() + m_totalLayers * m_recoatingDelayMs * 1000.0;
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "ScanTimeEstimator.h"
+
+/**
+ * @brief Projects the duration of a whole print job from per-layer scan-time estimates.
+ *
+ * Every prepared layer adds its modelled scan time. Layers that have not been prepared
+ * yet are assumed to take the average of the prepared ones. Each layer also pays the
+ * recoating delay.
+ *
+ * The model can be calibrated against reality. Each measured layer execution time
+ * updates a correction factor (total measured / total modelled time), which is then
+ * applied to every estimate.
+ */
+class JobTimeEstimator {
+public:
+    JobTimeEstimator(int totalLayers, int recoatingDelayMs);
+
+    void addLayerEstimate(const ScanTimeEstimate& estimate);
+
+    /**
+     * @brief Feeds one measured layer execution back into the calibration.
+     * @param modelledUs The uncalibrated estimate of that layer.
+     * @param measuredUs The measured execution time of that layer.
+     */
+    void addMeasurement(double modelledUs, double measuredUs);
+
+    // Measured / modelled time over all measurements so far; 1.0 until the first one.
+    double getCalibrationFactor() const;
+
+    // Calibrated duration of a single layer estimate.
+    double calibratedLayerUs(const ScanTimeEstimate& estimate) const;
+
+    // Calibrated duration of the whole job, including recoating.
+    double estimatedJobUs() const;
+
+    int getPreparedLayerCount() const { return m_preparedLayers; }
+
+private:
+    int m_totalLayers;
+    int m_recoatingDelayMs;
+    int m_preparedLayers = 0;
+    double m_modelledScanUs = 0.0;
+    double m_calibrationModelledUs = 0.0;
+    double m_calibrationMeasuredUs = 0.0;
+};
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+void LatencyHistogram::record(double latencyUs) {
+    latencyUs = std::max(latencyUs, 0.0);
+    size_t bucket = 0;
+    if (latencyUs >= 1.0) {
+        int exponent = 0;
+        std::frexp(latencyUs, &exponent); // latencyUs = m * 2^exponent with m in [0.5, 1)
+        bucket = std::min(static_cast<size_t>(exponent), BUCKET_COUNT - 1);
+    }
+    ++m_buckets[bucket];
+    ++m_count;
+    m_sumUs += latencyUs;
+    m_maxUs = std::max(m_maxUs, latencyUs);
+}
+
+void LatencyHistogram::reset() {
+    *this = LatencyHistogram();
+}
+
+double LatencyHistogram::percentileUs(double percentile) const {
+    if (m_count == 0) {
+        return 0.0;
+    }
+    const double clamped = std::clamp(percentile, 0.0, 100.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(m_count))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += m_buckets[i];
+        if (seen >= rank) {
+            return std::min(std::ldexp(1.0, static_cast<int>(i)), m_maxUs);
+        }
+    }
+    return m_maxUs;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief A fixed-size histogram of latencies in microseconds with power-of-two buckets.
+ *
+ * Bucket 0 counts samples below 1 us and bucket i counts samples in [2^(i-1), 2^i) us.
+ * The last bucket also collects everything above its lower edge. Recording is O(1)
+ * and never allocates, so it can run inside wait loops.
+ */
+class LatencyHistogram {
+public:
+    static constexpr size_t BUCKET_COUNT = 24; // Up to about 8 s.
+
+    void record(double latencyUs);
+    void reset();
+
+    uint64_t count() const { return m_count; }
+    double maxUs() const { return m_maxUs; }
+    double meanUs() const { return m_count == 0 ? 0.0 : m_sumUs / static_cast<double>(m_count); }
+    uint64_t bucketCount(size_t bucket) const { return m_buckets[bucket]; }
+
+    /**
+     * @brief Upper bound of the bucket that holds the given percentile.
+     * @param percentile In the range 0..100.
+     * @return The bucket's upper edge in us (capped at maxUs()), or 0 if nothing was recorded.
+     */
+    double percentileUs(double percentile) const;
+
+private:
+    std::array<uint64_t, BUCKET_COUNT> m_buckets{};
+    uint64_t m_count = 0;
+    double m_sumUs = 0.0;
+    double m_maxUs = 0.0;
+};
\ No newline at end of file
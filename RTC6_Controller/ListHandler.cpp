@@ -1,8 +1,13 @@
 #include "ListHandler.h"
 #include "Rtc6Constants.h"
-#include <iostream>
-#include <iomanip> // Required for std::hex/dec formatting
+#include "Logger.h"
+#include "MachineConfig.h"
+#include "Rtc6Exception.h"
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <limits>
+#include <thread>
 
 // ListHandler orchestrates the creation and execution of command lists for the RTC6 board.
 // It requires a communicator to check board readiness and an RTC API wrapper to send commands.
@@ -11,9 +16,19 @@ ListHandler::ListHandler(InterfaceCommunicator& communicator, InterfaceRtcApi& r
     m_rtcApi(rtcApi),
     m_currentListIdForFilling(1), // Start by preparing commands for List 1.
     m_currentListIdForExecution(0),  // No list is executing initially.
-	m_lastExecutedListId(0) // Initialize last executed list ID to 0.
+	m_lastExecutedListId(0), // Initialize last executed list ID to 0.
+    m_listCommandCount(0),
+    m_chainedListId(0),
+    m_jumpModeMinLengthBits(MachineConfig::USE_JUMP_MODE
+        ? MachineConfig::JUMP_MODE_MIN_LENGTH_MM * MachineConfig::MM_TO_BITS_CONVERSION_FACTOR : 0.0),
+    m_listCapacity(std::numeric_limits<UINT>::max()), // No limit is known until a list is started.
+    m_listWriteBudget(std::numeric_limits<UINT>::max()),
+    m_listWaitTimeout(MachineConfig::LIST_WAIT_TIMEOUT_MS),
+    m_useSubroutines(MachineConfig::USE_SUBROUTINE_INSTANCING),
+    m_subroutines(MachineConfig::SUBROUTINE_MAX_COUNT, MachineConfig::SUBROUTINE_MEMORY_POSITIONS,
+        MachineConfig::SUBROUTINE_MIN_MOVES)
 {
-    std::cout << "[ListHandler] Instance created. Default fill target: List 1." << std::endl;
+    Logger::instance().log(LogLevel::Info, LogEvent::ListHandlerCreated);
 }
 
 ListHandler::~ListHandler() {}
@@ -25,11 +40,11 @@ UINT ListHandler::getLastExecutedListId() const {
 // Arms the RTC6's automatic list-switching capability for the first time.
 bool ListHandler::setupAutoChangeMode() {
     if (!m_communicator.isSuccessfullySetup()) {
-        std::cerr << "ERROR: [ListHandler] Cannot setup auto-change, Rtc6Communicator not ready." << std::endl;
+        Logger::instance().log(LogLevel::Error, LogEvent::AutoChangeNotReady);
         return false;
     }
-    std::cout << "[ListHandler] Arming initial auto-change." << std::endl;
-    std::cout << "  [API CALL] api_auto_change()" << std::endl;
+    Logger::instance().log(LogLevel::Info, LogEvent::AutoChangeArmed);
+    Logger::instance().log(LogLevel::Debug, LogEvent::ApiAutoChange);
     m_rtcApi.api_auto_change();
     return true;
 }
@@ -37,57 +52,111 @@ bool ListHandler::setupAutoChangeMode() {
 // Re-arms the RTC6's automatic list-switching capability for subsequent transitions.
 void ListHandler::reArmAutoChange() {
     if (m_communicator.isSuccessfullySetup()) {
-        std::cout << "[ListHandler] Re-arming auto-change for the next list transition." << std::endl;
-        std::cout << "  [API CALL] api_auto_change()" << std::endl;
+        Logger::instance().log(LogLevel::Info, LogEvent::AutoChangeReArmed);
+        Logger::instance().log(LogLevel::Debug, LogEvent::ApiAutoChange);
         m_rtcApi.api_auto_change();
     }
 }
 
 // Designates the start of a command list buffer in the RTC6's memory.
+// After a chunked layer the list to fill may still run the layer's next-to-last chunk,
+// and set_start_list on a running list is ignored, so it is waited for first.
 bool ListHandler::beginListPreparation() {
     if (!m_communicator.isSuccessfullySetup()) {
-        std::cerr << "ERROR: [ListHandler] Cannot begin list preparation, Rtc6Communicator not ready." << std::endl;
+        Logger::instance().log(LogLevel::Error, LogEvent::ListPreparationNotReady);
         return false;
     }
-    std::cout << "[ListHandler] Beginning preparation for List " << m_currentListIdForFilling << std::endl;
-    std::cout << "  [API CALL] api_set_start_list(list_id=" << m_currentListIdForFilling << ")" << std::endl;
-    m_rtcApi.api_set_start_list(m_currentListIdForFilling);
+    waitForListCompletion(m_currentListIdForFilling);
+    Logger::instance().log(LogLevel::Info, LogEvent::ListPreparationBegin, m_currentListIdForFilling);
+    startListFill(m_currentListIdForFilling);
+    m_heldBack.clear();
+    m_layerCommands.clear();
+    m_inLoop = false;
+    m_loopBody.clear();
+    m_inShape = false;
+    m_shape.clear();
+    m_subroutines.beginLayer();
+    m_activeParameters.fill(std::nullopt);
+    m_listCommandCount = 0;
+    m_timeEstimator.reset();
     return true;
 }
 
 // Designates the end of a command list buffer.
 void ListHandler::endListPreparation() {
-    std::cout << "[ListHandler] Ending preparation for List " << m_currentListIdForFilling << std::endl;
-    std::cout << "  [API CALL] api_set_end_of_list()" << std::endl;
+    Logger::instance().log(LogLevel::Info, LogEvent::ListPreparationEnd, m_currentListIdForFilling);
+    Logger::instance().log(LogLevel::Debug, LogEvent::ApiSetEndOfList);
     m_rtcApi.api_set_end_of_list();
+    if (!m_heldBack.empty()) {
+        Logger::instance().log(LogLevel::Info, LogEvent::ListFull, m_currentListIdForFilling, m_heldBack.size());
+    }
+    if (m_subroutines.refusedLoads() > 0) {
+        Logger::instance().log(LogLevel::Warning, LogEvent::SubroutineLibraryFull, m_subroutines.refusedLoads(),
+            m_subroutines.loadedCount(), m_subroutines.usedPositions());
+    }
 }
 
 // Triggers the execution of the list that was just prepared.
 bool ListHandler::executeCurrentListAndCycle() {
     if (!m_communicator.isSuccessfullySetup()) {
-        std::cerr << "ERROR: [ListHandler] Cannot execute list, Rtc6Communicator not ready." << std::endl;
+        Logger::instance().log(LogLevel::Error, LogEvent::ListExecuteNotReady);
         return false;
     }
 
     UINT listToExecute = m_currentListIdForFilling;
-    std::cout << "[ListHandler] Commanding execution of List " << listToExecute << std::endl;
-    std::cout << "  [API CALL] api_execute_list(list_id=" << listToExecute << ")" << std::endl;
+    Logger::instance().log(LogLevel::Info, LogEvent::ListExecute, listToExecute);
+    Logger::instance().log(LogLevel::Debug, LogEvent::ApiExecuteList, listToExecute);
     m_rtcApi.api_execute_list(listToExecute);
     m_lastExecutedListId = m_currentListIdForFilling;
 
     m_currentListIdForExecution = listToExecute;
+    m_lastLayerChunked = !m_heldBack.empty();
     switchFillListTarget();
+    streamHeldBackCommands();
+    return true;
+}
+
+void ListHandler::retainLayerForRepeat(bool retain) {
+    m_retainLayer = retain;
+}
+
+// The board keeps a list's contents after executing it, so a layer that fit into one list
+// is repeated without any transfer. Of a chunked layer only the last chunk is left.
+bool ListHandler::repeatLastLayer() {
+    if (!m_communicator.isSuccessfullySetup()) {
+        Logger::instance().log(LogLevel::Error, LogEvent::ListExecuteNotReady);
+        return false;
+    }
+    if (m_lastExecutedListId == 0) {
+        return false;
+    }
+
+    if (!m_lastLayerChunked) {
+        waitForListCompletion(m_lastExecutedListId);
+        Logger::instance().log(LogLevel::Info, LogEvent::ListRepeat, m_lastExecutedListId);
+        Logger::instance().log(LogLevel::Debug, LogEvent::ApiExecuteList, m_lastExecutedListId);
+        m_rtcApi.api_execute_list(m_lastExecutedListId);
+        m_currentListIdForExecution = m_lastExecutedListId;
+        return true;
+    }
+
+    if (m_layerCommands.empty()) {
+        Logger::instance().log(LogLevel::Warning, LogEvent::LayerRepeatUnavailable);
+        return false;
+    }
+    Logger::instance().log(LogLevel::Info, LogEvent::LayerRestream, m_layerCommands.size());
+    streamCommands(m_layerCommands);
     return true;
 }
 
 // Checks the RTC6 status bits to see if a specific list is still being processed.
 bool ListHandler::isListBusy(UINT listIdToCheck) const {
     if (!m_communicator.isSuccessfullySetup()) {
-        std::cerr << "WARNING: [ListHandler] Communicator not ready; assuming list is busy." << std::endl;
+        Logger::instance().log(LogLevel::Warning, LogEvent::ListBusyCheckNotReady);
         return true;
     }
     if (listIdToCheck != 1 && listIdToCheck != 2) {
-        std::cerr << "WARNING: [ListHandler] Invalid listId " << listIdToCheck << " for isListBusy check." << std::endl;
+        Logger::instance().log(LogLevel::Warning, LogEvent::ListBusyCheckInvalidId, listIdToCheck);
         return true;
     }
 
@@ -107,45 +176,668 @@ UINT ListHandler::getCurrentFillListId() const {
     return m_currentListIdForFilling;
 }
 
+UINT ListHandler::getListCommandCount() const {
+    return m_listCommandCount;
+}
+
+ScanTimeEstimate ListHandler::getListTimeEstimate() const {
+    return m_timeEstimator.current();
+}
+
 // --- List Command Functions ---
 
 void ListHandler::addJumpAbsolute(INT x, INT y) {
-    std::cout << "  [API CALL] api_jump_abs(x=" << x << ", y=" << y << ")" << std::endl;
-    m_rtcApi.api_jump_abs(x, y);
+    if (m_inShape) {
+        m_shape.push_back({ ListCommand::Type::Jump, x, y });
+        return;
+    }
+    selectJumpMode(x, y);
+    submit({ ListCommand::Type::Jump, x, y });
+    ++m_listCommandCount;
+    m_timeEstimator.jumpTo(x, y);
+    m_lastX = x;
+    m_lastY = y;
 }
 
 void ListHandler::addMarkAbsolute(INT x, INT y) {
-    std::cout << "  [API CALL] api_mark_abs(x=" << x << ", y=" << y << ")" << std::endl;
-    m_rtcApi.api_mark_abs(x, y);
+    if (m_inShape) {
+        m_shape.push_back({ ListCommand::Type::Mark, x, y });
+        return;
+    }
+    submit({ ListCommand::Type::Mark, x, y });
+    ++m_listCommandCount;
+    m_timeEstimator.markTo(x, y);
+    m_lastX = x;
+    m_lastY = y;
+}
+
+void ListHandler::addJumpAbsolute3D(INT x, INT y, INT z) {
+    selectJumpMode(x, y);
+    submit({ ListCommand::Type::Jump3D, x, y, z });
+    ++m_listCommandCount;
+    m_timeEstimator.jumpTo3D(x, y, z);
+    m_lastX = x;
+    m_lastY = y;
+}
+
+void ListHandler::addMarkAbsolute3D(INT x, INT y, INT z) {
+    submit({ ListCommand::Type::Mark3D, x, y, z });
+    ++m_listCommandCount;
+    m_timeEstimator.markTo3D(x, y, z);
+    m_lastX = x;
+    m_lastY = y;
+}
+
+void ListHandler::setSubroutineInstancing(bool enabled) {
+    m_useSubroutines = enabled;
+}
+
+void ListHandler::setListWaitTimeout(std::chrono::milliseconds timeout) {
+    m_listWaitTimeout = timeout;
+}
+
+void ListHandler::setJumpModeMinLength(double lengthMm) {
+    m_jumpModeMinLengthBits = std::max(0.0, lengthMm) * MachineConfig::MM_TO_BITS_CONVERSION_FACTOR;
+}
+
+// The choice is made here rather than in the GeometryHandler because only this sequential
+// stage knows where the previous block, compiled by another worker, left the scanner.
+// Long jumps run with the head's jump tuning and the delay from the jump table loaded at
+// setup; short ones keep the normal tuning, which settles faster over short distances.
+void ListHandler::selectJumpMode(INT x, INT y) {
+    if (m_jumpModeMinLengthBits <= 0.0) {
+        return;
+    }
+    const double length = std::hypot(static_cast<double>(x) - m_lastX, static_cast<double>(y) - m_lastY);
+    const bool useJumpMode = length >= m_jumpModeMinLengthBits;
+    if (m_inLoop && !m_loopHasMoved) {
+        // The active values were forgotten at addListRepeat(), so the mode is written at this index.
+        m_loopEntryJump = LoopEntryJump{ m_loopBody.size(), x, y, length };
+    }
+    if (submitParameter({ ListCommand::Type::SetJumpMode, useJumpMode ? 1 : 0 })) {
+        ++m_listCommandCount;
+        m_timeEstimator.setJumpMode(useJumpMode);
+    }
+}
+
+// Keeps the laser on at the current position. The period is in RTC6 units of 10 us.
+void ListHandler::addLaserOn(UINT period_10us) {
+    submit({ ListCommand::Type::LaserOn, static_cast<INT>(period_10us) });
+    ++m_listCommandCount;
+    m_timeEstimator.laserOn(period_10us);
 }
 
 void ListHandler::addSetFocusOffset(INT offset_bits) {
-    std::cout << "  [API CALL] api_set_defocus_list(offset=" << offset_bits << ")" << std::endl;
-    m_rtcApi.api_set_defocus_list(offset_bits);
+    if (submitParameter({ ListCommand::Type::SetFocusOffset, offset_bits })) {
+        ++m_listCommandCount;
+        m_timeEstimator.parameterCommand();
+    }
 }
 
 void ListHandler::addSetMarkSpeed(double speed_mm_s) {
-    static constexpr double BITS_PER_MM = 1000.0;
-    double speed_bits_per_ms = speed_mm_s * BITS_PER_MM / 1000.0;
-
-    std::cout << "[ListHandler] Adding set_mark_speed: " << speed_bits_per_ms << " bits/ms (" << speed_mm_s << " mm/s)" << std::endl;
-    std::cout << "  [API CALL] api_set_mark_speed(speed=" << speed_bits_per_ms << ")" << std::endl;
-    m_rtcApi.api_set_mark_speed(speed_bits_per_ms);
+    if (submitParameter({ ListCommand::Type::SetMarkSpeed, 0, 0, 0, speed_mm_s })) {
+        ++m_listCommandCount;
+        m_timeEstimator.setMarkSpeed(speed_mm_s);
+    }
 }
 
 void ListHandler::addSetLaserPower(UINT port, UINT power) {
-    std::cout << "  [API CALL] api_set_laser_power(port=" << port << ", power=" << power << ")" << std::endl;
-    m_rtcApi.api_set_laser_power(port, power);
+    if (submitParameter({ ListCommand::Type::SetLaserPower, static_cast<INT>(port), static_cast<INT>(power) })) {
+        ++m_listCommandCount;
+        m_timeEstimator.parameterCommand();
+    }
+}
+
+void ListHandler::addSetJumpSpeed(double speed_mm_s) {
+    if (submitParameter({ ListCommand::Type::SetJumpSpeed, 0, 0, 0, speed_mm_s })) {
+        ++m_listCommandCount;
+        m_timeEstimator.setJumpSpeed(speed_mm_s);
+    }
+}
+
+// Delays are in the board's units: 10 us for the scanner delays.
+void ListHandler::addSetScannerDelays(UINT jump_10us, UINT mark_10us, UINT polygon_10us) {
+    if (submitParameter({ ListCommand::Type::SetScannerDelays,
+        static_cast<INT>(jump_10us), static_cast<INT>(mark_10us), static_cast<INT>(polygon_10us) })) {
+        ++m_listCommandCount;
+        const double usPerBit = Rtc6Constants::Units::SCANNER_DELAY_US_PER_BIT;
+        m_timeEstimator.setScannerDelays(jump_10us * usPerBit, mark_10us * usPerBit, polygon_10us * usPerBit);
+    }
+}
+
+// Delays are in the board's units: 1/64 us for the laser delays. The on-delay may be negative.
+void ListHandler::addSetLaserDelays(INT laserOn_64thUs, UINT laserOff_64thUs) {
+    if (submitParameter({ ListCommand::Type::SetLaserDelays, laserOn_64thUs, static_cast<INT>(laserOff_64thUs) })) {
+        ++m_listCommandCount;
+        m_timeEstimator.parameterCommand();
+    }
+}
+
+void ListHandler::addSetSkyWritingMode(UINT mode) {
+    if (submitParameter({ ListCommand::Type::SetSkyWritingMode, static_cast<INT>(mode) })) {
+        ++m_listCommandCount;
+        m_timeEstimator.setSkyWritingMode(mode);
+    }
+}
+
+// Run-in and run-out are in 10 us units, the laser-on shift in 1/64 us, the time lag in us.
+void ListHandler::addSetSkyWritingParams(double timelagUs, INT laserOnShift_64thUs, UINT nPrev_10us, UINT nPost_10us) {
+    if (submitParameter({ ListCommand::Type::SetSkyWritingParams,
+        laserOnShift_64thUs, static_cast<INT>(nPrev_10us), static_cast<INT>(nPost_10us), timelagUs })) {
+        ++m_listCommandCount;
+        m_timeEstimator.setSkyWritingRunInOut(nPrev_10us * 10.0, nPost_10us * 10.0);
+    }
+}
+
+void ListHandler::addSetSkyWritingLimit(double cosAngle) {
+    if (submitParameter({ ListCommand::Type::SetSkyWritingLimit, 0, 0, 0, cosAngle })) {
+        ++m_listCommandCount;
+        m_timeEstimator.parameterCommand();
+    }
+}
+
+// Wobbling moves the spot around the vector path without changing the speed along it,
+// so it costs the estimate nothing beyond the command itself.
+void ListHandler::addSetWobbleMode(UINT transversal_bits, UINT longitudinal_bits, double freqHz, INT mode) {
+    if (submitParameter({ ListCommand::Type::SetWobbleMode,
+        static_cast<INT>(transversal_bits), static_cast<INT>(longitudinal_bits), mode, freqHz })) {
+        ++m_listCommandCount;
+        m_timeEstimator.parameterCommand();
+    }
+}
+
+// Every pass of the body starts from the values the previous pass left, so the body must
+// set each parameter it relies on itself: the active values are forgotten for its duration.
+void ListHandler::addListRepeat() {
+    if (m_inLoop) {
+        throw ConfigurationError("List loops cannot be nested.");
+    }
+    m_inLoop = true;
+    m_loopBody.clear();
+    m_loopHasMoved = false;
+    m_loopEntryJump.reset();
+    m_parametersBeforeLoop = m_activeParameters;
+    m_activeParameters.fill(std::nullopt);
+    m_timeEstimator.beginRepeat();
+}
+
+// A body that starts with a jump starts it from before the loop on the first pass and from
+// the body's end on every later one. One SetJumpMode serves all passes, so it is chosen for
+// the longer of the two jumps.
+void ListHandler::selectLoopEntryJumpMode() {
+    if (!m_loopEntryJump || m_loopBody[m_loopEntryJump->jumpModeIndex].type != ListCommand::Type::SetJumpMode) {
+        return;
+    }
+    const LoopEntryJump& entry = *m_loopEntryJump;
+    const double lengthFromBodyEnd = std::hypot(static_cast<double>(entry.x) - m_lastX, static_cast<double>(entry.y) - m_lastY);
+    const bool useJumpMode = std::max(entry.lengthBeforeLoop, lengthFromBodyEnd) >= m_jumpModeMinLengthBits;
+    ListCommand& jumpMode = m_loopBody[entry.jumpModeIndex];
+    jumpMode.x = useJumpMode ? 1 : 0;
+    const bool setAgainLater = std::any_of(m_loopBody.begin() + static_cast<std::ptrdiff_t>(entry.jumpModeIndex) + 1,
+        m_loopBody.end(), [](const ListCommand& c) { return c.type == ListCommand::Type::SetJumpMode; });
+    if (!setAgainLater) {
+        m_activeParameters[static_cast<size_t>(ListCommand::Type::SetJumpMode)] = jumpMode;
+    }
+}
+
+void ListHandler::addListUntil(UINT passes) {
+    if (!m_inLoop) {
+        throw ConfigurationError("List loop ended without being started.");
+    }
+    m_inLoop = false;
+    if (passes > 1) {
+        selectLoopEntryJumpMode();
+    }
+    for (size_t i = 0; i < m_activeParameters.size(); ++i) {
+        if (!m_activeParameters[i]) {
+            m_activeParameters[i] = m_parametersBeforeLoop[i];
+        }
+    }
+    m_timeEstimator.endRepeat(passes);
+
+    const size_t loopSize = m_loopBody.size() + 2;
+    if (passes > 1 && loopSize <= commandsThatFit(m_listCapacity)) {
+        if (m_heldBack.empty() && !hasListRoomFor(loopSize)) {
+            m_listClosed = true; // The loop starts the next chunk instead of being split.
+        }
+        submit({ ListCommand::Type::ListRepeat });
+        for (const auto& command : m_loopBody) {
+            submit(command);
+        }
+        submit({ ListCommand::Type::ListUntil, static_cast<INT>(passes) });
+        m_listCommandCount += 2;
+    }
+    else {
+        if (passes > 1) {
+            Logger::instance().log(LogLevel::Warning, LogEvent::LoopUnrolled, m_loopBody.size(), passes);
+        }
+        for (UINT pass = 0; pass < std::max(passes, 1u); ++pass) {
+            for (const auto& command : m_loopBody) {
+                submit(command);
+            }
+        }
+        m_listCommandCount += static_cast<UINT>(m_loopBody.size() * (std::max(passes, 1u) - 1));
+    }
+    m_loopBody.clear();
+}
+
+void ListHandler::beginShape() {
+    m_inShape = m_useSubroutines;
+    m_shape.clear();
+}
+
+// The subroutine holds the moves after the first point, relative to the point before, so a
+// call draws the shape wherever the absolute jump or mark before it left the scanner. Its
+// jumps run in normal mode: a shape with a jump long enough for jump mode is written out.
+void ListHandler::endShape() {
+    if (!m_inShape) {
+        return;
+    }
+    m_inShape = false;
+    std::vector<ListCommand> shape;
+    shape.swap(m_shape);
+    if (shape.empty()) {
+        return;
+    }
+
+    std::vector<ListCommand> moves;
+    moves.reserve(shape.size() - 1);
+    bool needsJumpMode = false;
+    for (size_t i = 1; i < shape.size(); ++i) {
+        const bool isJump = shape[i].type == ListCommand::Type::Jump;
+        const INT dx = shape[i].x - shape[i - 1].x;
+        const INT dy = shape[i].y - shape[i - 1].y;
+        moves.push_back({ isJump ? ListCommand::Type::JumpRel : ListCommand::Type::MarkRel, dx, dy });
+        if (isJump && m_jumpModeMinLengthBits > 0.0
+            && std::hypot(static_cast<double>(dx), static_cast<double>(dy)) >= m_jumpModeMinLengthBits) {
+            needsJumpMode = true;
+        }
+    }
+
+    const SubroutineLibrary::Lookup found = needsJumpMode ? SubroutineLibrary::Lookup{} : m_subroutines.lookup(moves);
+    if (found.action == SubroutineLibrary::Action::Load) {
+        loadSubroutine(found.index, moves);
+    }
+    if (found.action == SubroutineLibrary::Action::Inline) {
+        for (const auto& move : shape) {
+            if (move.type == ListCommand::Type::Jump) {
+                addJumpAbsolute(move.x, move.y);
+            }
+            else {
+                addMarkAbsolute(move.x, move.y);
+            }
+        }
+        return;
+    }
+
+    const ListCommand& start = shape.front();
+    if (start.type == ListCommand::Type::Jump) {
+        addJumpAbsolute(start.x, start.y);
+    }
+    else {
+        addMarkAbsolute(start.x, start.y);
+    }
+    if (m_jumpModeMinLengthBits > 0.0 && submitParameter({ ListCommand::Type::SetJumpMode, 0 })) {
+        ++m_listCommandCount;
+        m_timeEstimator.setJumpMode(false);
+    }
+    submit({ ListCommand::Type::SubCall, static_cast<INT>(found.index) });
+    ++m_listCommandCount;
+    m_timeEstimator.parameterCommand();
+    for (size_t i = 1; i < shape.size(); ++i) {
+        if (shape[i].type == ListCommand::Type::Jump) {
+            m_timeEstimator.jumpTo(shape[i].x, shape[i].y);
+        }
+        else {
+            m_timeEstimator.markTo(shape[i].x, shape[i].y);
+        }
+    }
+    m_timeEstimator.parameterCommand(); // list_return
+    m_lastX = shape.back().x;
+    m_lastY = shape.back().y;
+}
+
+// The subroutine goes into the protected memory behind the lists. The list being filled is
+// not running, so load_list can resume it right after the last command written, at the
+// position read back from the board.
+void ListHandler::loadSubroutine(UINT index, const std::vector<ListCommand>& moves) {
+    const UINT resumePosition = readListPositionsUsed();
+    Logger::instance().log(LogLevel::Info, LogEvent::SubroutineLoaded, index, moves.size());
+    Logger::instance().log(LogLevel::Debug, LogEvent::ApiLoadSub, index);
+    m_rtcApi.api_load_sub(index);
+    for (const auto& move : moves) {
+        writeCommand(move);
+    }
+    Logger::instance().log(LogLevel::Debug, LogEvent::ApiListReturn);
+    m_rtcApi.api_list_return();
+    Logger::instance().log(LogLevel::Debug, LogEvent::ApiLoadList, m_currentListIdForFilling, resumePosition);
+    m_rtcApi.api_load_list(m_currentListIdForFilling, resumePosition);
+}
+
+// The board keeps a parameter until it is set again, so the active values carry over
+// between vector blocks and chunks. They are forgotten when a new list is started.
+bool ListHandler::submitParameter(const ListCommand& command) {
+    std::optional<ListCommand>& active = m_activeParameters[static_cast<size_t>(command.type)];
+    if (active && *active == command) {
+        return false;
+    }
+    active = command;
+    submit(command);
+    return true;
+}
+
+// Once one command has been held back, all later ones are too, so the order is kept.
+void ListHandler::submit(const ListCommand& command) {
+    if (m_inLoop) {
+        m_loopBody.push_back(command);
+        m_loopHasMoved = m_loopHasMoved || command.type == ListCommand::Type::Jump || command.type == ListCommand::Type::Mark
+            || command.type == ListCommand::Type::Jump3D || command.type == ListCommand::Type::Mark3D
+            || command.type == ListCommand::Type::SubCall;
+        return;
+    }
+    if (m_retainLayer) {
+        m_layerCommands.push_back(command);
+    }
+    if (m_heldBack.empty() && reserveListPosition()) {
+        writeCommand(command);
+    }
+    else {
+        m_heldBack.push_back(command);
+    }
+}
+
+void ListHandler::writeCommand(const ListCommand& cmd) {
+    switch (cmd.type) {
+    case ListCommand::Type::Jump:
+        RTC6_LOG_TRACE(LogEvent::ApiJumpAbs, cmd.x, cmd.y);
+        m_rtcApi.api_jump_abs(cmd.x, cmd.y);
+        break;
+    case ListCommand::Type::Mark:
+        RTC6_LOG_TRACE(LogEvent::ApiMarkAbs, cmd.x, cmd.y);
+        m_rtcApi.api_mark_abs(cmd.x, cmd.y);
+        break;
+    case ListCommand::Type::Jump3D:
+        RTC6_LOG_TRACE(LogEvent::ApiJumpAbs3D, cmd.x, cmd.y, cmd.z);
+        m_rtcApi.api_jump_abs_3d(cmd.x, cmd.y, cmd.z);
+        break;
+    case ListCommand::Type::Mark3D:
+        RTC6_LOG_TRACE(LogEvent::ApiMarkAbs3D, cmd.x, cmd.y, cmd.z);
+        m_rtcApi.api_mark_abs_3d(cmd.x, cmd.y, cmd.z);
+        break;
+    case ListCommand::Type::LaserOn:
+        RTC6_LOG_TRACE(LogEvent::ApiLaserOnList, cmd.x);
+        m_rtcApi.api_laser_on_list(static_cast<UINT>(cmd.x));
+        break;
+    case ListCommand::Type::SetFocusOffset:
+        RTC6_LOG_TRACE(LogEvent::ApiSetDefocusList, cmd.x);
+        m_rtcApi.api_set_defocus_list(cmd.x);
+        break;
+    case ListCommand::Type::SetMarkSpeed: {
+        const double speed_bits_per_ms = speedToBitsPerMs(cmd.value);
+        RTC6_LOG_TRACE(LogEvent::MarkSpeedAdded, speed_bits_per_ms, cmd.value);
+        RTC6_LOG_TRACE(LogEvent::ApiSetMarkSpeed, speed_bits_per_ms);
+        m_rtcApi.api_set_mark_speed(speed_bits_per_ms);
+        break;
+    }
+    case ListCommand::Type::SetLaserPower:
+        RTC6_LOG_TRACE(LogEvent::ApiSetLaserPower, cmd.x, cmd.y);
+        m_rtcApi.api_set_laser_power(static_cast<UINT>(cmd.x), static_cast<UINT>(cmd.y));
+        break;
+    case ListCommand::Type::SetJumpSpeed: {
+        const double speed_bits_per_ms = speedToBitsPerMs(cmd.value);
+        RTC6_LOG_TRACE(LogEvent::ApiSetJumpSpeed, speed_bits_per_ms);
+        m_rtcApi.api_set_jump_speed(speed_bits_per_ms);
+        break;
+    }
+    case ListCommand::Type::SetScannerDelays:
+        RTC6_LOG_TRACE(LogEvent::ApiSetScannerDelays, cmd.x, cmd.y, cmd.z);
+        m_rtcApi.api_set_scanner_delays(static_cast<UINT>(cmd.x), static_cast<UINT>(cmd.y), static_cast<UINT>(cmd.z));
+        break;
+    case ListCommand::Type::SetLaserDelays:
+        RTC6_LOG_TRACE(LogEvent::ApiSetLaserDelays, cmd.x, cmd.y);
+        m_rtcApi.api_set_laser_delays(cmd.x, static_cast<UINT>(cmd.y));
+        break;
+    case ListCommand::Type::SetSkyWritingMode:
+        RTC6_LOG_TRACE(LogEvent::ApiSetSkyWritingMode, cmd.x);
+        m_rtcApi.api_set_sky_writing_mode(static_cast<UINT>(cmd.x));
+        break;
+    case ListCommand::Type::SetSkyWritingParams:
+        RTC6_LOG_TRACE(LogEvent::ApiSetSkyWritingPara, cmd.value, cmd.x, cmd.y, cmd.z);
+        m_rtcApi.api_set_sky_writing_para(cmd.value, cmd.x, static_cast<UINT>(cmd.y), static_cast<UINT>(cmd.z));
+        break;
+    case ListCommand::Type::SetSkyWritingLimit:
+        RTC6_LOG_TRACE(LogEvent::ApiSetSkyWritingLimit, cmd.value);
+        m_rtcApi.api_set_sky_writing_limit(cmd.value);
+        break;
+    case ListCommand::Type::SetWobbleMode:
+        RTC6_LOG_TRACE(LogEvent::ApiSetWobbelMode, cmd.x, cmd.y, cmd.value, cmd.z);
+        m_rtcApi.api_set_wobbel_mode(static_cast<UINT>(cmd.x), static_cast<UINT>(cmd.y), cmd.value, cmd.z);
+        break;
+    case ListCommand::Type::SetJumpMode:
+        RTC6_LOG_TRACE(LogEvent::ApiSetJumpMode, cmd.x);
+        m_rtcApi.api_set_jump_mode(cmd.x);
+        break;
+    case ListCommand::Type::ListRepeat:
+        RTC6_LOG_TRACE(LogEvent::ApiListRepeat);
+        m_rtcApi.api_list_repeat();
+        break;
+    case ListCommand::Type::ListUntil:
+        RTC6_LOG_TRACE(LogEvent::ApiListUntil, cmd.x);
+        m_rtcApi.api_list_until(static_cast<UINT>(cmd.x));
+        break;
+    case ListCommand::Type::JumpRel:
+        RTC6_LOG_TRACE(LogEvent::ApiJumpRel, cmd.x, cmd.y);
+        m_rtcApi.api_jump_rel(cmd.x, cmd.y);
+        break;
+    case ListCommand::Type::MarkRel:
+        RTC6_LOG_TRACE(LogEvent::ApiMarkRel, cmd.x, cmd.y);
+        m_rtcApi.api_mark_rel(cmd.x, cmd.y);
+        break;
+    case ListCommand::Type::SubCall:
+        RTC6_LOG_TRACE(LogEvent::ApiSubCall, cmd.x);
+        m_rtcApi.api_sub_call(static_cast<UINT>(cmd.x));
+        break;
+    case ListCommand::Type::ShapeBegin:
+    case ListCommand::Type::ShapeEnd:
+        break;
+    }
+}
+
+UINT ListHandler::queryListCapacity() {
+    const UINT space = m_rtcApi.api_get_list_space();
+    Logger::instance().log(LogLevel::Debug, LogEvent::ApiGetListSpace, space);
+    return space > MachineConfig::LIST_RESERVED_POSITIONS ? space - MachineConfig::LIST_RESERVED_POSITIONS : 0;
+}
+
+// The board reports free positions only for a list that was just started, and a command
+// can take more than one position, so how much of the list is used is read back from the
+// input pointer.
+void ListHandler::startListFill(UINT listId) {
+    Logger::instance().log(LogLevel::Debug, LogEvent::ApiSetStartList, listId);
+    m_rtcApi.api_set_start_list(listId);
+    m_listCapacity = queryListCapacity();
+    m_listStartPointer = readInputPointer();
+    m_listWriteBudget = commandsThatFit(m_listCapacity);
+    m_listClosed = false;
+}
+
+UINT ListHandler::readInputPointer() {
+    const UINT pointer = m_rtcApi.api_get_input_pointer();
+    Logger::instance().log(LogLevel::Debug, LogEvent::ApiGetInputPointer, pointer);
+    return pointer;
+}
+
+UINT ListHandler::readListPositionsUsed() {
+    return readInputPointer() - m_listStartPointer;
+}
+
+// Rounded up: if the last command takes more positions than assumed, the reserve holds it.
+UINT ListHandler::commandsThatFit(UINT positions) {
+    return positions / MAX_POSITIONS_PER_COMMAND + (positions % MAX_POSITIONS_PER_COMMAND != 0 ? 1 : 0);
+}
+
+// The input pointer is only read once the commands written since the last read could have
+// used up the list, so most commands are written without asking the board.
+bool ListHandler::hasListRoomFor(size_t commands) {
+    if (m_listClosed) {
+        return false;
+    }
+    if (m_listWriteBudget < commands) {
+        const UINT used = readListPositionsUsed();
+        m_listWriteBudget = commandsThatFit(used < m_listCapacity ? m_listCapacity - used : 0);
+    }
+    return m_listWriteBudget >= commands;
+}
+
+bool ListHandler::reserveListPosition() {
+    if (!hasListRoomFor(1)) {
+        return false;
+    }
+    --m_listWriteBudget;
+    return true;
+}
+
+// Runs after the layer's first list was started.
+void ListHandler::streamHeldBackCommands() {
+    streamCommands(m_heldBack);
+    m_heldBack.clear();
+}
+
+// Each chunk is loaded into the idle list while the other one executes and chained behind
+// it with auto_change, so the board moves from chunk to chunk without waiting for the host.
+void ListHandler::streamCommands(const std::vector<ListCommand>& commands) {
+    size_t next = 0;
+    while (next < commands.size()) {
+        const UINT listId = m_currentListIdForFilling;
+        waitForListCompletion(listId);
+
+        startListFill(listId);
+        const size_t first = next;
+        while (next < commands.size()) {
+            // A loop must start and end in the same list.
+            if (commands[next].type == ListCommand::Type::ListRepeat) {
+                size_t loopEnd = next + 1;
+                while (loopEnd < commands.size() && commands[loopEnd].type != ListCommand::Type::ListUntil) {
+                    ++loopEnd;
+                }
+                if (!hasListRoomFor(loopEnd - next + 1)) {
+                    break;
+                }
+            }
+            if (!reserveListPosition()) {
+                break;
+            }
+            writeCommand(commands[next]);
+            ++next;
+        }
+        if (next == first) {
+            const bool loop = commands[first].type == ListCommand::Type::ListRepeat;
+            m_heldBack.clear();
+            throw HardwareError(loop ? "A list loop does not fit into one list."
+                : "No free list memory to stream the remaining commands of the layer.");
+        }
+        Logger::instance().log(LogLevel::Info, LogEvent::ListChunkStreamed, listId, next - first);
+        Logger::instance().log(LogLevel::Debug, LogEvent::ApiSetEndOfList);
+        m_rtcApi.api_set_end_of_list();
+
+        chainAfterRunningList(listId);
+        m_lastExecutedListId = listId;
+        m_currentListIdForExecution = listId;
+        switchFillListTarget();
+    }
+}
+
+// Whether the armed auto_change took effect is read back from the board, never assumed:
+// - a list is busy: the running list is still handing over, or the chained one runs;
+// - all idle, output pointer in the loaded list: it was started and has already ended;
+// - all idle, output pointer still in the old list: that list ended before the arm. The
+//   arm then stays pending on the board and would restart a list after the next one ends,
+//   so it is cancelled with stop_execution, which stops nothing on an idle board, and the
+//   loaded list is started explicitly.
+// The status is read before the output pointer: once both lists read idle, nothing can
+// move the output pointer any more.
+void ListHandler::chainAfterRunningList(UINT listId) {
+    const UINT runningListId = m_currentListIdForExecution;
+    if (isListBusy(runningListId)) {
+        reArmAutoChange();
+        const UINT status = m_rtcApi.api_read_status();
+        if (status & (Rtc6Constants::Status::BUSY1 | Rtc6Constants::Status::BUSY2)) {
+            m_chainedListId = listId;
+            return;
+        }
+        UINT outListId = 0;
+        UINT outPos = 0;
+        m_rtcApi.api_get_out_pointer(outListId, outPos);
+        Logger::instance().log(LogLevel::Debug, LogEvent::ApiGetOutPointer, outListId, outPos);
+        if (outListId == listId) {
+            return;
+        }
+        Logger::instance().log(LogLevel::Warning, LogEvent::StaleAutoChange, runningListId, listId);
+        Logger::instance().log(LogLevel::Debug, LogEvent::ApiStopExecution);
+        m_rtcApi.api_stop_execution();
+    }
+    Logger::instance().log(LogLevel::Debug, LogEvent::ApiExecuteList, listId);
+    m_rtcApi.api_execute_list(listId);
+}
+
+// The list end is only seen by polling, so the hand-over latency recorded is the time
+// between the last busy and the first idle status read; the list ended somewhere in it.
+// Spinning keeps that short for lists about to end, the backoff keeps read_status
+// traffic low for lists that still run for a long time. A list that never ends would
+// hang the job, so the wait gives up after m_listWaitTimeout.
+bool ListHandler::waitForListCompletion(UINT listId) {
+    using Clock = std::chrono::steady_clock;
+    if (!m_communicator.isSuccessfullySetup()) {
+        Logger::instance().log(LogLevel::Warning, LogEvent::ListBusyCheckNotReady);
+        return false;
+    }
+    // A chained list only starts once the list ahead of it ends, so it reads idle until then.
+    bool wasBusy = false;
+    if (listId == m_chainedListId) {
+        m_chainedListId = 0;
+        wasBusy = waitForListCompletion(listId == 1 ? 2 : 1);
+    }
+    if (!isListBusy(listId)) {
+        return wasBusy;
+    }
+
+    auto lastBusy = Clock::now();
+    const auto giveUpAt = lastBusy + m_listWaitTimeout;
+    const auto spinUntil = lastBusy + std::chrono::microseconds(MachineConfig::LIST_WAIT_SPIN_US);
+    auto backoff = std::chrono::microseconds(MachineConfig::LIST_WAIT_MIN_SLEEP_US);
+    const auto maxBackoff = std::chrono::microseconds(MachineConfig::LIST_WAIT_MAX_SLEEP_US);
+    for (;;) {
+        if (Clock::now() < spinUntil) {
+            std::this_thread::yield();
+        }
+        else {
+            std::this_thread::sleep_for(backoff);
+            backoff = std::min(backoff * 2, maxBackoff);
+        }
+        const bool busy = isListBusy(listId);
+        const auto now = Clock::now();
+        if (!busy) {
+            m_handoverLatency.record(std::chrono::duration<double, std::micro>(now - lastBusy).count());
+            return true;
+        }
+        if (now >= giveUpAt) {
+            throw HardwareError("List " + std::to_string(listId) + " did not finish within "
+                + std::to_string(m_listWaitTimeout.count()) + " ms.");
+        }
+        lastBusy = now;
+    }
+}
+
+LatencyHistogram ListHandler::getHandoverLatency() const {
+    return m_handoverLatency;
 }
 
 // Implements the core "ping-pong" logic by flipping the target buffer.
 void ListHandler::switchFillListTarget() {
     m_currentListIdForFilling = (m_currentListIdForFilling == 1) ? 2 : 1;
-    std::cout << "[ListHandler] Switched internal fill target. Next list to fill: List " << m_currentListIdForFilling << std::endl;
+    Logger::instance().log(LogLevel::Debug, LogEvent::FillTargetSwitched, m_currentListIdForFilling);
 }
 
-// Private helper to convert from physical units (mm) to hardware units (bits).
-int ListHandler::mmToBits(double mm) const {
-    static constexpr double BITS_PER_MM = 1000.0;
-    return static_cast<int>(std::round(mm * BITS_PER_MM));
+double ListHandler::speedToBitsPerMs(double speed_mm_s) {
+    return speed_mm_s * MachineConfig::MM_TO_BITS_CONVERSION_FACTOR / 1000.0;
 }
\ No newline at end of file
@@ -1,8 +1,13 @@
 #pragma once
 
+#include "CommandBuffer.h"
 #include "InterfaceCommunicator.h"
 #include "InterfaceListHandler.h"
 #include "InterfaceRtcApi.h"
+#include "SubroutineLibrary.h"
+#include <array>
+#include <chrono>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -13,6 +18,20 @@
 // Encapsulates all logic related to creating, managing, and executing RTC6
 // command lists. It provides a simplified interface for common list operations
 // and handles the complexities of the ping-pong buffering (auto-change) workflow.
+//
+// A list only holds as many commands as the board's list memory allows. Commands
+// that do not fit into the list being prepared are held back on the host and
+// streamed into the two lists in chunks once the layer is executed.
+//
+// Parameter commands (speeds, delays, power, focus) are only written when they
+// change the value already set in the current list; a repeat is dropped.
+//
+// The board cannot run a list loop across two lists, so a loop is collected on the
+// host and kept together in one list or chunk. A loop larger than a list is written
+// out pass by pass instead.
+//
+// With subroutine instancing, a shape seen a second time, translated, is loaded into
+// the board's subroutine memory and called from then on, in this and later layers.
 // -----------------------------------------------------------------------------
 class ListHandler : public InterfaceListHandler{
 public:
@@ -25,15 +44,51 @@ public:
     bool beginListPreparation() override;
     void endListPreparation() override;
     bool executeCurrentListAndCycle() override;
+    void retainLayerForRepeat(bool retain) override;
+    // A layer that fit into one list is started again as it is; a chunked layer is streamed
+    // again from the retained commands, chained behind the running pass.
+    bool repeatLastLayer() override;
     bool isListBusy(UINT listIdToCheck) const override;
+    // Spins briefly, then polls with exponential backoff, recording the hand-over latency.
+    bool waitForListCompletion(UINT listId) override;
+    LatencyHistogram getHandoverLatency() const override;
     UINT getCurrentFillListId() const override;
+    // Number of list commands added since the last beginListPreparation().
+    UINT getListCommandCount() const override;
+    // Modelled execution time of the commands added since the last beginListPreparation().
+    ScanTimeEstimate getListTimeEstimate() const override;
     void addJumpAbsolute(INT x, INT y) override;
     void addMarkAbsolute(INT x, INT y) override;
+    void addJumpAbsolute3D(INT x, INT y, INT z) override;
+    void addMarkAbsolute3D(INT x, INT y, INT z) override;
+    void addLaserOn(UINT period_10us) override;
     void addSetFocusOffset(INT offset_bits) override;
     void addSetMarkSpeed(double speed_mm_s) override;
     void addSetLaserPower(UINT port, UINT power) override;
+    void addSetJumpSpeed(double speed_mm_s) override;
+    void addSetScannerDelays(UINT jump_10us, UINT mark_10us, UINT polygon_10us) override;
+    void addSetLaserDelays(INT laserOn_64thUs, UINT laserOff_64thUs) override;
+    void addSetSkyWritingMode(UINT mode) override;
+    void addSetSkyWritingParams(double timelagUs, INT laserOnShift_64thUs, UINT nPrev_10us, UINT nPost_10us) override;
+    void addSetSkyWritingLimit(double cosAngle) override;
+    void addSetWobbleMode(UINT transversal_bits, UINT longitudinal_bits, double freqHz, INT mode) override;
+    void addListRepeat() override;
+    void addListUntil(UINT passes) override;
+    void beginShape() override;
+    // Writes the shape out, or calls it as a subroutine after an absolute jump to its start.
+    void endShape() override;
     UINT getLastExecutedListId() const override;
 
+    // Jumps at least this long run in jump mode, shorter ones in normal mode. 0 never
+    // switches the jump mode. Defaults to MachineConfig::JUMP_MODE_MIN_LENGTH_MM when
+    // MachineConfig::USE_JUMP_MODE is set.
+    void setJumpModeMinLength(double lengthMm);
+
+    // Defaults to MachineConfig::USE_SUBROUTINE_INSTANCING.
+    void setSubroutineInstancing(bool enabled);
+
+    // Defaults to MachineConfig::LIST_WAIT_TIMEOUT_MS.
+    void setListWaitTimeout(std::chrono::milliseconds timeout);
 
 private:
     friend class ListHandler_InteractionTest;
@@ -47,7 +102,77 @@ private:
     // Toggles the internal target list ID between 1 and 2 for ping-pong buffering.
     void switchFillListTarget();
 
-    // Private unit conversion for internal use.
-    int mmToBits(double mm) const;
+    // Writes a command into the list being filled, or holds it back if that list is full.
+    void submit(const ListCommand& command);
+    // Submits a parameter command unless it repeats the active value. Returns true if submitted.
+    bool submitParameter(const ListCommand& command);
+    // Issues the RTC6 API call for one command.
+    void writeCommand(const ListCommand& command);
+    // Free positions in the list just started with set_start_list, minus the reserve.
+    UINT queryListCapacity();
+    // Starts filling a list with set_start_list and reads how much of it is free.
+    void startListFill(UINT listId);
+    UINT readInputPointer();
+    // Positions written into the list being filled, from the board's input pointer.
+    UINT readListPositionsUsed();
+    // Commands that fit into the given positions, for commands of up to MAX_POSITIONS_PER_COMMAND.
+    static UINT commandsThatFit(UINT positions);
+    // Whether that many more commands fit into the list being filled.
+    bool hasListRoomFor(size_t commands);
+    // Takes one command's room in the list being filled. Returns false if the list is full.
+    bool reserveListPosition();
+    // Loads and executes the held-back commands chunk by chunk, alternating lists.
+    void streamHeldBackCommands();
+    // Loads the commands chunk by chunk into the lists, each chained behind the one running.
+    void streamCommands(const std::vector<ListCommand>& commands);
+    // Starts a loaded list the moment the running list ends (auto_change), or now if none runs.
+    void chainAfterRunningList(UINT listId);
+    // Switches the jump mode for a jump from the last scanner position to (x, y) if needed.
+    void selectJumpMode(INT x, INT y);
+    // Sets the jump mode of a loop body's first jump for every pass, not only the first.
+    void selectLoopEntryJumpMode();
+    // Loads the shape's relative moves as a subroutine, then resumes filling the list.
+    void loadSubroutine(UINT index, const std::vector<ListCommand>& moves);
+    // The speed unit of set_mark_speed / set_jump_speed for a speed in mm/s.
+    static double speedToBitsPerMs(double speed_mm_s);
+
     UINT m_lastExecutedListId;
+    UINT m_listCommandCount;
+    UINT m_chainedListId;                    // List armed with auto_change that may not have started yet.
+    ScanTimeEstimator m_timeEstimator;
+    double m_jumpModeMinLengthBits;          // 0 leaves the jump mode alone.
+    INT m_lastX = 0;                         // Scanner position after the last jump or mark added.
+    INT m_lastY = 0;
+    // A command can take more than one list position on the board.
+    static constexpr UINT MAX_POSITIONS_PER_COMMAND = 2;
+    UINT m_listCapacity;                     // Positions of a whole list, minus the reserve.
+    UINT m_listStartPointer = 0;             // Input pointer when the list being filled was started.
+    UINT m_listWriteBudget;                  // Commands that fit before the input pointer is read again.
+    bool m_listClosed = false;               // The rest of the layer goes into the next chunk.
+    bool m_inLoop = false;
+    std::vector<ListCommand> m_loopBody;     // Commands since addListRepeat(), not yet submitted.
+    bool m_loopHasMoved = false;             // The loop body has a jump, mark or subroutine call.
+    // The loop body's first move, if it is a jump, and the SetJumpMode written for it.
+    struct LoopEntryJump {
+        size_t jumpModeIndex;                // In m_loopBody.
+        INT x;
+        INT y;
+        double lengthBeforeLoop;             // From the scanner position at addListRepeat().
+    };
+    std::optional<LoopEntryJump> m_loopEntryJump;
+    std::vector<ListCommand> m_heldBack;     // Commands of this layer that did not fit into the list.
+    bool m_retainLayer = false;
+    bool m_lastLayerChunked = false;
+    std::vector<ListCommand> m_layerCommands; // The whole layer, while m_retainLayer is set.
+    LatencyHistogram m_handoverLatency;
+    std::chrono::milliseconds m_listWaitTimeout;
+    bool m_useSubroutines;
+    SubroutineLibrary m_subroutines;
+    bool m_inShape = false;
+    std::vector<ListCommand> m_shape;        // Absolute moves since beginShape(), not yet submitted.
+    // The last parameter command of each type written since beginListPreparation(),
+    // indexed by ListCommand::Type.
+    std::array<std::optional<ListCommand>, 32> m_activeParameters;
+    // m_activeParameters at addListRepeat(), for the types the loop body leaves alone.
+    std::array<std::optional<ListCommand>, 32> m_parametersBeforeLoop;
 };
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief A bounded lock-free multi-producer queue with a fixed power-of-two capacity.
+ *
+ * Each slot carries a sequence number that tells producers and the consumer whose
+ * turn it is, so a push or pop is one compare-and-swap (push only) plus one release
+ * store, and never blocks or allocates. When the buffer is full, tryPush() fails
+ * immediately instead of waiting for the consumer.
+ *
+ * Any number of threads may push; tryPop() must only be called from one thread.
+ */
+template <typename T>
+class LockFreeRingBuffer {
+public:
+    /**
+     * @param capacity Number of slots; rounded up to the next power of two.
+     */
+    explicit LockFreeRingBuffer(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        m_mask = size - 1;
+        m_cells = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LockFreeRingBuffer(const LockFreeRingBuffer&) = delete;
+    LockFreeRingBuffer& operator=(const LockFreeRingBuffer&) = delete;
+
+    size_t capacity() const { return m_mask + 1; }
+
+    bool tryPush(const T& value) {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (diff < 0) {
+                return false; // Full.
+            }
+            else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = value;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& out) {
+        Cell* cell = &m_cells[m_dequeuePos & m_mask];
+        const size_t seq = cell->sequence.load(std::memory_order_acquire);
+        if (seq != m_dequeuePos + 1) {
+            return false; // Empty, or the next producer has not finished writing yet.
+        }
+        out = cell->value;
+        cell->sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+        ++m_dequeuePos;
+        return true;
+    }
+
+    // Number of slots claimed by producers so far (including ones still being written).
+    size_t pushedCount() const { return m_enqueuePos.load(std::memory_order_acquire); }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask = 0;
+    // Producers and the consumer touch different counters; keep them on separate cache lines.
+    alignas(64) std::atomic<size_t> m_enqueuePos{ 0 };
+    alignas(64) size_t m_dequeuePos = 0;
+};
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "LogEvents.h"
+
+void formatLogEvent(LogEvent event, const LogArg* a, std::ostream& out) {
+    switch (event) {
+    case LogEvent::ListHandlerCreated:
+        out << "[ListHandler] Instance created. Default fill target: List 1."; break;
+    case LogEvent::AutoChangeNotReady:
+        out << "[ListHandler] Cannot setup auto-change, Rtc6Communicator not ready."; break;
+    case LogEvent::AutoChangeArmed:
+        out << "[ListHandler] Arming initial auto-change."; break;
+    case LogEvent::AutoChangeReArmed:
+        out << "[ListHandler] Re-arming auto-change for the next list transition."; break;
+    case LogEvent::ListPreparationNotReady:
+        out << "[ListHandler] Cannot begin list preparation, Rtc6Communicator not ready."; break;
+    case LogEvent::ListPreparationBegin:
+        out << "[ListHandler] Beginning preparation for List " << a[0].i; break;
+    case LogEvent::ListPreparationEnd:
+        out << "[ListHandler] Ending preparation for List " << a[0].i; break;
+    case LogEvent::ListExecuteNotReady:
+        out << "[ListHandler] Cannot execute list, Rtc6Communicator not ready."; break;
+    case LogEvent::ListExecute:
+        out << "[ListHandler] Commanding execution of List " << a[0].i; break;
+    case LogEvent::ListBusyCheckNotReady:
+        out << "[ListHandler] Communicator not ready; assuming list is busy."; break;
+    case LogEvent::ListBusyCheckInvalidId:
+        out << "[ListHandler] Invalid listId " << a[0].i << " for isListBusy check."; break;
+    case LogEvent::FillTargetSwitched:
+        out << "[ListHandler] Switched internal fill target. Next list to fill: List " << a[0].i; break;
+    case LogEvent::MarkSpeedAdded:
+        out << "[ListHandler] Adding set_mark_speed: " << a[0].d << " bits/ms (" << a[1].d << " mm/s)"; break;
+    case LogEvent::ListFull:
+        out << "[ListHandler] List " << a[0].i << " is full; " << a[1].i << " command(s) held back for streaming."; break;
+    case LogEvent::ListChunkStreamed:
+        out << "[ListHandler] Streamed " << a[1].i << " command(s) into List " << a[0].i << "."; break;
+    case LogEvent::ListRepeat:
+        out << "[ListHandler] Executing the loaded List " << a[0].i << " again to repeat the layer."; break;
+    case LogEvent::LayerRestream:
+        out << "[ListHandler] Streaming the chunked layer again: " << a[0].i << " command(s)."; break;
+    case LogEvent::LayerRepeatUnavailable:
+        out << "[ListHandler] Cannot repeat the layer: it was chunked and its commands were not retained."; break;
+    case LogEvent::LoopUnrolled:
+        out << "[ListHandler] A loop of " << a[0].i << " command(s) does not fit into one list; writing it out " << a[1].i << " times."; break;
+    case LogEvent::StaleAutoChange:
+        out << "[ListHandler] List " << a[0].i << " ended before auto-change was armed; cancelling it and starting list " << a[1].i << " directly."; break;
+    case LogEvent::SubroutineLoaded:
+        out << "[ListHandler] Loaded a repeated shape of " << a[1].i << " move(s) as subroutine " << a[0].i << "."; break;
+    case LogEvent::SubroutineLibraryFull:
+        out << "[ListHandler] Subroutine memory is full (" << a[1].i << " subroutine(s), " << a[2].i
+            << " position(s)); " << a[0].i << " repeated shape(s) of this layer were written out instead."; break;
+
+    case LogEvent::ApiAutoChange:
+        out << "  [API CALL] api_auto_change()"; break;
+    case LogEvent::ApiSetStartList:
+        out << "  [API CALL] api_set_start_list(list_id=" << a[0].i << ")"; break;
+    case LogEvent::ApiSetEndOfList:
+        out << "  [API CALL] api_set_end_of_list()"; break;
+    case LogEvent::ApiExecuteList:
+        out << "  [API CALL] api_execute_list(list_id=" << a[0].i << ")"; break;
+    case LogEvent::ApiGetListSpace:
+        out << "  [API CALL] api_get_list_space() -> " << a[0].i; break;
+    case LogEvent::ApiJumpAbs:
+        out << "  [API CALL] api_jump_abs(x=" << a[0].i << ", y=" << a[1].i << ")"; break;
+    case LogEvent::ApiMarkAbs:
+        out << "  [API CALL] api_mark_abs(x=" << a[0].i << ", y=" << a[1].i << ")"; break;
+    case LogEvent::ApiJumpAbs3D:
+        out << "  [API CALL] api_jump_abs_3d(x=" << a[0].i << ", y=" << a[1].i << ", z=" << a[2].i << ")"; break;
+    case LogEvent::ApiMarkAbs3D:
+        out << "  [API CALL] api_mark_abs_3d(x=" << a[0].i << ", y=" << a[1].i << ", z=" << a[2].i << ")"; break;
+    case LogEvent::ApiLaserOnList:
+        out << "  [API CALL] api_laser_on_list(period=" << a[0].i << ")"; break;
+    case LogEvent::ApiSetDefocusList:
+        out << "  [API CALL] api_set_defocus_list(offset=" << a[0].i << ")"; break;
+    case LogEvent::ApiSetMarkSpeed:
+        out << "  [API CALL] api_set_mark_speed(speed=" << a[0].d << ")"; break;
+    case LogEvent::ApiSetLaserPower:
+        out << "  [API CALL] api_set_laser_power(port=" << a[0].i << ", power=" << a[1].i << ")"; break;
+    case LogEvent::ApiSetJumpSpeed:
+        out << "  [API CALL] api_set_jump_speed(speed=" << a[0].d << ")"; break;
+    case LogEvent::ApiSetScannerDelays:
+        out << "  [API CALL] api_set_scanner_delays(jump=" << a[0].i << ", mark=" << a[1].i << ", polygon=" << a[2].i << ")"; break;
+    case LogEvent::ApiSetLaserDelays:
+        out << "  [API CALL] api_set_laser_delays(on=" << a[0].i << ", off=" << a[1].i << ")"; break;
+    case LogEvent::ApiSetSkyWritingMode:
+        out << "  [API CALL] api_set_sky_writing_mode(mode=" << a[0].i << ")"; break;
+    case LogEvent::ApiSetSkyWritingPara:
+        out << "  [API CALL] api_set_sky_writing_para(timelag=" << a[0].d << ", laser_on_shift=" << a[1].i
+            << ", nprev=" << a[2].i << ", npost=" << a[3].i << ")"; break;
+    case LogEvent::ApiSetSkyWritingLimit:
+        out << "  [API CALL] api_set_sky_writing_limit(cos_angle=" << a[0].d << ")"; break;
+    case LogEvent::ApiSetWobbelMode:
+        out << "  [API CALL] api_set_wobbel_mode(trans=" << a[0].i << ", long=" << a[1].i
+            << ", freq=" << a[2].d << ", mode=" << a[3].i << ")"; break;
+    case LogEvent::ApiSetJumpMode:
+        out << "  [API CALL] api_set_jump_mode(flag=" << a[0].i << ")"; break;
+    case LogEvent::ApiListRepeat:
+        out << "  [API CALL] api_list_repeat()"; break;
+    case LogEvent::ApiListUntil:
+        out << "  [API CALL] api_list_until(number=" << a[0].i << ")"; break;
+    case LogEvent::ApiJumpRel:
+        out << "  [API CALL] api_jump_rel(dx=" << a[0].i << ", dy=" << a[1].i << ")"; break;
+    case LogEvent::ApiMarkRel:
+        out << "  [API CALL] api_mark_rel(dx=" << a[0].i << ", dy=" << a[1].i << ")"; break;
+    case LogEvent::ApiLoadSub:
+        out << "  [API CALL] api_load_sub(index=" << a[0].i << ")"; break;
+    case LogEvent::ApiListReturn:
+        out << "  [API CALL] api_list_return()"; break;
+    case LogEvent::ApiSubCall:
+        out << "  [API CALL] api_sub_call(index=" << a[0].i << ")"; break;
+    case LogEvent::ApiLoadList:
+        out << "  [API CALL] api_load_list(list=" << a[0].i << ", pos=" << a[1].i << ")"; break;
+    case LogEvent::ApiStopExecution:
+        out << "  [API CALL] api_stop_execution()"; break;
+    case LogEvent::ApiGetOutPointer:
+        out << "  [API CALL] api_get_out_pointer() -> list " << a[0].i << ", pos " << a[1].i; break;
+    case LogEvent::ApiGetInputPointer:
+        out << "  [API CALL] api_get_input_pointer() -> " << a[0].i; break;
+
+    case LogEvent::GeometryHandlerCreated:
+        out << "[GeometryHandler] Instance created."; break;
+    case LogEvent::ParallelGeometryHandlerCreated:
+        out << "[ParallelGeometryHandler] Instance created with " << a[0].i << " compile thread(s)."; break;
+    case LogEvent::FieldClipped:
+        out << "[GeometryHandler] Clipped a vector block to the scan field; " << a[0].i << " point(s) lie outside it."; break;
+
+    default:
+        out << "[Logger] Unknown event " << static_cast<int>(event); break;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <type_traits>
+
+/**
+ * @brief One numeric argument of a structured log record.
+ *
+ * Records are stored in binary form and formatted later on the logger thread, so
+ * arguments are plain numbers. The event's formatter knows which ones are doubles.
+ */
+struct LogArg {
+    union {
+        int64_t i;
+        double d;
+    };
+
+    LogArg() : i(0) {}
+    LogArg(double value) : d(value) {}
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+    LogArg(T value) : i(static_cast<int64_t>(value)) {}
+};
+
+/**
+ * @brief Every structured message the controller can log.
+ *
+ * Adding a message means adding an enumerator here and its text in formatLogEvent().
+ */
+enum class LogEvent : uint16_t {
+    // ListHandler workflow
+    ListHandlerCreated,
+    AutoChangeNotReady,
+    AutoChangeArmed,
+    AutoChangeReArmed,
+    ListPreparationNotReady,
+    ListPreparationBegin,       // list
+    ListPreparationEnd,         // list
+    ListExecuteNotReady,
+    ListExecute,                // list
+    ListBusyCheckNotReady,
+    ListBusyCheckInvalidId,     // list
+    FillTargetSwitched,         // list
+    MarkSpeedAdded,             // bits/ms (d), mm/s (d)
+    ListFull,                   // list, held-back commands
+    ListChunkStreamed,          // list, commands
+    ListRepeat,                 // list
+    LayerRestream,              // commands
+    LayerRepeatUnavailable,
+    LoopUnrolled,               // body commands, passes
+    SubroutineLoaded,           // index, moves
+    SubroutineLibraryFull,      // refused loads, loaded subroutines, used positions
+    StaleAutoChange,            // list that ended first, list started instead
+
+    // RTC6 API calls issued by the ListHandler
+    ApiAutoChange,
+    ApiSetStartList,            // list
+    ApiSetEndOfList,
+    ApiExecuteList,             // list
+    ApiGetListSpace,            // free positions
+    ApiJumpAbs,                 // x, y
+    ApiMarkAbs,                 // x, y
+    ApiJumpAbs3D,               // x, y, z
+    ApiMarkAbs3D,               // x, y, z
+    ApiLaserOnList,             // period
+    ApiSetDefocusList,          // offset
+    ApiSetMarkSpeed,            // speed (d)
+    ApiSetLaserPower,           // port, power
+    ApiSetJumpSpeed,            // speed (d)
+    ApiSetScannerDelays,        // jump, mark, polygon
+    ApiSetLaserDelays,          // on, off
+    ApiSetSkyWritingMode,       // mode
+    ApiSetSkyWritingPara,       // timelag (d), laser-on shift, nprev, npost
+    ApiSetSkyWritingLimit,      // cos angle (d)
+    ApiSetWobbelMode,           // transversal, longitudinal, freq (d), mode
+    ApiSetJumpMode,             // flag
+    ApiListRepeat,
+    ApiListUntil,               // number
+    ApiJumpRel,                 // dx, dy
+    ApiMarkRel,                 // dx, dy
+    ApiLoadSub,                 // index
+    ApiListReturn,
+    ApiSubCall,                 // index
+    ApiLoadList,                // list, position
+    ApiStopExecution,
+    ApiGetOutPointer,           // list, position
+    ApiGetInputPointer,         // position
+
+    // Geometry
+    GeometryHandlerCreated,
+    ParallelGeometryHandlerCreated, // threads
+    FieldClipped,                   // points outside
+};
+
+// Writes the message text of an event (without timestamp or level) to `out`.
+void formatLogEvent(LogEvent event, const LogArg* args, std::ostream& out);
\ No newline at end of file
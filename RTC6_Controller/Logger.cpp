@@ -0,0 +1,106 @@
+#include "Logger.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+    int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    const char* levelName(LogLevel level) {
+        switch (level) {
+        case LogLevel::Trace:   return "TRACE";
+        case LogLevel::Debug:   return "DEBUG";
+        case LogLevel::Info:    return "INFO ";
+        case LogLevel::Warning: return "WARN ";
+        case LogLevel::Error:   return "ERROR";
+        default:                return "     ";
+        }
+    }
+}
+
+Logger& Logger::instance() {
+    static Logger logger(std::cout, std::cerr);
+    return logger;
+}
+
+Logger::Logger(std::ostream& out, std::ostream& err, size_t capacity)
+    : m_out(out),
+    m_err(err),
+    m_buffer(capacity),
+    m_startNs(nowNs()) {
+    m_thread = std::thread(&Logger::consumerLoop, this);
+}
+
+Logger::~Logger() {
+    m_stopping.store(true);
+    m_thread.join();
+}
+
+void Logger::push(Record& record) {
+    record.timestampNs = nowNs();
+    if (!m_buffer.tryPush(record)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Logger::flush() {
+    const size_t target = m_buffer.pushedCount();
+    while (m_written.load(std::memory_order_acquire) < target) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+bool Logger::parseLevel(const std::string& text, LogLevel& out) {
+    if (text == "trace")   { out = LogLevel::Trace;   return true; }
+    if (text == "debug")   { out = LogLevel::Debug;   return true; }
+    if (text == "info")    { out = LogLevel::Info;    return true; }
+    if (text == "warning") { out = LogLevel::Warning; return true; }
+    if (text == "error")   { out = LogLevel::Error;   return true; }
+    if (text == "off")     { out = LogLevel::Off;     return true; }
+    return false;
+}
+
+void Logger::consumerLoop() {
+    for (;;) {
+        const bool wroteAny = drainBatch();
+        if (!wroteAny) {
+            if (m_stopping.load()) {
+                // One last pass for anything pushed while we were checking.
+                while (drainBatch()) {}
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+// Formats everything currently in the buffer and writes it with one flush per stream.
+bool Logger::drainBatch() {
+    std::ostringstream outBatch;
+    std::ostringstream errBatch;
+    size_t count = 0;
+
+    Record record;
+    while (m_buffer.tryPop(record)) {
+        std::ostringstream& target = record.level >= LogLevel::Warning ? errBatch : outBatch;
+        target << std::fixed << std::setprecision(6) << (record.timestampNs - m_startNs) / 1.0e9
+            << ' ' << levelName(record.level) << ' ' << std::defaultfloat;
+        formatLogEvent(record.event, record.args, target);
+        target << '\n';
+        ++count;
+    }
+    if (count == 0) {
+        return false;
+    }
+
+    const std::string outText = outBatch.str();
+    const std::string errText = errBatch.str();
+    if (!outText.empty()) m_out << outText << std::flush;
+    if (!errText.empty()) m_err << errText << std::flush;
+    m_written.fetch_add(count, std::memory_order_release);
+    return true;
+}
\ No newline at end of file
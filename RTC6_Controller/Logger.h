@@ -0,0 +1,108 @@
+#pragma once
+
+#include "LockFreeRingBuffer.h"
+#include "LogEvents.h"
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <thread>
+
+// Compile-time switch for trace-level logging. When 0, RTC6_LOG_TRACE(...) expands to
+// nothing, so per-command trace calls cost nothing at all. Defaults to on in debug
+// builds and off in release builds; define it in the project settings to override.
+#ifndef RTC6_LOG_TRACE_ENABLED
+#ifdef NDEBUG
+#define RTC6_LOG_TRACE_ENABLED 0
+#else
+#define RTC6_LOG_TRACE_ENABLED 1
+#endif
+#endif
+
+#if RTC6_LOG_TRACE_ENABLED
+#define RTC6_LOG_TRACE(...) Logger::instance().log(LogLevel::Trace, __VA_ARGS__)
+#else
+#define RTC6_LOG_TRACE(...) ((void)0)
+#endif
+
+enum class LogLevel : uint8_t {
+    Trace,
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Off
+};
+
+/**
+ * @brief Asynchronous, leveled, structured logger.
+ *
+ * log() only checks the runtime level, takes a timestamp and pushes a fixed-size binary
+ * record (event id plus up to four numeric arguments) into a lock-free ring buffer. A
+ * background thread formats the records and writes them in batches: Warning and Error
+ * go to the error stream, everything else to the output stream. If the buffer is ever
+ * full the record is dropped and counted rather than stalling the caller.
+ */
+class Logger {
+public:
+    static constexpr size_t MAX_ARGS = 4;
+    static constexpr size_t DEFAULT_CAPACITY = 16384;
+
+    // The process-wide logger writing to std::cout / std::cerr.
+    static Logger& instance();
+
+    Logger(std::ostream& out, std::ostream& err, size_t capacity = DEFAULT_CAPACITY);
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    void setLevel(LogLevel level) { m_level.store(level, std::memory_order_relaxed); }
+    LogLevel getLevel() const { return m_level.load(std::memory_order_relaxed); }
+    bool isEnabled(LogLevel level) const { return level >= getLevel() && level != LogLevel::Off; }
+
+    template <typename... Args>
+    void log(LogLevel level, LogEvent event, Args... args) {
+        static_assert(sizeof...(Args) <= MAX_ARGS, "Too many log arguments");
+        if (!isEnabled(level)) return;
+        Record record;
+        record.level = level;
+        record.event = event;
+        LogArg packed[] = { LogArg(args)..., LogArg() };
+        for (size_t i = 0; i < sizeof...(Args); ++i) record.args[i] = packed[i];
+        push(record);
+    }
+
+    /**
+     * @brief Blocks until every record logged before this call has been written.
+     */
+    void flush();
+
+    // Records lost because the ring buffer was full.
+    uint64_t getDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // Parses "trace", "debug", "info", "warning", "error" or "off". Returns false if unknown.
+    static bool parseLevel(const std::string& text, LogLevel& out);
+
+private:
+    struct Record {
+        int64_t timestampNs = 0;
+        LogEvent event = LogEvent::ListHandlerCreated;
+        LogLevel level = LogLevel::Info;
+        LogArg args[MAX_ARGS];
+    };
+
+    void push(Record& record);
+    void consumerLoop();
+    bool drainBatch();
+
+    std::ostream& m_out;
+    std::ostream& m_err;
+    std::atomic<LogLevel> m_level{ LogLevel::Info };
+    LockFreeRingBuffer<Record> m_buffer;
+    std::atomic<uint64_t> m_dropped{ 0 };
+    std::atomic<size_t> m_written{ 0 };
+    std::atomic<bool> m_stopping{ false };
+    int64_t m_startNs;
+    std::thread m_thread;
+};
\ No newline at end of file
@@ -14,10 +14,35 @@ namespace MachineConfig {
     // This is the most important value for geometric accuracy. It must be calibrated.
     constexpr double MM_TO_BITS_CONVERSION_FACTOR = 4000.0;
 
+    // The number of RTC6 z-axis "bits" that correspond to 1 millimeter of focus shift.
+    // Used for 3D vector blocks on heads with a z-axis focus shifter. Depends on the
+    // optics and the z correction table, so it is calibrated separately from x/y.
+    constexpr double Z_MM_TO_BITS_CONVERSION_FACTOR = 4000.0;
+
     // The full path to the SCANLAB-provided field correction file (.ct5).
     // This is essential for correcting lens distortion. Leave empty if not used.
     const std::string RTC6_CORRECTION_FILE_PATH = "C:\\path\\to\\correction\\file"; // Example path
 
+    // Per-axis scale applied to part coordinates before the WorkPlane rotation and offset.
+    // Typically used for shrinkage compensation. 1.0 means no scaling.
+    constexpr double FIELD_SCALE_X = 1.0;
+    constexpr double FIELD_SCALE_Y = 1.0;
+
+    // Optional 2x3 affine calibration matrix { a, b, tx, c, d, ty } in millimeters,
+    // applied after the WorkPlane transform: x' = a*x + b*y + tx, y' = c*x + d*y + ty.
+    // Use it to correct residual skew or offset of the scan field. Identity means disabled.
+    constexpr double CALIBRATION_MATRIX[6] = { 1.0, 0.0, 0.0,
+                                               0.0, 1.0, 0.0 };
+
+
+    // What to do with a vector block that lands outside the RTC6 scan field
+    // (+-2^19 bits) after the layer transform:
+    // Reject - abort the job with a GeometryError (safe default).
+    // Clip   - cut the vectors at the field edge: marks stop where they leave the field and
+    //          resume with a jump where they re-enter; points outside are skipped.
+    enum class OutOfFieldPolicy { Reject, Clip };
+    constexpr OutOfFieldPolicy OUT_OF_FIELD_POLICY = OutOfFieldPolicy::Reject;
+
 
     // --- Laser Power Mapping ---
     // The maximum rated power of the connected laser source in Watts.
@@ -25,6 +50,123 @@ namespace MachineConfig {
     constexpr double MAX_LASER_POWER_W = 400.0;
 
 
+    // --- Short-Vector Filter ---
+    // Hatch segments shorter than minLengthMm are dropped, unless they can first be merged
+    // into a neighbouring collinear hatch that is within mergeToleranceMm. Set minLengthMm
+    // to about the spot size. 0.0 disables the filter for that part area; the filter changes
+    // the scanned geometry, so it is off everywhere until a machine opts in.
+    struct ShortVectorThresholds {
+        double minLengthMm;
+        double mergeToleranceMm;
+    };
+
+    // Indexed by the OVF part area: VOLUME, CONTOUR, TRANSITION_CONTOUR.
+    constexpr ShortVectorThresholds SHORT_VECTOR_THRESHOLDS[3] = {
+        { 0.0, 0.0 },     // VOLUME
+        { 0.0, 0.0 },     // CONTOUR
+        { 0.0, 0.0 }      // TRANSITION_CONTOUR
+    };
+
+    // --- Scanner Timing Model ---
+    // Used only to estimate scan times; these values are not written to the board.
+    // Match them to the jump speed and scanner delays configured on the machine.
+    constexpr double SCANNER_JUMP_SPEED_MM_S = 5000.0;
+    constexpr double SCANNER_JUMP_DELAY_US = 100.0;     // Settling time after every jump.
+    constexpr double SCANNER_MARK_DELAY_US = 50.0;      // Settling time after the last mark before a jump.
+    constexpr double SCANNER_POLYGON_DELAY_US = 20.0;   // Wait between consecutive marks.
+    constexpr double LIST_COMMAND_TIME_US = 10.0;       // Execution time of a non-motion list command.
+
+    // --- Delay Model ---
+    // Manual        - scanner and laser delays come from the MarkingParams of each block
+    //                 and are written to the list whenever they change.
+    // ScanaheadAuto - SCANahead heads only: the board plans the scanner trajectory and
+    //                 derives the delays itself. Rtc6Communicator activates the autodelays
+    //                 at setup and no per-block delay commands are written.
+    enum class DelayModel { Manual, ScanaheadAuto };
+    constexpr DelayModel DELAY_MODEL = DelayModel::Manual;
+
+    // Head and correction table whose SCANahead parameters are activated at setup.
+    constexpr unsigned SCANAHEAD_HEAD_NO = 1;
+    constexpr unsigned SCANAHEAD_TABLE_NO = 1;
+
+    // Effective settling times the scan-time model uses with ScanaheadAuto, in place of
+    // the SCANNER_*_DELAY_US values. Calibrate them against measured layer times.
+    constexpr double SCANAHEAD_JUMP_DELAY_US = 20.0;
+    constexpr double SCANAHEAD_MARK_DELAY_US = 10.0;
+    constexpr double SCANAHEAD_POLYGON_DELAY_US = 2.0;
+
+    // With the Manual delay model, scale the polygon delay with the corner angle: a slight
+    // bend on a tessellated curve waits only a fraction of the delay a sharp corner gets.
+    // Rtc6Communicator enables this on the board at setup (set_delay_mode).
+    constexpr bool USE_VARIABLE_POLYGON_DELAY = false;
+
+    // --- Jump Mode ---
+    // When enabled, Rtc6Communicator loads JUMP_TABLE_PATH at setup, and every jump of at
+    // least JUMP_MODE_MIN_LENGTH_MM runs in the head's jump mode, with its delay taken from
+    // the table and clamped to [JUMP_TABLE_MIN_DELAY_US, JUMP_TABLE_MAX_DELAY_US].
+    constexpr bool USE_JUMP_MODE = false;
+    const std::string JUMP_TABLE_PATH = "C:\\path\\to\\jump\\table"; // Example path
+    constexpr unsigned JUMP_TABLE_MIN_DELAY_US = 10;
+    constexpr unsigned JUMP_TABLE_MAX_DELAY_US = 500;
+    constexpr double JUMP_MODE_MIN_LENGTH_MM = 5.0;
+
+    // Head tuning passed to set_jump_mode at setup: VA1, VA2, VB1, VB2 restore the marking
+    // tuning after a jump, JA1, JA2, JB1, JB2 select the jump tuning. Take them from the
+    // head's documentation; without them set_jump_mode_list switches into an unset tuning.
+    constexpr long JUMP_MODE_MARK_TUNING[4] = { 0, 0, 0, 0 };   // Example values
+    constexpr long JUMP_MODE_JUMP_TUNING[4] = { 0, 0, 0, 0 };   // Example values
+
+    // Scan-time model of a jump in jump mode: travel at JUMP_MODE_SPEED_MM_S, then settle
+    // for JUMP_MODE_DELAY_US. Calibrate them against measured layer times.
+    constexpr double JUMP_MODE_SPEED_MM_S = 15000.0;
+    constexpr double JUMP_MODE_DELAY_US = 60.0;
+
+    // Estimated fixed cost of one extra vector (its jump and mark settling times).
+    // Used to report the time saved by the short-vector filter.
+    constexpr double ESTIMATED_VECTOR_OVERHEAD_US = SCANNER_JUMP_DELAY_US + SCANNER_MARK_DELAY_US;
+
+
+    // --- Host Performance ---
+    // Number of threads used to compile each layer's vector blocks into list commands.
+    // 1 compiles serially on the main thread; 0 uses one thread per hardware core.
+    constexpr unsigned LAYER_COMPILE_THREADS = 0;
+
+    // List positions left unused at the end of every RTC6 list, so set_end_of_list always fits.
+    // Layers with more commands than one list holds are streamed across both lists in chunks.
+    constexpr unsigned LIST_RESERVED_POSITIONS = 8;
+
+    // Waiting for a list to finish: poll read_status back to back for LIST_WAIT_SPIN_US,
+    // then sleep between polls, doubling from LIST_WAIT_MIN_SLEEP_US up to LIST_WAIT_MAX_SLEEP_US.
+    // The maximum sleep bounds how late the host can notice that a list has ended.
+    constexpr unsigned LIST_WAIT_SPIN_US = 200;
+    constexpr unsigned LIST_WAIT_MIN_SLEEP_US = 50;
+    constexpr unsigned LIST_WAIT_MAX_SLEEP_US = 1000;
+    // A list still busy after this long is taken as a stalled board and fails the job with a
+    // HardwareError. It must exceed the scan time of the longest list.
+    constexpr unsigned LIST_WAIT_TIMEOUT_MS = 600000;
+
+
+    // --- Subroutine Instancing ---
+    // When enabled, a line sequence or hatch block whose geometry already appeared elsewhere
+    // in the job, translated by whole bits, is stored once on the board as a subroutine of
+    // relative moves and called after a jump to the copy's start point. Rtc6Communicator then
+    // shrinks both lists to LIST_MEMORY_POSITIONS at setup; the board's remaining list memory
+    // holds the subroutines, of which the host fills at most SUBROUTINE_MEMORY_POSITIONS.
+    // Shapes with fewer than SUBROUTINE_MIN_MOVES moves are cheaper to write out.
+    constexpr bool USE_SUBROUTINE_INSTANCING = false;
+    constexpr unsigned LIST_MEMORY_POSITIONS = 1u << 20;
+    constexpr unsigned SUBROUTINE_MEMORY_POSITIONS = 1u << 20;
+    constexpr unsigned SUBROUTINE_MAX_COUNT = 64;
+    constexpr unsigned SUBROUTINE_MIN_MOVES = 8;
+
+
+    // --- Multi-Laser ---
+    // Number of lasers, each driven by its own RTC6 board. Vector blocks with laser_index i
+    // (0-based) run on board i + 1; every board's list is filled and executed on its own
+    // thread, and a layer ends when all boards are idle. With one laser, laser_index is ignored.
+    constexpr unsigned LASER_COUNT = 1;
+
+
     // --- Physical Process Simulation ---
     // The delay in milliseconds to simulate the powder recoater arm movement.
     // This value is now read from here instead of being hardcoded in PrintController.
@@ -1,6 +1,9 @@
 #include "OvfParser.h"
 #include "Rtc6Exception.h"
+#include "FieldBounds.h"
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
 
 OvfParser::OvfParser() {}
@@ -107,9 +110,65 @@ bool OvfParser::parseWorkPlaneShell(const open_vector_format::WorkPlaneLUT& lut,
 
 bool OvfParser::parseVectorBlocks(const open_vector_format::WorkPlaneLUT& lut, open_vector_format::WorkPlane* out_plane) {
     for (int j = 0; j < lut.vectorblockspositions_size(); ++j) {
-        if (!parseDelimitedMessageAt(out_plane->add_vector_blocks(), lut.vectorblockspositions(j))) {
+        auto* block = out_plane->add_vector_blocks();
+        if (!parseDelimitedMessageAt(block, lut.vectorblockspositions(j))) {
             return false;
         }
+        fillMissingBounds(block);
     }
     return true;
+}
+
+// Fills VectorBlockMetaData::bounds (part coordinates, mm) for blocks written without it.
+void OvfParser::fillMissingBounds(open_vector_format::VectorBlock* block) {
+    if (block->meta_data().has_bounds()) {
+        return;
+    }
+
+    using Block = open_vector_format::VectorBlock;
+    const google::protobuf::RepeatedField<float>* points = nullptr;
+    size_t stride = 2;
+    switch (block->vector_data_case()) {
+    case Block::kLineSequence:          points = &block->line_sequence().points(); break;
+    case Block::kHatches:               points = &block->_hatches().points(); break;
+    case Block::kPointSequence:         points = &block->point_sequence().points(); break;
+    case Block::kLineSequence3D:        points = &block->line_sequence_3d().points(); stride = 3; break;
+    case Block::kHatches3D:             points = &block->hatches_3d().points(); stride = 3; break;
+    case Block::kPointSequence3D:       points = &block->point_sequence_3d().points(); stride = 3; break;
+    case Block::kLineSequenceParaAdapt: points = &block->line_sequence_para_adapt().points_with_paras(); stride = 3; break;
+    case Block::kHatchParaAdapt:        break;
+    default: return;
+    }
+
+    MmBounds b{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+    const auto merge = [&b](const google::protobuf::RepeatedField<float>& values, size_t valueStride) {
+        const size_t pointCount = static_cast<size_t>(values.size()) / valueStride;
+        if (pointCount == 0) {
+            return;
+        }
+        const MmBounds part = FieldBounds::computeMmBounds(values.data(), pointCount, valueStride);
+        b.xMin = std::min(b.xMin, part.xMin);
+        b.yMin = std::min(b.yMin, part.yMin);
+        b.xMax = std::max(b.xMax, part.xMax);
+        b.yMax = std::max(b.yMax, part.yMax);
+    };
+    if (points) {
+        merge(*points, stride);
+    }
+    else {
+        // Every hatch is its own (x, y, parameter) sequence.
+        for (const auto& hatch : block->_hatchparaadapt().hatchaslinesequence()) {
+            merge(hatch.points_with_paras(), 3);
+        }
+    }
+    if (b.isEmpty()) {
+        return;
+    }
+
+    auto* bounds = block->mutable_meta_data()->mutable_bounds();
+    bounds->set_x_min(b.xMin);
+    bounds->set_y_min(b.yMin);
+    bounds->set_x_max(b.xMax);
+    bounds->set_y_max(b.yMax);
 }
\ No newline at end of file
@@ -33,6 +33,7 @@ private:
     // Top-level helpers for getWorkPlane()
     bool parseWorkPlaneShell(const open_vector_format::WorkPlaneLUT& lut, open_vector_format::WorkPlane* out_plane);
     bool parseVectorBlocks(const open_vector_format::WorkPlaneLUT& lut, open_vector_format::WorkPlane* out_plane);
+    void fillMissingBounds(open_vector_format::VectorBlock* block);
 
     // Generic, low-level helpers
     template <typename T>
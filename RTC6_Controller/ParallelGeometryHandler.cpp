@@ -0,0 +1,68 @@
+#include "ParallelGeometryHandler.h"
+#include "Logger.h"
+#include <utility>
+
+ParallelGeometryHandler::ParallelGeometryHandler(InterfaceListHandler& listHandler, unsigned threadCount)
+    : m_listHandler(listHandler),
+    m_pool(threadCount) {
+    for (unsigned i = 0; i < m_pool.size(); ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    Logger::instance().log(LogLevel::Info, LogEvent::ParallelGeometryHandlerCreated, m_pool.size());
+}
+
+ParallelGeometryHandler::~ParallelGeometryHandler() = default;
+
+void ParallelGeometryHandler::beginWorkPlane(const open_vector_format::WorkPlane& workPlane) {
+    for (auto& worker : m_workers) {
+        worker->geometry.beginWorkPlane(workPlane);
+    }
+    m_pendingBlocks.clear();
+}
+
+void ParallelGeometryHandler::processVectorBlock(
+    const open_vector_format::VectorBlock& block,
+    const open_vector_format::MarkingParams& params)
+{
+    m_pendingBlocks.push_back({ &block, &params });
+}
+
+/**
+ * @brief Compiles all blocks queued since beginWorkPlane() and emits them in order.
+ */
+void ParallelGeometryHandler::endWorkPlane() {
+    compilePendingBlocks();
+    emitCompiledBlocks();
+    m_pendingBlocks.clear();
+}
+
+ShortVectorStats ParallelGeometryHandler::getShortVectorStats() const {
+    ShortVectorStats total;
+    for (const auto& worker : m_workers) {
+        total += worker->geometry.getShortVectorStats();
+    }
+    return total;
+}
+
+void ParallelGeometryHandler::compilePendingBlocks() {
+    if (m_compiledBlocks.size() < m_pendingBlocks.size()) {
+        m_compiledBlocks.resize(m_pendingBlocks.size());
+    }
+
+    m_pool.run(m_pendingBlocks.size(), [this](unsigned workerIndex, size_t blockIndex) {
+        Worker& worker = *m_workers[workerIndex];
+        const PendingBlock& pending = m_pendingBlocks[blockIndex];
+
+        worker.recorder.clear();
+        worker.geometry.processVectorBlock(*pending.block, *pending.params);
+        // Swap rather than copy: the slot takes the commands, the recorder takes the
+        // slot's old allocation for reuse.
+        std::swap(m_compiledBlocks[blockIndex], worker.recorder.commands());
+    });
+}
+
+void ParallelGeometryHandler::emitCompiledBlocks() {
+    for (size_t i = 0; i < m_pendingBlocks.size(); ++i) {
+        CommandBuffer::replay(m_compiledBlocks[i], m_listHandler);
+    }
+}
\ No newline at end of file
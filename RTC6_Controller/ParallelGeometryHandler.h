@@ -0,0 +1,76 @@
+#pragma once
+
+#include "InterfaceGeometryHandler.h"
+#include "InterfaceListHandler.h"
+#include "CommandBuffer.h"
+#include "GeometryHandler.h"
+#include "WorkerPool.h"
+#include "open_vector_format.pb.h"
+#include <memory>
+#include <vector>
+
+/**
+ * @brief A geometry handler that compiles a layer's vector blocks on several threads.
+ *
+ * Layer preparation is split into two stages:
+ * 1.  **Compile (parallel):** processVectorBlock() only queues the block. At
+ *     endWorkPlane() every queued block is converted by a per-worker GeometryHandler
+ *     into its own recorded command buffer, on a WorkerPool.
+ * 2.  **Emit (serial):** the buffers are then replayed into the real ListHandler on the
+ *     calling thread, strictly in the original block order.
+ *
+ * Each block is compiled independently (every block sets its own parameters first),
+ * so the commands reaching the ListHandler are identical to those of a plain
+ * GeometryHandler, regardless of thread count or scheduling.
+ *
+ * The queued blocks and parameters are referenced, not copied, so they must stay
+ * alive until endWorkPlane() returns.
+ */
+class ParallelGeometryHandler : public InterfaceGeometryHandler {
+public:
+    /**
+     * @param listHandler The handler that receives the emitted commands.
+     * @param threadCount Number of compile workers, including the calling thread.
+     */
+    ParallelGeometryHandler(InterfaceListHandler& listHandler, unsigned threadCount);
+    ~ParallelGeometryHandler() override;
+
+    void beginWorkPlane(const open_vector_format::WorkPlane& workPlane) override;
+
+    void processVectorBlock(
+        const open_vector_format::VectorBlock& block,
+        const open_vector_format::MarkingParams& params
+    ) override;
+
+    void endWorkPlane() override;
+
+    // Sum of the short-vector statistics of all workers for the current layer.
+    ShortVectorStats getShortVectorStats() const override;
+
+    unsigned getThreadCount() const { return m_pool.size(); }
+
+private:
+    // Per-thread compile state: a GeometryHandler that records into its own buffer.
+    struct Worker {
+        Worker() : geometry(recorder) {}
+        CommandBuffer recorder;
+        GeometryHandler geometry;
+    };
+
+    struct PendingBlock {
+        const open_vector_format::VectorBlock* block;
+        const open_vector_format::MarkingParams* params;
+    };
+
+    void compilePendingBlocks();
+    void emitCompiledBlocks();
+
+    InterfaceListHandler& m_listHandler;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<PendingBlock> m_pendingBlocks;
+    // One recorded command list per pending block, in block order. Kept across
+    // layers so the allocations are reused.
+    std::vector<std::vector<ListCommand>> m_compiledBlocks;
+    // Declared last so its threads are joined before the state they use is destroyed.
+    WorkerPool m_pool;
+};
\ No newline at end of file
@@ -12,4 +12,6 @@
 struct PrintJobConfig {
     std::string ovfFilePath;
     int recoatingDelayMs;
+    // Number of threads used to compile a layer's vector blocks. 1 keeps the serial path.
+    unsigned compileThreadCount = 1;
 };
\ No newline at end of file
@@ -6,6 +6,13 @@
 #include <string>
 #include <bitset>
 
+namespace {
+    // init_rtc6_dll / free_rtc6_dll are process-wide; with one communicator per board the
+    // first one initializes the DLL and the last one releases it. Boards are set up and
+    // torn down on the main thread.
+    unsigned s_dllUsers = 0;
+}
+
 Rtc6Communicator::Rtc6Communicator(UINT boardId)
     : m_boardId(boardId),
     m_selectedCardNo(0),
@@ -18,7 +25,7 @@ Rtc6Communicator::Rtc6Communicator(UINT boardId)
 }
 
 Rtc6Communicator::~Rtc6Communicator() {
-    if (m_isDllInitialized) {
+    if (m_isDllInitialized && --s_dllUsers == 0) {
         std::cout << "[Rtc6Communicator] Releasing RTC6 DLL resources..." << std::endl;
         free_rtc6_dll();
     }
@@ -52,6 +59,14 @@ bool Rtc6Communicator::checkError(const std::string& commandName) const {
 }
 
 bool Rtc6Communicator::initializeDll() {
+    if (m_isDllInitialized) {
+        return true;
+    }
+    if (s_dllUsers > 0) {
+        ++s_dllUsers;
+        m_isDllInitialized = true;
+        return true;
+    }
     std::cout << "\n[Rtc6Communicator] Initializing RTC6 DLL..." << std::endl;
     UINT errorCode = init_rtc6_dll();
     if (errorCode != 0) {
@@ -59,6 +74,7 @@ bool Rtc6Communicator::initializeDll() {
         std::cerr << "       This can be due to missing RTC6DLLx64.dll, driver issues, or licensing problems." << std::endl;
         return false;
     }
+    ++s_dllUsers;
     m_isDllInitialized = true;
     std::cout << "[Rtc6Communicator] RTC6 DLL initialized successfully." << std::endl;
     return true;
@@ -108,7 +124,7 @@ bool Rtc6Communicator::loadFirmware() {
         return false;
     }
     std::cout << "\n[Rtc6Communicator] Loading RTC6 DSP firmware onto board " << m_selectedCardNo << "..." << std::endl;
-    UINT errorCode = load_program_file(nullptr);
+    UINT errorCode = n_load_program_file(m_selectedCardNo, nullptr);
     if (errorCode != 0) {
         checkError("load_program_file", errorCode);
         std::cerr << "       Ensure RTC6OUT.out, RTC6RBF.rbf, RTC6DAT.dat are in the executable directory," << std::endl;
@@ -120,6 +136,92 @@ bool Rtc6Communicator::loadFirmware() {
     return true;
 }
 
+// The SCANahead parameters come with the head's correction table. They are read back
+// and activated unchanged, then the board is told to derive all delays from them.
+bool Rtc6Communicator::activateScanaheadAutodelays() {
+    const UINT headNo = MachineConfig::SCANAHEAD_HEAD_NO;
+    std::cout << "\n[Rtc6Communicator] Activating SCANahead autodelays for head " << headNo << "..." << std::endl;
+    UINT previewTime = 0;
+    UINT vmax = 0;
+    double amax = 0.0;
+    UINT errorCode = n_get_scanahead_params(m_selectedCardNo, headNo, &previewTime, &vmax, &amax);
+    if (errorCode != 0) {
+        checkError("get_scanahead_params", errorCode);
+        std::cerr << "       The head or its correction table has no SCANahead parameters. Use DelayModel::Manual for this machine." << std::endl;
+        return false;
+    }
+    errorCode = n_set_scanahead_params(m_selectedCardNo, 1, headNo, MachineConfig::SCANAHEAD_TABLE_NO, previewTime, vmax, amax);
+    if (errorCode != 0) {
+        checkError("set_scanahead_params", errorCode);
+        return false;
+    }
+    n_activate_scanahead_autodelays(m_selectedCardNo, 1);
+    if (!checkError("activate_scanahead_autodelays")) {
+        return false;
+    }
+    std::cout << "[Rtc6Communicator] SCANahead autodelays active (preview time " << previewTime
+        << ", vmax " << vmax << ", amax " << amax << ")." << std::endl;
+    return true;
+}
+
+// The jump table holds the jump delay as a function of the jump length for the head's
+// jump mode. Delays are passed in 10 us steps. The table goes into slot 1.
+bool Rtc6Communicator::loadJumpTable() {
+    std::cout << "\n[Rtc6Communicator] Loading jump table " << MachineConfig::JUMP_TABLE_PATH << "..." << std::endl;
+    const LONG result = n_load_jump_table(m_selectedCardNo, MachineConfig::JUMP_TABLE_PATH.c_str(), 1, 0,
+        MachineConfig::JUMP_TABLE_MIN_DELAY_US / 10, MachineConfig::JUMP_TABLE_MAX_DELAY_US / 10, 0);
+    if (result != 0) {
+        checkError("load_jump_table", static_cast<UINT>(result));
+        std::cerr << "       Check the jump table path, or set USE_JUMP_MODE to false for this machine." << std::endl;
+        return false;
+    }
+    std::cout << "[Rtc6Communicator] Jump table loaded." << std::endl;
+    return true;
+}
+
+// config_list sets the size of both lists; list memory beyond them is protected and
+// takes the subroutines loaded by the ListHandler.
+bool Rtc6Communicator::configureSubroutineMemory() {
+    std::cout << "\n[Rtc6Communicator] Reserving list memory for subroutines..." << std::endl;
+    n_config_list(m_selectedCardNo, MachineConfig::LIST_MEMORY_POSITIONS, MachineConfig::LIST_MEMORY_POSITIONS);
+    if (!checkError("config_list")) {
+        return false;
+    }
+    std::cout << "[Rtc6Communicator] Lists sized to " << MachineConfig::LIST_MEMORY_POSITIONS
+        << " positions each." << std::endl;
+    return true;
+}
+
+// Flag 0 only stores the tuning and leaves the head in normal mode: the lists switch each
+// long jump into jump mode themselves with set_jump_mode_list.
+bool Rtc6Communicator::configureJumpMode() {
+    std::cout << "\n[Rtc6Communicator] Configuring the head's jump mode tuning..." << std::endl;
+    const long* mark = MachineConfig::JUMP_MODE_MARK_TUNING;
+    const long* jump = MachineConfig::JUMP_MODE_JUMP_TUNING;
+    const UINT lengthBits = static_cast<UINT>(MachineConfig::JUMP_MODE_MIN_LENGTH_MM * MachineConfig::MM_TO_BITS_CONVERSION_FACTOR);
+    const LONG result = n_set_jump_mode(m_selectedCardNo, 0, lengthBits,
+        mark[0], mark[1], mark[2], mark[3], jump[0], jump[1], jump[2], jump[3]);
+    if (result != 0) {
+        checkError("set_jump_mode", static_cast<UINT>(result));
+        std::cerr << "       Check JUMP_MODE_MARK_TUNING and JUMP_MODE_JUMP_TUNING, or set USE_JUMP_MODE to false for this machine." << std::endl;
+        return false;
+    }
+    std::cout << "[Rtc6Communicator] Jump mode tuning set." << std::endl;
+    return true;
+}
+
+// Only VarPoly is switched on. Direct 3D moves, the edge level and the variable jump
+// delay keep their defaults of 0.
+bool Rtc6Communicator::enableVariablePolygonDelay() {
+    std::cout << "\n[Rtc6Communicator] Enabling angle-dependent polygon delay..." << std::endl;
+    n_set_delay_mode(m_selectedCardNo, 1, 0, 0, 0, 0);
+    if (!checkError("set_delay_mode")) {
+        return false;
+    }
+    std::cout << "[Rtc6Communicator] Polygon delay now scales with the corner angle." << std::endl;
+    return true;
+}
+
 bool Rtc6Communicator::connectAndSetupBoard() {
     m_successfullySetup = false;
     if (!initializeDll()) {
@@ -129,6 +231,14 @@ bool Rtc6Communicator::connectAndSetupBoard() {
     if (cardCount == 0) {
         return false;
     }
+    // With several lasers a missing board must not fall back to board 1, which already
+    // belongs to the first laser.
+    if (m_boardId > cardCount && MachineConfig::LASER_COUNT > 1) {
+        std::cerr << "FATAL ERROR: [Rtc6Communicator] Requested board ID " << m_boardId
+            << " is greater than detected card count " << cardCount
+            << ". Every laser needs its own board, please check connections." << std::endl;
+        return false;
+    }
     if (m_boardId > cardCount && cardCount > 0) {
         std::cerr << "WARNING: [Rtc6Communicator] Requested board ID " << m_boardId
             << " is greater than detected card count " << cardCount
@@ -141,6 +251,19 @@ bool Rtc6Communicator::connectAndSetupBoard() {
     if (!loadFirmware()) {
         return false;
     }
+    if (MachineConfig::DELAY_MODEL == MachineConfig::DelayModel::ScanaheadAuto && !activateScanaheadAutodelays()) {
+        return false;
+    }
+    if (MachineConfig::USE_VARIABLE_POLYGON_DELAY && MachineConfig::DELAY_MODEL == MachineConfig::DelayModel::Manual
+        && !enableVariablePolygonDelay()) {
+        return false;
+    }
+    if (MachineConfig::USE_JUMP_MODE && (!loadJumpTable() || !configureJumpMode())) {
+        return false;
+    }
+    if (MachineConfig::USE_SUBROUTINE_INSTANCING && !configureSubroutineMemory()) {
+        return false;
+    }
     std::cout << "\n[Rtc6Communicator] Core board setup successful! Board " << m_selectedCardNo << " is ready for commands." << std::endl;
     m_successfullySetup = true;
     return true;
@@ -169,13 +292,13 @@ void Rtc6Communicator::printBoardVersions() const {
         return;
     }
     std::cout << "\n[Rtc6Communicator] Board " << m_selectedCardNo << " Firmware and BIOS Versions:" << std::endl;
-    UINT rtcVersion = get_rtc_version();
+    UINT rtcVersion = n_get_rtc_version(m_selectedCardNo);
     if (!checkError("get_rtc_version")) {
     }
     else {
         std::cout << "  RTC Firmware Version: " << rtcVersion << std::endl;
     }
-    UINT biosVersion = get_bios_version();
+    UINT biosVersion = n_get_bios_version(m_selectedCardNo);
     if (!checkError("get_bios_version")) {
     }
     else {
@@ -209,7 +332,7 @@ void Rtc6Communicator::checkGlobalErrorStatus() const {
     }
 
     // get_error() returns the ACCUMULATED error register, which persists until cleared.
-    UINT32 accumulatedError = get_error();
+    UINT32 accumulatedError = n_get_error(m_selectedCardNo);
 
     std::cout << "\n[Rtc6Communicator] Checking accumulated RTC6 errors for board context " << m_selectedCardNo << ":" << std::endl;
 
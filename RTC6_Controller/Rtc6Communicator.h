@@ -30,6 +30,11 @@ private:
     UINT countCards();
     bool selectBoard();
     bool loadFirmware();
+    bool activateScanaheadAutodelays();
+    bool loadJumpTable();
+    bool configureJumpMode();
+    bool configureSubroutineMemory();
+    bool enableVariablePolygonDelay();
     bool checkError(const std::string& commandName, UINT rtcError) const;
     bool checkError(const std::string& commandName) const; // Overload to get last error internally
 };
\ No newline at end of file
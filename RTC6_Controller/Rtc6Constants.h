@@ -21,4 +21,17 @@ namespace Rtc6Constants {
         constexpr unsigned int BUSY1 = 1 << 4;  // List 1 is currently executing
         constexpr unsigned int BUSY2 = 1 << 5;  // List 2 is currently executing
     }
+
+    // Time resolution of the list commands that take delays.
+    namespace Units {
+        constexpr double SCANNER_DELAY_US_PER_BIT = 10.0;   // set_scanner_delays: 10 us per bit
+        constexpr double LASER_DELAY_BITS_PER_US = 64.0;    // set_laser_delays: 1/64 us per bit
+    }
+
+    // Shape argument of set_wobbel_mode.
+    namespace Wobbel {
+        constexpr int MODE_ELLIPSE = 0;
+        constexpr int MODE_STANDING_EIGHT = 1;   // Figure eight across the vector direction
+        constexpr int MODE_LYING_EIGHT = -1;     // Figure eight along the vector direction
+    }
 }
\ No newline at end of file
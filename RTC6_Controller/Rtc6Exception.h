@@ -47,4 +47,17 @@ public:
     explicit ConfigurationError(const std::string& message)
         : Rtc6Exception("Configuration Error: " + message) {
     }
+};
+
+
+/**
+ * @brief Thrown when converted geometry cannot be sent to the scanner.
+ *
+ * e.g., A vector block lands outside the RTC6 scan field after the layer transform.
+ */
+class GeometryError : public Rtc6Exception {
+public:
+    explicit GeometryError(const std::string& message)
+        : Rtc6Exception("Geometry Error: " + message) {
+    }
 };
\ No newline at end of file
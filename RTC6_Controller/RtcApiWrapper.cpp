@@ -1,13 +1,36 @@
 #include "RtcApiWrapper.h"
 #include "RTC6impl.h" // The real DLL functions
 
-void RtcApiWrapper::api_auto_change() { auto_change(); }
-void RtcApiWrapper::api_set_start_list(UINT listNo) { set_start_list(listNo); }
-void RtcApiWrapper::api_set_end_of_list() { set_end_of_list(); }
-void RtcApiWrapper::api_execute_list(UINT listNo) { execute_list(listNo); }
-UINT RtcApiWrapper::api_read_status() { return read_status(); }
-void RtcApiWrapper::api_jump_abs(INT x, INT y) { jump_abs(x, y); }
-void RtcApiWrapper::api_mark_abs(INT x, INT y) { mark_abs(x, y); }
-void RtcApiWrapper::api_set_defocus_list(INT offset) { set_defocus_list(offset); }
-void RtcApiWrapper::api_set_mark_speed(double speed) { set_mark_speed(speed); }
-void RtcApiWrapper::api_set_laser_power(UINT port, UINT power) { set_laser_power(port, power); }
\ No newline at end of file
+void RtcApiWrapper::api_auto_change() { n_auto_change(m_cardNo); }
+void RtcApiWrapper::api_set_start_list(UINT listNo) { n_set_start_list(m_cardNo, listNo); }
+void RtcApiWrapper::api_set_end_of_list() { n_set_end_of_list(m_cardNo); }
+void RtcApiWrapper::api_execute_list(UINT listNo) { n_execute_list(m_cardNo, listNo); }
+UINT RtcApiWrapper::api_read_status() { return n_read_status(m_cardNo); }
+UINT RtcApiWrapper::api_get_list_space() { return n_get_list_space(m_cardNo); }
+void RtcApiWrapper::api_jump_abs(INT x, INT y) { n_jump_abs(m_cardNo, x, y); }
+void RtcApiWrapper::api_mark_abs(INT x, INT y) { n_mark_abs(m_cardNo, x, y); }
+void RtcApiWrapper::api_jump_abs_3d(INT x, INT y, INT z) { n_jump_abs_3d(m_cardNo, x, y, z); }
+void RtcApiWrapper::api_mark_abs_3d(INT x, INT y, INT z) { n_mark_abs_3d(m_cardNo, x, y, z); }
+void RtcApiWrapper::api_laser_on_list(UINT period) { n_laser_on_list(m_cardNo, period); }
+void RtcApiWrapper::api_set_defocus_list(INT offset) { n_set_defocus_list(m_cardNo, offset); }
+void RtcApiWrapper::api_set_mark_speed(double speed) { n_set_mark_speed(m_cardNo, speed); }
+void RtcApiWrapper::api_set_laser_power(UINT port, UINT power) { n_set_laser_power(m_cardNo, port, power); }
+void RtcApiWrapper::api_set_jump_speed(double speed) { n_set_jump_speed(m_cardNo, speed); }
+void RtcApiWrapper::api_set_scanner_delays(UINT jump, UINT mark, UINT polygon) { n_set_scanner_delays(m_cardNo, jump, mark, polygon); }
+void RtcApiWrapper::api_set_laser_delays(INT laserOnDelay, UINT laserOffDelay) { n_set_laser_delays(m_cardNo, laserOnDelay, laserOffDelay); }
+void RtcApiWrapper::api_set_sky_writing_mode(UINT mode) { n_set_sky_writing_mode_list(m_cardNo, mode); }
+void RtcApiWrapper::api_set_sky_writing_para(double timelag, INT laserOnShift, UINT nPrev, UINT nPost) { n_set_sky_writing_para_list(m_cardNo, timelag, laserOnShift, nPrev, nPost); }
+void RtcApiWrapper::api_set_sky_writing_limit(double cosAngle) { n_set_sky_writing_limit_list(m_cardNo, cosAngle); }
+void RtcApiWrapper::api_set_wobbel_mode(UINT transversal, UINT longitudinal, double freq, INT mode) { n_set_wobbel_mode(m_cardNo, transversal, longitudinal, freq, mode); }
+void RtcApiWrapper::api_set_jump_mode(INT flag) { n_set_jump_mode_list(m_cardNo, flag); }
+void RtcApiWrapper::api_list_repeat() { n_list_repeat(m_cardNo); }
+void RtcApiWrapper::api_list_until(UINT number) { n_list_until(m_cardNo, number); }
+void RtcApiWrapper::api_jump_rel(INT dx, INT dy) { n_jump_rel(m_cardNo, dx, dy); }
+void RtcApiWrapper::api_mark_rel(INT dx, INT dy) { n_mark_rel(m_cardNo, dx, dy); }
+void RtcApiWrapper::api_load_sub(UINT index) { n_load_sub(m_cardNo, index); }
+void RtcApiWrapper::api_list_return() { n_list_return(m_cardNo); }
+void RtcApiWrapper::api_sub_call(UINT index) { n_sub_call(m_cardNo, index); }
+void RtcApiWrapper::api_load_list(UINT listNo, UINT pos) { n_load_list(m_cardNo, listNo, pos); }
+void RtcApiWrapper::api_stop_execution() { n_stop_execution(m_cardNo); }
+void RtcApiWrapper::api_get_out_pointer(UINT& listNo, UINT& pos) { n_get_out_pointer(m_cardNo, &listNo, &pos); }
+UINT RtcApiWrapper::api_get_input_pointer() { return n_get_input_pointer(m_cardNo); }
\ No newline at end of file
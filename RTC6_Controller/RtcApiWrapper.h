@@ -1,16 +1,50 @@
 #pragma once
 #include "InterfaceRtcApi.h"
 
+/**
+ * @brief InterfaceRtcApi on one RTC6 board of the DLL.
+ *
+ * Every call goes to the n_* function of the board's card number, so several wrappers
+ * can drive several boards at the same time, each from its own thread.
+ */
 class RtcApiWrapper : public InterfaceRtcApi {
 public:
+    explicit RtcApiWrapper(UINT cardNo = 1) : m_cardNo(cardNo) {}
+
     void api_auto_change() override;
     void api_set_start_list(UINT listNo) override;
     void api_set_end_of_list() override;
     void api_execute_list(UINT listNo) override;
     UINT api_read_status() override;
+    UINT api_get_list_space() override;
     void api_jump_abs(INT x, INT y) override;
     void api_mark_abs(INT x, INT y) override;
+    void api_jump_abs_3d(INT x, INT y, INT z) override;
+    void api_mark_abs_3d(INT x, INT y, INT z) override;
+    void api_laser_on_list(UINT period) override;
     void api_set_defocus_list(INT offset) override;
     void api_set_mark_speed(double speed) override;
     void api_set_laser_power(UINT port, UINT power) override;
+    void api_set_jump_speed(double speed) override;
+    void api_set_scanner_delays(UINT jump, UINT mark, UINT polygon) override;
+    void api_set_laser_delays(INT laserOnDelay, UINT laserOffDelay) override;
+    void api_set_sky_writing_mode(UINT mode) override;
+    void api_set_sky_writing_para(double timelag, INT laserOnShift, UINT nPrev, UINT nPost) override;
+    void api_set_sky_writing_limit(double cosAngle) override;
+    void api_set_wobbel_mode(UINT transversal, UINT longitudinal, double freq, INT mode) override;
+    void api_set_jump_mode(INT flag) override;
+    void api_list_repeat() override;
+    void api_list_until(UINT number) override;
+    void api_jump_rel(INT dx, INT dy) override;
+    void api_mark_rel(INT dx, INT dy) override;
+    void api_load_sub(UINT index) override;
+    void api_list_return() override;
+    void api_sub_call(UINT index) override;
+    void api_load_list(UINT listNo, UINT pos) override;
+    void api_stop_execution() override;
+    void api_get_out_pointer(UINT& listNo, UINT& pos) override;
+    UINT api_get_input_pointer() override;
+
+private:
+    UINT m_cardNo;
 };
\ No newline at end of file
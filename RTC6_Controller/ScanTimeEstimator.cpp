@@ -0,0 +1,249 @@
+#include "ScanTimeEstimator.h"
+#include "CommandBuffer.h"
+#include "MachineConfig.h"
+#include "Rtc6Constants.h"
+#include <cmath>
+
+namespace {
+    double bitsToMm(INT bits) {
+        return bits / MachineConfig::MM_TO_BITS_CONVERSION_FACTOR;
+    }
+
+    double zBitsToMm(INT bits) {
+        return bits / MachineConfig::Z_MM_TO_BITS_CONVERSION_FACTOR;
+    }
+}
+
+ScanTimeEstimator::ScanTimeEstimator(MachineConfig::DelayModel delayModel)
+    : m_delayModel(delayModel),
+    m_markSpeedMmS(0.0),
+    m_jumpSpeedMmS(MachineConfig::SCANNER_JUMP_SPEED_MM_S),
+    m_jumpDelayUs(MachineConfig::SCANNER_JUMP_DELAY_US),
+    m_markDelayUs(MachineConfig::SCANNER_MARK_DELAY_US),
+    m_polygonDelayUs(MachineConfig::SCANNER_POLYGON_DELAY_US),
+    m_variablePolygonDelay(MachineConfig::USE_VARIABLE_POLYGON_DELAY && delayModel == MachineConfig::DelayModel::Manual) {
+    if (m_delayModel == MachineConfig::DelayModel::ScanaheadAuto) {
+        m_jumpDelayUs = MachineConfig::SCANAHEAD_JUMP_DELAY_US;
+        m_markDelayUs = MachineConfig::SCANAHEAD_MARK_DELAY_US;
+        m_polygonDelayUs = MachineConfig::SCANAHEAD_POLYGON_DELAY_US;
+    }
+}
+
+void ScanTimeEstimator::reset() {
+    m_totals = ScanTimeEstimate{};
+    m_inMarkSequence = false;
+    m_inRepeat = false;
+}
+
+void ScanTimeEstimator::jumpTo(INT x, INT y) {
+    m_cornerScale = cornerDelayScale(x, y, false);
+    moveTo(bitsToMm(x), bitsToMm(y), m_zMm, false);
+}
+
+void ScanTimeEstimator::markTo(INT x, INT y) {
+    m_cornerScale = cornerDelayScale(x, y, true);
+    moveTo(bitsToMm(x), bitsToMm(y), m_zMm, true);
+}
+
+void ScanTimeEstimator::jumpTo3D(INT x, INT y, INT z) {
+    m_cornerScale = cornerDelayScale(x, y, false);
+    moveTo(bitsToMm(x), bitsToMm(y), zBitsToMm(z), false);
+}
+
+void ScanTimeEstimator::markTo3D(INT x, INT y, INT z) {
+    m_cornerScale = cornerDelayScale(x, y, true);
+    moveTo(bitsToMm(x), bitsToMm(y), zBitsToMm(z), true);
+}
+
+// The corner angle comes from the dot and cross products of the integer direction vectors
+// (exact in 64 bits for any in-field coordinates), so no normalisation is needed.
+double ScanTimeEstimator::cornerDelayScale(INT x, INT y, bool isMark) {
+    const int64_t dx = static_cast<int64_t>(x) - m_xBits;
+    const int64_t dy = static_cast<int64_t>(y) - m_yBits;
+    m_xBits = x;
+    m_yBits = y;
+    if (!isMark) {
+        m_dirX = 0;
+        m_dirY = 0;
+        return 1.0;
+    }
+    if (dx == 0 && dy == 0) {
+        return 1.0;
+    }
+
+    double scale = 1.0;
+    if (m_variablePolygonDelay && (m_dirX != 0 || m_dirY != 0)) {
+        const int64_t dot = m_dirX * dx + m_dirY * dy;
+        const int64_t cross = m_dirX * dy - m_dirY * dx;
+        constexpr double PI = 3.14159265358979323846;
+        scale = std::atan2(std::abs(static_cast<double>(cross)), static_cast<double>(dot)) / PI;
+    }
+    m_dirX = dx;
+    m_dirY = dy;
+    return scale;
+}
+
+void ScanTimeEstimator::laserOn(UINT period_10us) {
+    endMarkSequence();
+    m_totals.markTimeUs += period_10us * 10.0;
+}
+
+void ScanTimeEstimator::setMarkSpeed(double speed_mm_s) {
+    m_markSpeedMmS = speed_mm_s;
+    parameterCommand();
+}
+
+void ScanTimeEstimator::setJumpSpeed(double speed_mm_s) {
+    m_jumpSpeedMmS = speed_mm_s;
+    parameterCommand();
+}
+
+void ScanTimeEstimator::setScannerDelays(double jumpDelayUs, double markDelayUs, double polygonDelayUs) {
+    if (m_delayModel == MachineConfig::DelayModel::ScanaheadAuto) {
+        parameterCommand();
+        return;
+    }
+    m_jumpDelayUs = jumpDelayUs;
+    m_markDelayUs = markDelayUs;
+    m_polygonDelayUs = polygonDelayUs;
+    parameterCommand();
+}
+
+void ScanTimeEstimator::setSkyWritingMode(UINT mode) {
+    m_skyWriting = mode != 0;
+    parameterCommand();
+}
+
+void ScanTimeEstimator::setSkyWritingRunInOut(double runInUs, double runOutUs) {
+    m_skyRunInUs = runInUs;
+    m_skyRunOutUs = runOutUs;
+    parameterCommand();
+}
+
+void ScanTimeEstimator::setJumpMode(bool enabled) {
+    m_jumpMode = enabled;
+    parameterCommand();
+}
+
+void ScanTimeEstimator::parameterCommand() {
+    m_totals.delayTimeUs += MachineConfig::LIST_COMMAND_TIME_US;
+}
+
+void ScanTimeEstimator::beginRepeat() {
+    parameterCommand();
+    m_repeatStart = m_totals;
+    m_inRepeat = true;
+}
+
+// A pass ends with the last mark sequence of the body finished, since the next pass
+// starts with a jump back to the beginning.
+void ScanTimeEstimator::endRepeat(UINT passes) {
+    parameterCommand();
+    if (!m_inRepeat) {
+        return;
+    }
+    m_inRepeat = false;
+    endMarkSequence();
+    const double extraPasses = passes > 1 ? passes - 1.0 : 0.0;
+    m_totals.markTimeUs += (m_totals.markTimeUs - m_repeatStart.markTimeUs) * extraPasses;
+    m_totals.jumpTimeUs += (m_totals.jumpTimeUs - m_repeatStart.jumpTimeUs) * extraPasses;
+    m_totals.delayTimeUs += (m_totals.delayTimeUs - m_repeatStart.delayTimeUs) * extraPasses;
+}
+
+ScanTimeEstimate ScanTimeEstimator::current() const {
+    ScanTimeEstimate result = m_totals;
+    if (m_inMarkSequence) {
+        result.delayTimeUs += m_skyWriting ? m_skyRunOutUs : m_markDelayUs;
+    }
+    return result;
+}
+
+ScanTimeEstimate ScanTimeEstimator::estimate(const std::vector<ListCommand>& commands,
+    MachineConfig::DelayModel delayModel) {
+    ScanTimeEstimator estimator(delayModel);
+    for (const auto& cmd : commands) {
+        estimator.apply(cmd);
+    }
+    return estimator.current();
+}
+
+void ScanTimeEstimator::apply(const ListCommand& cmd) {
+    switch (cmd.type) {
+    case ListCommand::Type::Jump:           jumpTo(cmd.x, cmd.y); break;
+    case ListCommand::Type::Mark:           markTo(cmd.x, cmd.y); break;
+    case ListCommand::Type::Jump3D:         jumpTo3D(cmd.x, cmd.y, cmd.z); break;
+    case ListCommand::Type::Mark3D:         markTo3D(cmd.x, cmd.y, cmd.z); break;
+    case ListCommand::Type::LaserOn:        laserOn(static_cast<UINT>(cmd.x)); break;
+    case ListCommand::Type::SetMarkSpeed:   setMarkSpeed(cmd.value); break;
+    case ListCommand::Type::SetJumpSpeed:   setJumpSpeed(cmd.value); break;
+    case ListCommand::Type::SetScannerDelays: {
+        const double usPerBit = Rtc6Constants::Units::SCANNER_DELAY_US_PER_BIT;
+        setScannerDelays(cmd.x * usPerBit, cmd.y * usPerBit, cmd.z * usPerBit);
+        break;
+    }
+    case ListCommand::Type::SetSkyWritingMode:
+        setSkyWritingMode(static_cast<UINT>(cmd.x));
+        break;
+    case ListCommand::Type::SetSkyWritingParams:
+        setSkyWritingRunInOut(cmd.y * 10.0, cmd.z * 10.0);
+        break;
+    case ListCommand::Type::SetJumpMode:
+        setJumpMode(cmd.x != 0);
+        break;
+    case ListCommand::Type::ListRepeat:
+        beginRepeat();
+        break;
+    case ListCommand::Type::ListUntil:
+        endRepeat(static_cast<UINT>(cmd.x));
+        break;
+    case ListCommand::Type::JumpRel:        jumpTo(m_xBits + cmd.x, m_yBits + cmd.y); break;
+    case ListCommand::Type::MarkRel:        markTo(m_xBits + cmd.x, m_yBits + cmd.y); break;
+    case ListCommand::Type::ShapeBegin:
+    case ListCommand::Type::ShapeEnd:
+        break;
+    default:                                parameterCommand(); break;
+    }
+}
+
+void ScanTimeEstimator::moveTo(double xMm, double yMm, double zMm, bool isMark) {
+    const double distance = std::sqrt((xMm - m_xMm) * (xMm - m_xMm)
+        + (yMm - m_yMm) * (yMm - m_yMm)
+        + (zMm - m_zMm) * (zMm - m_zMm));
+
+    if (isMark) {
+        if (m_inMarkSequence) {
+            m_totals.delayTimeUs += m_polygonDelayUs * m_cornerScale;
+        }
+        else if (m_skyWriting) {
+            m_totals.delayTimeUs += m_skyRunInUs;
+        }
+        if (m_markSpeedMmS > 0.0) {
+            m_totals.markTimeUs += distance / m_markSpeedMmS * 1.0e6;
+        }
+        m_inMarkSequence = true;
+    }
+    else {
+        endMarkSequence();
+        if (m_jumpMode) {
+            m_totals.jumpTimeUs += distance / MachineConfig::JUMP_MODE_SPEED_MM_S * 1.0e6;
+            m_totals.delayTimeUs += MachineConfig::JUMP_MODE_DELAY_US;
+        }
+        else {
+            if (m_jumpSpeedMmS > 0.0) {
+                m_totals.jumpTimeUs += distance / m_jumpSpeedMmS * 1.0e6;
+            }
+            m_totals.delayTimeUs += m_jumpDelayUs;
+        }
+    }
+
+    m_xMm = xMm;
+    m_yMm = yMm;
+    m_zMm = zMm;
+}
+
+void ScanTimeEstimator::endMarkSequence() {
+    if (m_inMarkSequence) {
+        m_totals.delayTimeUs += m_skyWriting ? m_skyRunOutUs : m_markDelayUs;
+        m_inMarkSequence = false;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "RTC6impl.h" // For UINT, INT
+#include "MachineConfig.h"
+#include <cstdint>
+#include <vector>
+
+struct ListCommand;
+
+/**
+ * @brief Expected execution time of a list, split by where the time goes.
+ */
+struct ScanTimeEstimate {
+    double markTimeUs = 0.0;   // Marking at mark speed, plus laser-on exposures.
+    double jumpTimeUs = 0.0;   // Jumping at jump speed.
+    double delayTimeUs = 0.0;  // Jump, mark and polygon delays, plus non-motion list commands.
+
+    double totalUs() const { return markTimeUs + jumpTimeUs + delayTimeUs; }
+
+    ScanTimeEstimate& operator+=(const ScanTimeEstimate& other) {
+        markTimeUs += other.markTimeUs;
+        jumpTimeUs += other.jumpTimeUs;
+        delayTimeUs += other.delayTimeUs;
+        return *this;
+    }
+};
+
+/**
+ * @brief A simple scanner motion model that accumulates expected list execution time.
+ *
+ * It is fed the same commands that go into a list, one at a time, so the estimate is
+ * available as soon as the list is prepared. The model:
+ * - Jump: distance / jump speed, followed by the jump delay. In jump mode, distance /
+ *   JUMP_MODE_SPEED_MM_S followed by JUMP_MODE_DELAY_US instead.
+ * - Mark: distance / mark speed. Consecutive marks are separated by the polygon delay,
+ *   and the mark delay is added once a mark sequence ends (jump, laser-on or end of list).
+ *   With a variable polygon delay, the delay scales linearly with the corner angle, from
+ *   nothing for a straight continuation to the full delay for a reversal. The angles are
+ *   computed only here, from the integer coordinates the list receives; the coordinate
+ *   conversion in the GeometryHandler neither computes nor passes them on.
+ *   With sky-writing, the run-in and run-out replace the mark delay; corners still count
+ *   the polygon delay, scaled by the corner angle in the same way.
+ * - Laser-on: the commanded period.
+ * - List loop: the time of one pass, from list_repeat to list_until, times the number of
+ *   passes. Every pass is assumed to take as long as the first, including its first jump.
+ * - Any other list command: MachineConfig::LIST_COMMAND_TIME_US.
+ *
+ * Speeds and delays start from the MachineConfig scanner timing model and follow
+ * the set_jump_speed / set_scanner_delays commands of the list. With the ScanaheadAuto
+ * delay model the board ignores manual delays, so the fixed SCANAHEAD_*_DELAY_US
+ * settling times are used throughout and set_scanner_delays only costs a list command.
+ */
+class ScanTimeEstimator {
+public:
+    explicit ScanTimeEstimator(MachineConfig::DelayModel delayModel = MachineConfig::DELAY_MODEL);
+
+    // Clears the accumulated times. Position and speeds are kept, like on the board.
+    void reset();
+
+    void jumpTo(INT x, INT y);
+    void markTo(INT x, INT y);
+    void jumpTo3D(INT x, INT y, INT z);
+    void markTo3D(INT x, INT y, INT z);
+    void laserOn(UINT period_10us);
+    void setMarkSpeed(double speed_mm_s);
+    void setJumpSpeed(double speed_mm_s);
+    void setScannerDelays(double jumpDelayUs, double markDelayUs, double polygonDelayUs);
+    // With sky-writing on (mode != 0), every mark sequence costs the run-in before its
+    // first mark and the run-out instead of the mark delay after its last one.
+    void setSkyWritingMode(UINT mode);
+    void setSkyWritingRunInOut(double runInUs, double runOutUs);
+    void setJumpMode(bool enabled);
+    // Defaults to MachineConfig::USE_VARIABLE_POLYGON_DELAY with the Manual delay model.
+    void setVariablePolygonDelay(bool enabled) { m_variablePolygonDelay = enabled; }
+    // Any list command that takes no motion time of its own.
+    void parameterCommand();
+    // Start and end of a list loop. A list_until without a list_repeat runs once.
+    void beginRepeat();
+    void endRepeat(UINT passes);
+    // Dispatches one recorded command to the matching call above.
+    void apply(const ListCommand& command);
+
+    /**
+     * @brief Returns the time accumulated since reset(), including a pending mark delay.
+     */
+    ScanTimeEstimate current() const;
+
+    /**
+     * @brief Estimates a recorded command list from scratch with the default model.
+     * @param delayModel Lets the same list be estimated under both delay models.
+     */
+    static ScanTimeEstimate estimate(const std::vector<ListCommand>& commands,
+        MachineConfig::DelayModel delayModel = MachineConfig::DELAY_MODEL);
+
+private:
+    void moveTo(double xMm, double yMm, double zMm, bool isMark);
+    void endMarkSequence();
+    // Fraction of the polygon delay spent at the corner before a mark to (x, y), from the
+    // integer direction vectors. Also tracks the position and direction in bits.
+    double cornerDelayScale(INT x, INT y, bool isMark);
+
+    MachineConfig::DelayModel m_delayModel;
+    double m_xMm = 0.0;
+    double m_yMm = 0.0;
+    double m_zMm = 0.0;
+    double m_markSpeedMmS;
+    double m_jumpSpeedMmS;
+    double m_jumpDelayUs;
+    double m_markDelayUs;
+    double m_polygonDelayUs;
+    bool m_skyWriting = false;
+    double m_skyRunInUs = 0.0;
+    double m_skyRunOutUs = 0.0;
+    bool m_jumpMode = false;
+    bool m_variablePolygonDelay;
+    double m_cornerScale = 1.0;     // Applies to the polygon delay of the move in progress.
+    INT m_xBits = 0;
+    INT m_yBits = 0;
+    int64_t m_dirX = 0;             // Direction of the last mark, 0/0 after a jump.
+    int64_t m_dirY = 0;
+    bool m_inMarkSequence = false;
+    ScanTimeEstimate m_totals;
+    bool m_inRepeat = false;
+    ScanTimeEstimate m_repeatStart;  // m_totals at the list_repeat.
+};
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "ShortVectorFilter.h"
+#include <cmath>
+
+namespace {
+    double segmentLength(const INT* h) {
+        return std::hypot(static_cast<double>(h[2]) - h[0], static_cast<double>(h[3]) - h[1]);
+    }
+
+    // Perpendicular distance of point (px, py) from the infinite line through segment h.
+    double distanceFromLine(const INT* h, double length, INT px, INT py) {
+        const double dx = static_cast<double>(h[2]) - h[0];
+        const double dy = static_cast<double>(h[3]) - h[1];
+        const double cross = dx * (static_cast<double>(py) - h[1]) - dy * (static_cast<double>(px) - h[0]);
+        return std::abs(cross) / length;
+    }
+
+    bool canMerge(const INT* prev, const INT* next, double prevLength, double nextLength,
+        double minLengthBits, double toleranceBits)
+    {
+        if (prevLength >= minLengthBits && nextLength >= minLengthBits) return false;
+        if (prevLength == 0.0) return false;
+
+        const double gap = std::hypot(static_cast<double>(next[0]) - prev[2], static_cast<double>(next[1]) - prev[3]);
+        if (gap > toleranceBits) return false;
+
+        const double dot = (static_cast<double>(prev[2]) - prev[0]) * (static_cast<double>(next[2]) - next[0])
+            + (static_cast<double>(prev[3]) - prev[1]) * (static_cast<double>(next[3]) - next[1]);
+        if (dot < 0.0) return false;
+
+        return distanceFromLine(prev, prevLength, next[0], next[1]) <= toleranceBits
+            && distanceFromLine(prev, prevLength, next[2], next[3]) <= toleranceBits;
+    }
+}
+
+ShortVectorFilter::Result ShortVectorFilter::filterHatches(
+    INT* hatchBits, size_t hatchCount, double minLengthBits, double mergeToleranceBits)
+{
+    Result result;
+    if (minLengthBits <= 0.0) {
+        result.hatchCount = hatchCount;
+        return result;
+    }
+
+    // Pass 1: coalesce into the previous kept hatch, compacting the buffer as we go.
+    size_t kept = 0;
+    for (size_t i = 0; i < hatchCount; ++i) {
+        const INT* next = hatchBits + 4 * i;
+        if (kept > 0 && mergeToleranceBits > 0.0) {
+            INT* prev = hatchBits + 4 * (kept - 1);
+            if (canMerge(prev, next, segmentLength(prev), segmentLength(next), minLengthBits, mergeToleranceBits)) {
+                prev[2] = next[2];
+                prev[3] = next[3];
+                ++result.mergedVectors;
+                continue;
+            }
+        }
+        INT* dst = hatchBits + 4 * kept;
+        if (dst != next) {
+            dst[0] = next[0]; dst[1] = next[1]; dst[2] = next[2]; dst[3] = next[3];
+        }
+        ++kept;
+    }
+
+    // Pass 2: drop whatever is still too short to be worth a jump and a mark.
+    size_t out = 0;
+    for (size_t i = 0; i < kept; ++i) {
+        const INT* h = hatchBits + 4 * i;
+        const double length = segmentLength(h);
+        if (length < minLengthBits) {
+            ++result.droppedVectors;
+            result.droppedLengthBits += length;
+            continue;
+        }
+        INT* dst = hatchBits + 4 * out;
+        if (dst != h) {
+            dst[0] = h[0]; dst[1] = h[1]; dst[2] = h[2]; dst[3] = h[3];
+        }
+        ++out;
+    }
+
+    result.hatchCount = out;
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "RTC6impl.h" // For INT
+#include <cstddef>
+
+/**
+ * @brief Counters for the short-vector stage, accumulated per work plane.
+ */
+struct ShortVectorStats {
+    size_t droppedVectors = 0;       // Segments removed for being shorter than the minimum length.
+    size_t mergedVectors = 0;        // Segments folded into their predecessor.
+    double droppedMarkLengthMm = 0.0;
+    double estimatedTimeSavedUs = 0.0;
+
+    ShortVectorStats& operator+=(const ShortVectorStats& other) {
+        droppedVectors += other.droppedVectors;
+        mergedVectors += other.mergedVectors;
+        droppedMarkLengthMm += other.droppedMarkLengthMm;
+        estimatedTimeSavedUs += other.estimatedTimeSavedUs;
+        return *this;
+    }
+};
+
+/**
+ * @brief Removes and coalesces micro-hatches in a converted hatch buffer.
+ *
+ * Works in place on RTC6 bit coordinates, after the fixed-point conversion, so the
+ * decisions are exact and identical on every thread.
+ */
+class ShortVectorFilter {
+public:
+    struct Result {
+        size_t hatchCount = 0;        // Number of hatches left at the front of the buffer.
+        size_t droppedVectors = 0;
+        size_t mergedVectors = 0;
+        double droppedLengthBits = 0.0;
+    };
+
+    /**
+     * @brief Filters hatches stored as consecutive (x0, y0, x1, y1) bit quadruples.
+     *
+     * 1.  **Coalesce:** a hatch is folded into the previous kept hatch when either of
+     *     them is shorter than `minLengthBits`, it starts within `mergeToleranceBits` of
+     *     the previous end, runs in the same direction, and both of its endpoints lie
+     *     within `mergeToleranceBits` of the previous hatch's line.
+     * 2.  **Drop:** any hatch still shorter than `minLengthBits` is removed.
+     *
+     * @param hatchBits The hatch buffer, compacted in place.
+     * @param hatchCount The number of hatches (not values) in the buffer.
+     * @param minLengthBits Segments below this length are candidates. 0 disables the filter.
+     * @param mergeToleranceBits Maximum gap and lateral deviation for coalescing. 0 disables merging.
+     */
+    static Result filterHatches(INT* hatchBits, size_t hatchCount, double minLengthBits, double mergeToleranceBits);
+};
\ No newline at end of file
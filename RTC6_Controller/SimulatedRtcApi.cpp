@@ -0,0 +1,298 @@
+#include "SimulatedRtcApi.h"
+#include "MachineConfig.h"
+#include "Rtc6Constants.h"
+#include <algorithm>
+
+SimulatedRtcApi::SimulatedRtcApi(SimulatedTime timeMode, double realTimeScale, UINT listCapacity)
+    : m_timeMode(timeMode),
+    m_realTimeScale(realTimeScale > 0.0 ? realTimeScale : 1.0),
+    m_listCapacity(listCapacity),
+    m_realStart(std::chrono::steady_clock::now()) {
+}
+
+double SimulatedRtcApi::nowUs() const {
+    if (m_timeMode == SimulatedTime::Virtual) {
+        return m_virtualUs;
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - m_realStart;
+    return std::chrono::duration<double, std::micro>(elapsed).count() * m_realTimeScale;
+}
+
+void SimulatedRtcApi::advanceUs(double us) {
+    if (m_timeMode == SimulatedTime::Virtual && us > 0.0) {
+        m_virtualUs += us;
+    }
+}
+
+SimulationStats SimulatedRtcApi::stats() {
+    update();
+    return m_stats;
+}
+
+void SimulatedRtcApi::hostCall() {
+    m_consecutivePolls = 0;
+    advanceUs(HOST_CALL_US);
+    update();
+}
+
+// --- List management ---
+
+// The list that is not running starts the moment the running list ends; the arm is consumed
+// by that hand-over. Armed on an idle board, it stays pending like on the board and hands
+// over at the end of whichever list is started next.
+void SimulatedRtcApi::api_auto_change() {
+    hostCall();
+    if (m_runningList == 0) {
+        ++m_stats.staleAutoChanges;
+    }
+    m_autoChangeArmed = true;
+}
+
+void SimulatedRtcApi::api_set_start_list(UINT listNo) {
+    hostCall();
+    if ((listNo != 1 && listNo != 2) || listNo == m_runningList) {
+        ++m_stats.rejectedCalls;
+        m_loadingList = 0;
+        return;
+    }
+    m_loadingSub = false;
+    m_loadingList = listNo;
+    m_lists[listNo - 1].commands.clear();
+    m_lists[listNo - 1].ended = false;
+}
+
+void SimulatedRtcApi::api_set_end_of_list() {
+    hostCall();
+    if (m_loadingList == 0) {
+        ++m_stats.rejectedCalls;
+        return;
+    }
+    m_lists[m_loadingList - 1].ended = true;
+    m_loadingList = 0;
+}
+
+void SimulatedRtcApi::api_execute_list(UINT listNo) {
+    hostCall();
+    if ((listNo != 1 && listNo != 2) || m_runningList != 0) {
+        ++m_stats.rejectedCalls;
+        return;
+    }
+    startList(listNo, nowUs());
+}
+
+// In Virtual mode a run of status reads means the host is waiting for a list, so board
+// time skips to the list end instead of being spent poll by poll.
+UINT SimulatedRtcApi::api_read_status() {
+    if (m_timeMode == SimulatedTime::Virtual) {
+        m_virtualUs += HOST_CALL_US;
+        if (++m_consecutivePolls >= WAIT_DETECT_POLLS && m_runningList != 0) {
+            m_virtualUs = std::max(m_virtualUs, m_runningEndUs);
+        }
+    }
+    update();
+    if (m_runningList == 1) return Rtc6Constants::Status::BUSY1;
+    if (m_runningList == 2) return Rtc6Constants::Status::BUSY2;
+    return 0;
+}
+
+// Stops the running list where it is and cancels an armed auto_change.
+void SimulatedRtcApi::api_stop_execution() {
+    hostCall();
+    if (m_runningList != 0) {
+        const double now = nowUs();
+        m_stats.busyUs += now - m_runningStartUs;
+        m_runningList = 0;
+        m_idle = true;
+        m_idleSinceUs = now;
+    }
+    m_autoChangeArmed = false;
+}
+
+// Positions inside a running list are not modelled: a running list reports position 0,
+// a finished one its end.
+void SimulatedRtcApi::api_get_out_pointer(UINT& listNo, UINT& pos) {
+    hostCall();
+    listNo = m_lastStartedList;
+    pos = 0;
+    if (m_lastStartedList != 0 && m_runningList == 0) {
+        pos = static_cast<UINT>(m_lists[m_lastStartedList - 1].commands.size());
+    }
+}
+
+// Every command takes one position, so the input pointer is the size of what is being loaded.
+UINT SimulatedRtcApi::api_get_input_pointer() {
+    hostCall();
+    if (m_loadingSub) {
+        return static_cast<UINT>(m_subroutines[m_loadingSubIndex].size());
+    }
+    return m_loadingList == 0 ? 0 : static_cast<UINT>(m_lists[m_loadingList - 1].commands.size());
+}
+
+UINT SimulatedRtcApi::api_get_list_space() {
+    hostCall();
+    if (m_loadingList == 0) {
+        return m_listCapacity;
+    }
+    const size_t used = m_lists[m_loadingList - 1].commands.size();
+    return used >= m_listCapacity ? 0 : m_listCapacity - static_cast<UINT>(used);
+}
+
+// --- List commands ---
+
+void SimulatedRtcApi::append(const ListCommand& command) {
+    hostCall();
+    if (m_loadingSub) {
+        m_subroutines[m_loadingSubIndex].push_back(command);
+        return;
+    }
+    if (m_loadingList == 0 || m_lists[m_loadingList - 1].commands.size() >= m_listCapacity) {
+        ++m_stats.rejectedCalls;
+        return;
+    }
+    m_lists[m_loadingList - 1].commands.push_back(command);
+}
+
+void SimulatedRtcApi::api_jump_abs(INT x, INT y) { append({ ListCommand::Type::Jump, x, y }); }
+void SimulatedRtcApi::api_mark_abs(INT x, INT y) { append({ ListCommand::Type::Mark, x, y }); }
+void SimulatedRtcApi::api_jump_abs_3d(INT x, INT y, INT z) { append({ ListCommand::Type::Jump3D, x, y, z }); }
+void SimulatedRtcApi::api_mark_abs_3d(INT x, INT y, INT z) { append({ ListCommand::Type::Mark3D, x, y, z }); }
+void SimulatedRtcApi::api_laser_on_list(UINT period) { append({ ListCommand::Type::LaserOn, static_cast<INT>(period) }); }
+void SimulatedRtcApi::api_set_defocus_list(INT offset) { append({ ListCommand::Type::SetFocusOffset, offset }); }
+
+// Speeds arrive in bits/ms; the time model works in mm/s.
+static double toMmPerS(double bitsPerMs) {
+    return bitsPerMs * 1000.0 / MachineConfig::MM_TO_BITS_CONVERSION_FACTOR;
+}
+
+void SimulatedRtcApi::api_set_mark_speed(double speed) {
+    append({ ListCommand::Type::SetMarkSpeed, 0, 0, 0, toMmPerS(speed) });
+}
+
+void SimulatedRtcApi::api_set_laser_power(UINT port, UINT power) {
+    append({ ListCommand::Type::SetLaserPower, static_cast<INT>(port), static_cast<INT>(power) });
+}
+
+void SimulatedRtcApi::api_set_jump_speed(double speed) {
+    append({ ListCommand::Type::SetJumpSpeed, 0, 0, 0, toMmPerS(speed) });
+}
+
+void SimulatedRtcApi::api_set_scanner_delays(UINT jump, UINT mark, UINT polygon) {
+    append({ ListCommand::Type::SetScannerDelays, static_cast<INT>(jump), static_cast<INT>(mark), static_cast<INT>(polygon) });
+}
+
+void SimulatedRtcApi::api_set_laser_delays(INT laserOnDelay, UINT laserOffDelay) {
+    append({ ListCommand::Type::SetLaserDelays, laserOnDelay, static_cast<INT>(laserOffDelay) });
+}
+
+void SimulatedRtcApi::api_set_sky_writing_mode(UINT mode) {
+    append({ ListCommand::Type::SetSkyWritingMode, static_cast<INT>(mode) });
+}
+
+void SimulatedRtcApi::api_set_sky_writing_para(double timelag, INT laserOnShift, UINT nPrev, UINT nPost) {
+    append({ ListCommand::Type::SetSkyWritingParams, laserOnShift, static_cast<INT>(nPrev), static_cast<INT>(nPost), timelag });
+}
+
+void SimulatedRtcApi::api_set_sky_writing_limit(double cosAngle) {
+    append({ ListCommand::Type::SetSkyWritingLimit, 0, 0, 0, cosAngle });
+}
+
+void SimulatedRtcApi::api_set_wobbel_mode(UINT transversal, UINT longitudinal, double freq, INT mode) {
+    append({ ListCommand::Type::SetWobbleMode, static_cast<INT>(transversal), static_cast<INT>(longitudinal), mode, freq });
+}
+
+void SimulatedRtcApi::api_set_jump_mode(INT flag) {
+    append({ ListCommand::Type::SetJumpMode, flag });
+}
+
+void SimulatedRtcApi::api_list_repeat() { append({ ListCommand::Type::ListRepeat }); }
+void SimulatedRtcApi::api_list_until(UINT number) { append({ ListCommand::Type::ListUntil, static_cast<INT>(number) }); }
+void SimulatedRtcApi::api_jump_rel(INT dx, INT dy) { append({ ListCommand::Type::JumpRel, dx, dy }); }
+void SimulatedRtcApi::api_mark_rel(INT dx, INT dy) { append({ ListCommand::Type::MarkRel, dx, dy }); }
+void SimulatedRtcApi::api_sub_call(UINT index) { append({ ListCommand::Type::SubCall, static_cast<INT>(index) }); }
+
+// --- Subroutines ---
+
+// A subroutine goes into memory outside both lists, so loading one closes the list being
+// loaded; load_list reopens it.
+void SimulatedRtcApi::api_load_sub(UINT index) {
+    hostCall();
+    m_loadingList = 0;
+    m_loadingSub = true;
+    m_loadingSubIndex = index;
+    m_subroutines[index].clear();
+}
+
+void SimulatedRtcApi::api_list_return() {
+    hostCall();
+    if (!m_loadingSub) {
+        ++m_stats.rejectedCalls;
+        return;
+    }
+    m_loadingSub = false;
+}
+
+// Continues loading a list at a position, dropping whatever was loaded behind it.
+void SimulatedRtcApi::api_load_list(UINT listNo, UINT pos) {
+    hostCall();
+    if ((listNo != 1 && listNo != 2) || listNo == m_runningList || pos > m_lists[listNo - 1].commands.size()) {
+        ++m_stats.rejectedCalls;
+        m_loadingList = 0;
+        return;
+    }
+    m_loadingSub = false;
+    m_loadingList = listNo;
+    m_lists[listNo - 1].commands.resize(pos);
+    m_lists[listNo - 1].ended = false;
+}
+
+// --- Execution model ---
+
+void SimulatedRtcApi::update() {
+    const double now = nowUs();
+    while (m_runningList != 0 && now >= m_runningEndUs) {
+        const UINT finished = m_runningList;
+        const double endUs = m_runningEndUs;
+        m_stats.busyUs += endUs - m_runningStartUs;
+        m_runningList = 0;
+
+        const UINT other = finished == 1 ? 2 : 1;
+        if (m_autoChangeArmed && m_lists[other - 1].ended && m_loadingList != other) {
+            m_autoChangeArmed = false;
+            startList(other, endUs);
+        }
+        else {
+            m_autoChangeArmed = false;
+            m_idle = true;
+            m_idleSinceUs = endUs;
+        }
+    }
+}
+
+void SimulatedRtcApi::startList(UINT listNo, double atUs) {
+    if (m_idle && m_stats.listsExecuted > 0) {
+        const double gapUs = atUs - m_idleSinceUs;
+        m_stats.idleUs += gapUs;
+        m_stats.maxGapUs = std::max(m_stats.maxGapUs, gapUs);
+        ++m_stats.gapCount;
+    }
+    m_idle = false;
+
+    m_motion.reset();
+    for (const auto& command : m_lists[listNo - 1].commands) {
+        m_motion.apply(command);
+        if (command.type == ListCommand::Type::SubCall) {
+            const auto sub = m_subroutines.find(static_cast<UINT>(command.x));
+            if (sub != m_subroutines.end()) {
+                for (const auto& subCommand : sub->second) {
+                    m_motion.apply(subCommand);
+                }
+                m_motion.parameterCommand(); // list_return
+            }
+        }
+    }
+    m_runningList = listNo;
+    m_lastStartedList = listNo;
+    m_runningStartUs = atUs;
+    m_runningEndUs = atUs + m_motion.current().totalUs();
+    ++m_stats.listsExecuted;
+}
\ No newline at end of file
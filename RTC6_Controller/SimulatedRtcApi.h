@@ -0,0 +1,159 @@
+#pragma once
+
+#include "InterfaceRtcApi.h"
+#include "InterfaceCommunicator.h"
+#include "CommandBuffer.h"
+#include "ScanTimeEstimator.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+/**
+ * @brief How the clock of a SimulatedRtcApi advances.
+ */
+enum class SimulatedTime {
+    // Board time advances by a fixed cost per API call only. While the host polls the
+    // status in a wait loop it jumps straight to the end of the running list, so a run
+    // is deterministic and host compute time between calls is free.
+    Virtual,
+    // Board time follows the host's steady clock, multiplied by a scale factor. Host
+    // compute time, sleeps and poll latency all count, as on the real machine.
+    ScaledRealTime
+};
+
+/**
+ * @brief What the simulated board did since it was created.
+ */
+struct SimulationStats {
+    uint64_t listsExecuted = 0;
+    uint64_t gapCount = 0;          // List starts that found the board idle, except the first.
+    double busyUs = 0.0;            // Time spent executing lists.
+    double idleUs = 0.0;            // Time between the end of a list and the start of the next.
+    double maxGapUs = 0.0;
+    uint64_t rejectedCalls = 0;     // Calls the board ignores: writes with no list open or
+                                    // into a full list, loading or starting a running list.
+    uint64_t staleAutoChanges = 0;  // auto_change calls made while no list ran. The arm stays
+                                    // pending and hands over at the end of the next list.
+};
+
+/**
+ * @brief A software model of an RTC6 board behind InterfaceRtcApi, for running the
+ *        controller without the DLL or hardware.
+ *
+ * Models two list buffers of a fixed capacity, set_start_list / set_end_of_list,
+ * execute_list, auto_change and the BUSY1/BUSY2 status bits, plus subroutines loaded
+ * with load_sub and run by sub_call. A list's execution time
+ * comes from the ScanTimeEstimator, fed with the list's commands when the list starts,
+ * so the speeds, delays and scanner position carry over between lists like on the board.
+ * The stats then show how long the board sat idle waiting for the host.
+ *
+ * Not thread-safe; like the real board context, it is driven by one thread.
+ */
+class SimulatedRtcApi : public InterfaceRtcApi {
+public:
+    // Positions per list. Match the list sizes configured on the board.
+    static constexpr UINT DEFAULT_LIST_CAPACITY = 1u << 16;
+    // Virtual time charged for each API call, the order of a PCIe round trip.
+    static constexpr double HOST_CALL_US = 1.0;
+    // Consecutive status reads after which the host is taken to be waiting (Virtual only).
+    static constexpr unsigned WAIT_DETECT_POLLS = 3;
+
+    /**
+     * @param timeMode How board time advances.
+     * @param realTimeScale Board microseconds per host microsecond (ScaledRealTime only).
+     *                      A value above 1 runs long jobs faster than on the machine.
+     * @param listCapacity Positions per list.
+     */
+    explicit SimulatedRtcApi(SimulatedTime timeMode = SimulatedTime::Virtual,
+        double realTimeScale = 1.0, UINT listCapacity = DEFAULT_LIST_CAPACITY);
+
+    void api_auto_change() override;
+    void api_set_start_list(UINT listNo) override;
+    void api_set_end_of_list() override;
+    void api_execute_list(UINT listNo) override;
+    UINT api_read_status() override;
+    UINT api_get_list_space() override;
+    void api_jump_abs(INT x, INT y) override;
+    void api_mark_abs(INT x, INT y) override;
+    void api_jump_abs_3d(INT x, INT y, INT z) override;
+    void api_mark_abs_3d(INT x, INT y, INT z) override;
+    void api_laser_on_list(UINT period) override;
+    void api_set_defocus_list(INT offset) override;
+    void api_set_mark_speed(double speed) override;
+    void api_set_laser_power(UINT port, UINT power) override;
+    void api_set_jump_speed(double speed) override;
+    void api_set_scanner_delays(UINT jump, UINT mark, UINT polygon) override;
+    void api_set_laser_delays(INT laserOnDelay, UINT laserOffDelay) override;
+    void api_set_sky_writing_mode(UINT mode) override;
+    void api_set_sky_writing_para(double timelag, INT laserOnShift, UINT nPrev, UINT nPost) override;
+    void api_set_sky_writing_limit(double cosAngle) override;
+    void api_set_wobbel_mode(UINT transversal, UINT longitudinal, double freq, INT mode) override;
+    void api_set_jump_mode(INT flag) override;
+    void api_list_repeat() override;
+    void api_list_until(UINT number) override;
+    void api_jump_rel(INT dx, INT dy) override;
+    void api_mark_rel(INT dx, INT dy) override;
+    void api_load_sub(UINT index) override;
+    void api_list_return() override;
+    void api_sub_call(UINT index) override;
+    void api_load_list(UINT listNo, UINT pos) override;
+    void api_stop_execution() override;
+    void api_get_out_pointer(UINT& listNo, UINT& pos) override;
+    UINT api_get_input_pointer() override;
+
+    // Moves virtual time forward, e.g. to model host work between calls. Ignored in ScaledRealTime.
+    void advanceUs(double us);
+    // Current board time in microseconds since construction.
+    double nowUs() const;
+    // Brings the board up to the current time first, so lists that have ended are counted.
+    SimulationStats stats();
+
+private:
+    struct List {
+        std::vector<ListCommand> commands;
+        bool ended = false;
+    };
+
+    // Every API call goes through here: charges the call cost and ends a poll streak.
+    void hostCall();
+    void append(const ListCommand& command);
+    // Finishes the lists whose end time has passed, starting chained lists on the way.
+    void update();
+    void startList(UINT listNo, double atUs);
+
+    SimulatedTime m_timeMode;
+    double m_realTimeScale;
+    UINT m_listCapacity;
+    std::chrono::steady_clock::time_point m_realStart;
+    double m_virtualUs = 0.0;
+    unsigned m_consecutivePolls = 0;
+
+    std::array<List, 2> m_lists;
+    UINT m_loadingList = 0;          // List opened by set_start_list, 0 if none.
+    std::map<UINT, std::vector<ListCommand>> m_subroutines;
+    bool m_loadingSub = false;       // load_sub was called and list_return has not been.
+    UINT m_loadingSubIndex = 0;
+    UINT m_runningList = 0;          // 0 while the board is idle.
+    UINT m_lastStartedList = 0;      // Where the output pointer is; 0 before the first start.
+    double m_runningStartUs = 0.0;
+    double m_runningEndUs = 0.0;
+    bool m_autoChangeArmed = false;
+    bool m_idle = true;
+    double m_idleSinceUs = 0.0;
+    ScanTimeEstimator m_motion;      // Scanner state; persists across lists.
+    SimulationStats m_stats;
+};
+
+/**
+ * @brief Stand-in for Rtc6Communicator when the controller runs on a SimulatedRtcApi.
+ */
+class SimulatedCommunicator : public InterfaceCommunicator {
+public:
+    bool connectAndSetupBoard() override { m_setup = true; return true; }
+    bool isSuccessfullySetup() const override { return m_setup; }
+
+private:
+    bool m_setup = false;
+};
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "SubroutineLibrary.h"
+
+SubroutineLibrary::SubroutineLibrary(UINT maxCount, UINT memoryPositions, UINT minMoves)
+    : m_maxCount(maxCount),
+    m_memoryPositions(memoryPositions),
+    m_minMoves(minMoves) {
+}
+
+// FNV-1a over the move types and offsets.
+uint64_t SubroutineLibrary::hashMoves(const std::vector<ListCommand>& moves) {
+    uint64_t hash = 14695981039346656037ull;
+    const auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+    for (const auto& move : moves) {
+        mix(static_cast<uint64_t>(move.type));
+        mix(static_cast<uint32_t>(move.x));
+        mix(static_cast<uint32_t>(move.y));
+    }
+    return hash;
+}
+
+SubroutineLibrary::Lookup SubroutineLibrary::lookup(const std::vector<ListCommand>& relativeMoves) {
+    if (relativeMoves.size() < m_minMoves) {
+        return {};
+    }
+
+    const uint64_t hash = hashMoves(relativeMoves);
+    const auto range = m_shapes.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        Entry& entry = it->second;
+        if (entry.moves != relativeMoves) {
+            continue;
+        }
+        if (entry.loaded) {
+            entry.lastLayer = m_layer;
+            return { Action::Call, entry.index };
+        }
+
+        const size_t positions = relativeMoves.size() + 1;
+        while (!hasRoomFor(positions)) {
+            if (positions > m_memoryPositions || !evictOne()) {
+                ++m_refusedLoads;
+                return {};
+            }
+        }
+        if (!m_freeIndices.empty()) {
+            entry.index = m_freeIndices.back();
+            m_freeIndices.pop_back();
+        }
+        else {
+            entry.index = m_loadedCount;
+        }
+        entry.loaded = true;
+        entry.lastLayer = m_layer;
+        ++m_loadedCount;
+        m_usedPositions += static_cast<UINT>(positions);
+        return { Action::Load, entry.index };
+    }
+
+    m_shapes.emplace(hash, Entry{ relativeMoves });
+    return {};
+}
+
+bool SubroutineLibrary::hasRoomFor(size_t positions) const {
+    return m_loadedCount < m_maxCount && positions <= m_memoryPositions - m_usedPositions;
+}
+
+bool SubroutineLibrary::evictOne() {
+    Entry* oldest = nullptr;
+    for (auto& [hash, entry] : m_shapes) {
+        if (entry.loaded && entry.lastLayer + 1 < m_layer && (!oldest || entry.lastLayer < oldest->lastLayer)) {
+            oldest = &entry;
+        }
+    }
+    if (!oldest) {
+        return false;
+    }
+    // It stays a shape seen in this layer, so its next copy loads it again.
+    oldest->loaded = false;
+    m_freeIndices.push_back(oldest->index);
+    --m_loadedCount;
+    m_usedPositions -= static_cast<UINT>(oldest->moves.size() + 1);
+    return true;
+}
+
+void SubroutineLibrary::beginLayer() {
+    for (auto it = m_shapes.begin(); it != m_shapes.end();) {
+        it = it->second.loaded ? std::next(it) : m_shapes.erase(it);
+    }
+    ++m_layer;
+    m_refusedLoads = 0;
+}
\ No newline at end of file
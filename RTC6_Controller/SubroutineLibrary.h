@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CommandBuffer.h"
+#include "RTC6impl.h" // For UINT, INT
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Finds shapes that repeat at other positions and assigns them board subroutines.
+ *
+ * A shape is given as its moves relative to its first point (JumpRel/MarkRel), so every
+ * translated copy has the same key. The first sighting only remembers the shape; the
+ * second one assigns it a subroutine index, which it keeps while it is in use.
+ * Shapes are compared move by move, so a hash collision never calls the wrong geometry.
+ *
+ * Only the subroutines are kept across layers. Shapes seen once are forgotten by
+ * beginLayer(), which bounds the memory to the shapes of one layer.
+ *
+ * When a shape finds no free index or memory, the subroutines called neither in this
+ * layer nor in the previous one are evicted, least recently called first, and their index
+ * and positions are reused. The previous layer's last list may still run when the next
+ * layer is prepared; every list before it has ended. A load refused even so is counted
+ * in refusedLoads() and the shape is written out.
+ */
+class SubroutineLibrary {
+public:
+    enum class Action {
+        Inline,     // Write the shape out as usual.
+        Load,       // Load the shape as subroutine `index`, then call it.
+        Call        // Call subroutine `index`, which is already on the board.
+    };
+
+    struct Lookup {
+        Action action = Action::Inline;
+        UINT index = 0;
+    };
+
+    /**
+     * @param maxCount Subroutine indices available, 0 .. maxCount - 1.
+     * @param memoryPositions List positions available for all subroutines together.
+     * @param minMoves Shapes with fewer moves are always written out.
+     */
+    SubroutineLibrary(UINT maxCount, UINT memoryPositions, UINT minMoves);
+
+    Lookup lookup(const std::vector<ListCommand>& relativeMoves);
+    void beginLayer();
+
+    UINT loadedCount() const { return m_loadedCount; }
+    // List positions taken by the loaded subroutines, each including its list_return.
+    UINT usedPositions() const { return m_usedPositions; }
+    // Loads refused for lack of an index or memory since beginLayer().
+    UINT refusedLoads() const { return m_refusedLoads; }
+
+private:
+    struct Entry {
+        std::vector<ListCommand> moves;
+        bool loaded = false;
+        UINT index = 0;
+        uint64_t lastLayer = 0;              // Layer of the last load or call.
+    };
+
+    static uint64_t hashMoves(const std::vector<ListCommand>& moves);
+    bool hasRoomFor(size_t positions) const;
+    // Evicts the least recently called subroutine no list can still run. False if none is.
+    bool evictOne();
+
+    UINT m_maxCount;
+    UINT m_memoryPositions;
+    UINT m_minMoves;
+    UINT m_usedPositions = 0;
+    UINT m_loadedCount = 0;
+    UINT m_refusedLoads = 0;
+    uint64_t m_layer = 0;
+    std::vector<UINT> m_freeIndices;                     // Indices of evicted subroutines.
+    std::unordered_multimap<uint64_t, Entry> m_shapes;
+};
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(unsigned threadCount) {
+    const unsigned total = threadCount == 0 ? 1 : threadCount;
+    m_threads.reserve(total - 1);
+    for (unsigned i = 1; i < total; ++i) {
+        m_threads.emplace_back(&WorkerPool::workerLoop, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::run(size_t taskCount, const Task& task) {
+    if (taskCount == 0) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_taskCount = taskCount;
+        m_nextTask.store(0);
+        m_error = nullptr;
+        m_busyWorkers = static_cast<unsigned>(m_threads.size());
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    drain(0);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_busyWorkers == 0; });
+        m_task = nullptr;
+        error = m_error;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void WorkerPool::workerLoop(unsigned workerIndex) {
+    uint64_t seenGeneration = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stopping || m_generation != seenGeneration; });
+            if (m_stopping) return;
+            seenGeneration = m_generation;
+        }
+
+        drain(workerIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_busyWorkers == 0) {
+                m_done.notify_one();
+            }
+        }
+    }
+}
+
+void WorkerPool::drain(unsigned workerIndex) {
+    for (;;) {
+        const size_t taskIndex = m_nextTask.fetch_add(1);
+        if (taskIndex >= m_taskCount) return;
+        try {
+            (*m_task)(workerIndex, taskIndex);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+            // Stop handing out the remaining tasks of this batch.
+            m_nextTask.store(m_taskCount);
+        }
+    }
+}
\ No newline at end of file
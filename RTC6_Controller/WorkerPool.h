@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A small persistent thread pool for running batches of independent tasks.
+ *
+ * The threads are created once and reused for every batch, so per-layer work pays no
+ * thread start-up cost. Tasks are claimed dynamically from a shared atomic counter:
+ * an idle worker always takes the next unclaimed task, which balances uneven task
+ * sizes the same way work stealing would, without per-thread queues.
+ *
+ * The calling thread takes part in every batch as worker 0, so a pool of size 1
+ * runs everything inline and starts no threads at all.
+ */
+class WorkerPool {
+public:
+    using Task = std::function<void(unsigned workerIndex, size_t taskIndex)>;
+
+    /**
+     * @param threadCount Total number of workers including the calling thread. 0 is treated as 1.
+     */
+    explicit WorkerPool(unsigned threadCount);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(m_threads.size()) + 1; }
+
+    /**
+     * @brief Runs task(worker, i) for every i in [0, taskCount) and blocks until all are done.
+     *
+     * The worker index is stable for a thread and lies in [0, size()), so callers can keep
+     * per-worker scratch state indexed by it. If a task throws, the remaining unclaimed
+     * tasks are skipped and the first exception is rethrown on the calling thread.
+     */
+    void run(size_t taskCount, const Task& task);
+
+private:
+    void workerLoop(unsigned workerIndex);
+    void drain(unsigned workerIndex);
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    const Task* m_task = nullptr;
+    size_t m_taskCount = 0;
+    std::atomic<size_t> m_nextTask{ 0 };
+    uint64_t m_generation = 0;
+    unsigned m_busyWorkers = 0;
+    bool m_stopping = false;
+    std::exception_ptr m_error;
+};
\ No newline at end of file
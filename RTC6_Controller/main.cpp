@@ -5,34 +5,204 @@
 #include "OvfParser.h"
 #include "Rtc6Communicator.h"
 #include "RtcApiWrapper.h"
+#include "ApiTrace.h"
+#include "SimulatedRtcApi.h"
 #include "ListHandler.h"
 #include "GeometryHandler.h"
+#include "ParallelGeometryHandler.h"
 #include "Rtc6Exception.h"
+#include "Logger.h"
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Everything that drives one laser's board. Members are destroyed in reverse order: the
+// handlers first, then the recorder, then its trace file and the board.
+struct LaserStack {
+	std::unique_ptr<InterfaceCommunicator> communicator;
+	std::unique_ptr<InterfaceRtcApi> rtcApi;
+	SimulatedRtcApi* simulatedBoard = nullptr;
+	std::string tracePath;
+	std::ofstream traceFile;
+	std::unique_ptr<RecordingRtcApi> recorder;
+	std::unique_ptr<ListHandler> listHandler;
+	std::unique_ptr<InterfaceGeometryHandler> geoHandler;
+};
+
+// Replays a trace written with --record, on the board or on the simulated board.
+static int runReplay(const std::string& tracePath, ReplaySpeed speed, bool simulate, double simulationScale) {
+	std::ifstream in(tracePath, std::ios::binary);
+	if (!in) {
+		std::cerr << "Cannot open trace file: " << tracePath << std::endl;
+		return 1;
+	}
+
+	try {
+		const std::vector<ApiTraceRecord> records = readApiTrace(in);
+		ReplayStats stats;
+		if (simulate) {
+			// At maximum speed board time must not hold the replay back either.
+			SimulatedRtcApi board(speed == ReplaySpeed::Maximum ? SimulatedTime::Virtual : SimulatedTime::ScaledRealTime, simulationScale);
+			stats = replayApiTrace(records, board, speed);
+		}
+		else {
+			Rtc6Communicator communicator(1);
+			if (!communicator.connectAndSetupBoard()) {
+				throw HardwareError("Board setup failed.");
+			}
+			RtcApiWrapper board;
+			stats = replayApiTrace(records, board, speed);
+		}
+		std::cout << "Replayed " << stats.calls << " call(s) in " << stats.elapsedUs / 1.0e6 << " s; "
+			<< stats.extraStatusPolls << " extra status poll(s) while waiting for the board." << std::endl;
+	}
+	catch (const Rtc6Exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	Logger::instance().flush();
+	return 0;
+}
 
 int main(int argc, char* argv[]) {
-	if (argc != 2) {
-		std::cerr << "Usage: " << argv[0] << " <path_to_ovf_file>" << std::endl;
+	if (argc < 2 || argc > 5) {
+		std::cerr << "Usage: " << argv[0] << " <path_to_ovf_file> [trace|debug|info|warning|error|off] [--simulate[=scale]] [--record=<trace_file>]" << std::endl;
+		std::cerr << "       " << argv[0] << " --replay <trace_file> [--max-speed] [--simulate[=scale]]" << std::endl;
+		return 1;
+	}
+
+	// --replay <trace_file> feeds a recorded trace back to the board instead of running a job.
+	const bool replay = std::string(argv[1]) == "--replay";
+	if (replay && argc < 3) {
+		std::cerr << "Missing trace file after --replay" << std::endl;
 		return 1;
 	}
 
+	// --simulate runs the job on a software model of the board instead of the RTC6 DLL.
+	// The optional scale makes board time run that many times faster than host time.
+	// --record=<trace_file> writes every board call to a binary trace for --replay.
+	bool simulate = false;
+	double simulationScale = 1.0;
+	std::string recordPath;
+	ReplaySpeed replaySpeed = ReplaySpeed::Original;
+	for (int i = replay ? 3 : 2; i < argc; ++i) {
+		const std::string arg = argv[i];
+		if (arg == "--simulate") {
+			simulate = true;
+			continue;
+		}
+		if (arg.rfind("--simulate=", 0) == 0) {
+			simulate = true;
+			const std::string scale = arg.substr(11);
+			size_t parsed = 0;
+			try {
+				simulationScale = std::stod(scale, &parsed);
+			}
+			catch (const std::exception&) {
+				parsed = 0;
+			}
+			if (parsed == 0 || parsed != scale.size() || !(simulationScale > 0.0)) {
+				std::cerr << "Invalid simulation scale: " << arg << std::endl;
+				return 1;
+			}
+			continue;
+		}
+		if (!replay && arg.rfind("--record=", 0) == 0) {
+			recordPath = arg.substr(9);
+			continue;
+		}
+		if (replay && arg == "--max-speed") {
+			replaySpeed = ReplaySpeed::Maximum;
+			continue;
+		}
+		LogLevel level;
+		if (!Logger::parseLevel(arg, level)) {
+			std::cerr << "Unknown log level: " << arg << std::endl;
+			return 1;
+		}
+		Logger::instance().setLevel(level);
+	}
+
+	if (replay) {
+		return runReplay(argv[2], replaySpeed, simulate, simulationScale);
+	}
+
 	PrintJobConfig config;
 	config.ovfFilePath = argv[1];
 	config.recoatingDelayMs = MachineConfig::RECOATING_DELAY_MS;
+	config.compileThreadCount = MachineConfig::LAYER_COMPILE_THREADS != 0
+		? MachineConfig::LAYER_COMPILE_THREADS
+		: std::max(1u, std::thread::hardware_concurrency());
 
 	ConsoleUI ui;
 	OvfParser parser;
-	Rtc6Communicator communicator(1);
-	RtcApiWrapper rtcApi;
-	ListHandler listHandler(communicator, rtcApi);
-	GeometryHandler geoHandler(listHandler);
+	// One board, list handler and geometry handler per laser; laser i runs on board i + 1.
+	// The vector is never resized, so the references between the members stay valid.
+	std::vector<LaserStack> lasers(MachineConfig::LASER_COUNT);
+	const unsigned compileThreadsPerLaser = std::max(1u, config.compileThreadCount / MachineConfig::LASER_COUNT);
+	for (size_t i = 0; i < lasers.size(); ++i) {
+		LaserStack& laser = lasers[i];
+		const UINT boardId = static_cast<UINT>(i + 1);
+		if (simulate) {
+			auto board = std::make_unique<SimulatedRtcApi>(SimulatedTime::ScaledRealTime, simulationScale);
+			laser.simulatedBoard = board.get();
+			laser.rtcApi = std::move(board);
+			laser.communicator = std::make_unique<SimulatedCommunicator>();
+		}
+		else {
+			laser.rtcApi = std::make_unique<RtcApiWrapper>(boardId);
+			laser.communicator = std::make_unique<Rtc6Communicator>(boardId);
+		}
+		InterfaceRtcApi* boardApi = laser.rtcApi.get();
+		if (!recordPath.empty()) {
+			laser.tracePath = lasers.size() > 1 ? recordPath + "." + std::to_string(boardId) : recordPath;
+			laser.traceFile.open(laser.tracePath, std::ios::binary | std::ios::trunc);
+			if (!laser.traceFile) {
+				std::cerr << "Cannot create trace file: " << laser.tracePath << std::endl;
+				return 1;
+			}
+			laser.recorder = std::make_unique<RecordingRtcApi>(*laser.rtcApi, laser.traceFile);
+			boardApi = laser.recorder.get();
+		}
+		laser.listHandler = std::make_unique<ListHandler>(*laser.communicator, *boardApi);
+		if (compileThreadsPerLaser > 1) {
+			laser.geoHandler = std::make_unique<ParallelGeometryHandler>(*laser.listHandler, compileThreadsPerLaser);
+		}
+		else {
+			laser.geoHandler = std::make_unique<GeometryHandler>(*laser.listHandler);
+		}
+	}
+
+	std::vector<LaserChannel> channels;
+	for (auto& laser : lasers) {
+		channels.push_back(LaserChannel{ *laser.communicator, *laser.listHandler, *laser.geoHandler });
+	}
 
 	int exitCode = 0;
 
 	try {
 		ui.printWelcomeMessage();
-		PrintController controller(communicator, parser, ui, listHandler, geoHandler, config);
+		PrintController controller(parser, ui, channels, config);
 		controller.run();
+		for (size_t i = 0; i < lasers.size(); ++i) {
+			const std::string boardLabel = lasers.size() > 1 ? " " + std::to_string(i + 1) : "";
+			if (lasers[i].simulatedBoard != nullptr) {
+				const SimulationStats stats = lasers[i].simulatedBoard->stats();
+				ui.displayMessage("Simulated board" + boardLabel + ": " + std::to_string(stats.listsExecuted) + " list(s), busy "
+					+ std::to_string(stats.busyUs / 1.0e6) + " s, idle between lists " + std::to_string(stats.idleUs / 1.0e6)
+					+ " s over " + std::to_string(stats.gapCount) + " gap(s), longest " + std::to_string(stats.maxGapUs / 1000.0) + " ms, "
+					+ std::to_string(stats.staleAutoChanges) + " auto_change(s) armed while idle.");
+			}
+			if (lasers[i].recorder != nullptr) {
+				lasers[i].recorder->flush();
+				ui.displayMessage("Board" + boardLabel + " calls recorded to " + lasers[i].tracePath + " ("
+					+ std::to_string(lasers[i].recorder->getStallCount()) + " call(s) waited for the trace writer).");
+			}
+		}
 		ui.printGoodbyeMessage();
 	}
 	catch (const HardwareError& e) {
@@ -43,6 +213,10 @@ int main(int argc, char* argv[]) {
 		ui.displayError("A fatal file error occurred: " + std::string(e.what()));
 		exitCode = 1;
 	}
+	catch (const GeometryError& e) {
+		ui.displayError("A fatal geometry error occurred: " + std::string(e.what()));
+		exitCode = 1;
+	}
 	catch (const ConfigurationError& e) {
 		ui.displayError("A fatal configuration error occurred: " + std::string(e.what()));
 		exitCode = 1;
@@ -56,6 +230,7 @@ int main(int argc, char* argv[]) {
 		exitCode = 1;
 	}
 
+	Logger::instance().flush();
 	ui.promptForExit();
 	return exitCode;
 }
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "AffineTransform.h"
+#include "FixedPointTransform.h"
+#include "Rtc6Exception.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+TEST(AffineTransform_Test, Then_TranslationAfterScaling_ScalesBeforeTranslating) {
+    const AffineTransform t = AffineTransform::scaling(2.0, 3.0).then(AffineTransform::translation(10.0, 20.0));
+
+    const float xy[2] = { 1.0f, 1.0f };
+    INT out[2] = {};
+    t.applyToBits(xy, 1, out);
+
+    EXPECT_EQ(out[0], 12);
+    EXPECT_EQ(out[1], 23);
+}
+
+TEST(AffineTransform_Test, RotationDeg_By90Degrees_MapsXAxisOntoYAxis) {
+    const AffineTransform t = AffineTransform::rotationDeg(90.0).then(AffineTransform::scaling(1000.0, 1000.0));
+
+    const float xy[2] = { 1.0f, 0.0f };
+    INT out[2] = {};
+    t.applyToBits(xy, 1, out);
+
+    EXPECT_EQ(out[0], 0);
+    EXPECT_EQ(out[1], 1000);
+}
+
+TEST(AffineTransform_Test, ApplyToBits_RoundsHalfAwayFromZero) {
+    const AffineTransform t;
+    const float xy[4] = { 2.5f, -2.5f, 0.4f, -0.6f };
+    INT out[4] = {};
+    t.applyToBits(xy, 2, out);
+
+    EXPECT_EQ(out[0], 3);
+    EXPECT_EQ(out[1], -3);
+    EXPECT_EQ(out[2], 0);
+    EXPECT_EQ(out[3], -1);
+}
+
+// --- FixedPointTransform conformance against the double-precision path ---
+
+namespace {
+    AffineTransform makeTypicalLayerTransform(double rotationDeg, double dx, double dy) {
+        return AffineTransform::scaling(1.002, 0.998)
+            .then(AffineTransform::rotationDeg(rotationDeg))
+            .then(AffineTransform::translation(dx, dy))
+            .then(AffineTransform::scaling(4000.0, 4000.0));
+    }
+}
+
+TEST(FixedPointTransform_Test, RoundToBits_RoundsHalfAwayFromZero) {
+    const int64_t one = int64_t(1) << FixedPointTransform::PRODUCT_SHIFT;
+    EXPECT_EQ(FixedPointTransform::roundToBits(one * 5 / 2), 3);
+    EXPECT_EQ(FixedPointTransform::roundToBits(-one * 5 / 2), -3);
+    EXPECT_EQ(FixedPointTransform::roundToBits(one * 2 / 5), 0);
+    EXPECT_EQ(FixedPointTransform::roundToBits(-one * 3 / 5), -1);
+}
+
+TEST(FixedPointTransform_Test, ToFixedInput_OutOfRangeAndNonFinite_Throw) {
+    const float limit = static_cast<float>(FixedPointTransform::INPUT_LIMIT_MM);
+    EXPECT_THROW(FixedPointTransform::toFixedInput(1.0e30f), GeometryError);
+    EXPECT_THROW(FixedPointTransform::toFixedInput(-1.0e30f), GeometryError);
+    EXPECT_THROW(FixedPointTransform::toFixedInput(std::nextafter(limit, 2.0f * limit)), GeometryError);
+    EXPECT_THROW(FixedPointTransform::toFixedInput(std::nanf("")), GeometryError);
+    EXPECT_THROW(FixedPointTransform::toFixedInput(-INFINITY), GeometryError);
+    EXPECT_EQ(FixedPointTransform::toFixedInput(-limit), -(int64_t(1024) << FixedPointTransform::INPUT_FRACTION_BITS));
+    EXPECT_EQ(FixedPointTransform::toFixedInput(1.5f), int64_t(3) << (FixedPointTransform::INPUT_FRACTION_BITS - 1));
+}
+
+TEST(FixedPointTransform_Test, ApplyToBits_NaNCoordinate_Throws) {
+    const FixedPointTransform transform;
+    const float xy[] = { 1.0f, 2.0f, 3.0f, std::nanf("") };
+    INT out[4] = {};
+    EXPECT_THROW(transform.applyToBits(xy, 2, out), GeometryError);
+}
+
+TEST(FixedPointTransform_Test, ApplyToBits_RandomizedCorpus_ConformsToDoublePath) {
+    std::mt19937 rng(2024);
+    std::uniform_real_distribution<double> angleDist(-180.0, 180.0);
+    std::uniform_real_distribution<double> offsetDist(-40.0, 40.0);
+    std::uniform_real_distribution<float> coordDist(-90.0f, 90.0f);
+
+    const size_t pointCount = 20000;
+    std::vector<float> xy(pointCount * 2);
+    std::vector<INT> expected(pointCount * 2);
+    std::vector<INT> actual(pointCount * 2);
+    size_t nearTieCount = 0;
+
+    for (int layer = 0; layer < 25; ++layer) {
+        const AffineTransform reference = makeTypicalLayerTransform(angleDist(rng), offsetDist(rng), offsetDist(rng));
+        const FixedPointTransform fixed = FixedPointTransform::fromAffine(reference);
+        for (auto& v : xy) v = coordDist(rng);
+
+        reference.applyToBits(xy.data(), pointCount, expected.data());
+        fixed.applyToBits(xy.data(), pointCount, actual.data());
+
+        for (size_t i = 0; i < pointCount * 2; ++i) {
+            const double x = xy[i & ~size_t(1)];
+            const double y = xy[i | 1];
+            const double exact = (i % 2 == 0) ? reference.a * x + reference.b * y + reference.tx
+                                              : reference.c * x + reference.d * y + reference.ty;
+            const double distanceToTie = std::abs(std::abs(exact - std::trunc(exact)) - 0.5);
+            if (distanceToTie < 0.02) {
+                // Within the quantization error of a tie either neighbour is acceptable.
+                ++nearTieCount;
+                ASSERT_LE(std::abs(actual[i] - expected[i]), 1) << "layer " << layer << " value " << i;
+            }
+            else {
+                ASSERT_EQ(actual[i], expected[i]) << "layer " << layer << " value " << i;
+            }
+        }
+    }
+    // Sanity check that the tolerance band only covers a small fraction of the corpus.
+    EXPECT_LT(nearTieCount, pointCount * 2 * 25 / 10);
+}
+
+namespace {
+    // applyToBits spelled out one value at a time, as the scalar loop computes it.
+    void expectMatchesScalarPath(const FixedPointTransform& t, const std::vector<float>& xy, const std::vector<INT>& out) {
+        for (size_t i = 0; i < xy.size() / 2; ++i) {
+            const int64_t x = FixedPointTransform::toFixedInput(xy[2 * i]);
+            const int64_t y = FixedPointTransform::toFixedInput(xy[2 * i + 1]);
+            ASSERT_EQ(out[2 * i], FixedPointTransform::roundToBits(t.a * x + t.b * y + t.tx)) << "point " << i;
+            ASSERT_EQ(out[2 * i + 1], FixedPointTransform::roundToBits(t.c * x + t.d * y + t.ty)) << "point " << i;
+        }
+    }
+}
+
+TEST(FixedPointTransform_Test, ApplyToBits_OddPointCountUpToTheInputLimit_MatchesScalarPathExactly) {
+    std::mt19937 rng(99);
+    const float limit = static_cast<float>(FixedPointTransform::INPUT_LIMIT_MM);
+    std::uniform_real_distribution<float> coordDist(-limit, limit);
+    const FixedPointTransform fixed = FixedPointTransform::fromAffine(makeTypicalLayerTransform(-71.0, 25.0, -13.5));
+    ASSERT_TRUE(fixed.hasInt32Multipliers());
+
+    const size_t pointCount = 4001; // Odd, so the scalar tail runs too.
+    std::vector<float> xy(pointCount * 2);
+    for (auto& v : xy) v = coordDist(rng);
+    xy[0] = limit;
+    xy[1] = -limit;
+    xy[2] = -0.0f;
+    xy[3] = std::nextafter(0.0f, 1.0f);
+    std::vector<INT> out(pointCount * 2);
+
+    fixed.applyToBits(xy.data(), pointCount, out.data());
+
+    expectMatchesScalarPath(fixed, xy, out);
+}
+
+TEST(FixedPointTransform_Test, ApplyToBits_MultipliersBeyond32Bits_MatchScalarPathExactly) {
+    // 40000 bits/mm is a multiplier above 2^31 in Q16.
+    const FixedPointTransform fixed = FixedPointTransform::fromAffine(AffineTransform::rotationDeg(30.0)
+        .then(AffineTransform::scaling(40000.0, 40000.0)));
+    ASSERT_FALSE(fixed.hasInt32Multipliers());
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> coordDist(-50.0f, 50.0f);
+    std::vector<float> xy(2 * 101);
+    for (auto& v : xy) v = coordDist(rng);
+    std::vector<INT> out(xy.size());
+
+    fixed.applyToBits(xy.data(), xy.size() / 2, out.data());
+
+    expectMatchesScalarPath(fixed, xy, out);
+}
+
+TEST(FixedPointTransform_Test, ApplyToBits3D_RandomizedCorpus_ConformsToDoublePath) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> coordDist(-60.0f, 60.0f);
+    const AffineTransform reference = makeTypicalLayerTransform(12.0, 3.5, -8.25);
+    const FixedPointTransform fixed = FixedPointTransform::fromAffine(reference);
+
+    const size_t pointCount = 5000;
+    std::vector<float> xyz(pointCount * 3);
+    for (auto& v : xyz) v = coordDist(rng);
+    std::vector<INT> expected(pointCount * 3);
+    std::vector<INT> actual(pointCount * 3);
+
+    reference.applyToBits3D(xyz.data(), pointCount, 4000.0, expected.data());
+    fixed.applyToBits3D(xyz.data(), pointCount, 4000.0, actual.data());
+
+    for (size_t i = 0; i < pointCount * 3; ++i) {
+        ASSERT_LE(std::abs(actual[i] - expected[i]), 1) << "value " << i;
+    }
+}
\ No newline at end of file
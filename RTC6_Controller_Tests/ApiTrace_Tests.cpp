@@ -0,0 +1,136 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "ApiTrace.h"
+#include "MockRtcApi.h"
+#include "Rtc6Constants.h"
+#include "Rtc6Exception.h"
+#include <sstream>
+
+using ::testing::Return;
+using ::testing::InSequence;
+using ::testing::NiceMock;
+
+namespace {
+    // Records a short list load and start, the way ListHandler issues it.
+    std::string recordSession(InterfaceRtcApi& board, size_t capacity = RecordingRtcApi::DEFAULT_CAPACITY) {
+        std::ostringstream trace(std::ios::binary);
+        {
+            RecordingRtcApi recorder(board, trace, capacity);
+            recorder.api_set_start_list(2);
+            recorder.api_set_mark_speed(4000.5);
+            recorder.api_jump_abs(-100, 200);
+            recorder.api_mark_abs(300, -400);
+            recorder.api_set_wobbel_mode(40, 20, 500.0, -1);
+            recorder.api_set_end_of_list();
+            recorder.api_execute_list(2);
+            recorder.api_read_status();
+        }
+        return trace.str();
+    }
+}
+
+TEST(RecordingRtcApi_Test, EveryCall_IsForwardedWithItsArgumentsAndResult) {
+    MockRtcApi board;
+    {
+        InSequence seq;
+        EXPECT_CALL(board, api_set_start_list(2));
+        EXPECT_CALL(board, api_set_mark_speed(4000.5));
+        EXPECT_CALL(board, api_jump_abs(-100, 200));
+        EXPECT_CALL(board, api_mark_abs(300, -400));
+        EXPECT_CALL(board, api_set_wobbel_mode(40u, 20u, 500.0, -1));
+        EXPECT_CALL(board, api_set_end_of_list());
+        EXPECT_CALL(board, api_execute_list(2));
+        EXPECT_CALL(board, api_read_status()).WillOnce(Return(Rtc6Constants::Status::BUSY2));
+    }
+
+    recordSession(board);
+}
+
+TEST(RecordingRtcApi_Test, Trace_ReadsBackWithListIdsAndOrderedTimestamps) {
+    NiceMock<MockRtcApi> board;
+    ON_CALL(board, api_read_status()).WillByDefault(Return(Rtc6Constants::Status::BUSY2));
+
+    std::istringstream in(recordSession(board, 2)); // Tiny buffer: the caller must wait, not drop.
+    const std::vector<ApiTraceRecord> records = readApiTrace(in);
+
+    ASSERT_EQ(records.size(), 8u);
+    EXPECT_EQ(records[0].call, ApiCall::SetStartList);
+    EXPECT_EQ(records[1].value, 4000.5);
+    EXPECT_EQ(records[2].call, ApiCall::JumpAbs);
+    EXPECT_EQ(records[2].args[0], -100);
+    EXPECT_EQ(records[2].args[1], 200);
+    EXPECT_EQ(records[4].args[2], -1);
+    EXPECT_EQ(records[4].value, 500.0);
+    for (size_t i = 0; i < 6; ++i) {
+        EXPECT_EQ(records[i].listNo, 2) << "record " << i;
+    }
+    EXPECT_EQ(records[6].listNo, 2);   // execute_list
+    EXPECT_EQ(records[7].listNo, 0);   // read_status
+    EXPECT_EQ(records[7].args[0], static_cast<INT>(Rtc6Constants::Status::BUSY2));
+    for (size_t i = 1; i < records.size(); ++i) {
+        EXPECT_GE(records[i].timestampNs, records[i - 1].timestampNs);
+    }
+}
+
+TEST(ApiTrace_Test, ReadApiTrace_RejectsForeignAndTruncatedFiles) {
+    std::istringstream notATrace("this is not a trace at all");
+    EXPECT_THROW(readApiTrace(notATrace), FileParseError);
+
+    NiceMock<MockRtcApi> board;
+    std::string trace = recordSession(board);
+    trace.resize(trace.size() - 5);
+    std::istringstream truncated(trace);
+    EXPECT_THROW(readApiTrace(truncated), FileParseError);
+}
+
+TEST(ApiTrace_Test, Replay_IssuesTheRecordedCallsInOrder) {
+    NiceMock<MockRtcApi> recordedBoard;
+    std::istringstream in(recordSession(recordedBoard));
+    const std::vector<ApiTraceRecord> records = readApiTrace(in);
+
+    MockRtcApi target;
+    {
+        InSequence seq;
+        EXPECT_CALL(target, api_set_start_list(2));
+        EXPECT_CALL(target, api_set_mark_speed(4000.5));
+        EXPECT_CALL(target, api_jump_abs(-100, 200));
+        EXPECT_CALL(target, api_mark_abs(300, -400));
+        EXPECT_CALL(target, api_set_wobbel_mode(40u, 20u, 500.0, -1));
+        EXPECT_CALL(target, api_set_end_of_list());
+        EXPECT_CALL(target, api_execute_list(2));
+        EXPECT_CALL(target, api_read_status()).WillOnce(Return(0u));
+    }
+
+    const ReplayStats stats = replayApiTrace(records, target, ReplaySpeed::Maximum);
+    EXPECT_EQ(stats.calls, 8u);
+    EXPECT_EQ(stats.extraStatusPolls, 0u);
+}
+
+TEST(ApiTrace_Test, Replay_WaitsUntilTheTargetIsNoBusierThanTheRecording) {
+    ApiTraceRecord idlePoll;
+    idlePoll.call = ApiCall::ReadStatus;
+    idlePoll.args[0] = 0;
+
+    MockRtcApi target;
+    EXPECT_CALL(target, api_read_status())
+        .WillOnce(Return(Rtc6Constants::Status::BUSY1))
+        .WillOnce(Return(Rtc6Constants::Status::BUSY1))
+        .WillOnce(Return(0u));
+
+    const ReplayStats stats = replayApiTrace({ idlePoll }, target, ReplaySpeed::Maximum);
+    EXPECT_EQ(stats.calls, 1u);
+    EXPECT_EQ(stats.extraStatusPolls, 2u);
+}
+
+TEST(ApiTrace_Test, ReplayAtOriginalSpeed_KeepsTheRecordedSpacing) {
+    ApiTraceRecord first;
+    first.call = ApiCall::SetEndOfList;
+    first.timestampNs = 1000000;
+    ApiTraceRecord second = first;
+    second.timestampNs = 4000000;
+
+    NiceMock<MockRtcApi> target;
+    const ReplayStats stats = replayApiTrace({ first, second }, target, ReplaySpeed::Original);
+    EXPECT_GE(stats.elapsedUs, 3000.0);
+}
\ No newline at end of file
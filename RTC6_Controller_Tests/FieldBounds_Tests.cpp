@@ -0,0 +1,113 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "FieldBounds.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST(FieldBounds_Test, ComputeBitBounds_RandomOddCount_MatchesScalarMinMax) {
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<INT> dist(-600000, 600000);
+    const size_t pointCount = 1001;
+    std::vector<INT> xy(pointCount * 2);
+    for (auto& v : xy) v = dist(rng);
+
+    const BitBounds b = FieldBounds::computeBitBounds(xy.data(), pointCount, 2);
+
+    INT xMin = xy[0], xMax = xy[0], yMin = xy[1], yMax = xy[1];
+    for (size_t i = 0; i < pointCount; ++i) {
+        xMin = std::min(xMin, xy[2 * i]); xMax = std::max(xMax, xy[2 * i]);
+        yMin = std::min(yMin, xy[2 * i + 1]); yMax = std::max(yMax, xy[2 * i + 1]);
+    }
+    EXPECT_EQ(b.xMin, xMin);
+    EXPECT_EQ(b.xMax, xMax);
+    EXPECT_EQ(b.yMin, yMin);
+    EXPECT_EQ(b.yMax, yMax);
+}
+
+TEST(FieldBounds_Test, ComputeBitBounds_Stride3_ChecksZAgainstTheField) {
+    const INT xyz[] = { 1, -2, 900000,   -5, 7, -3 };
+    const BitBounds b = FieldBounds::computeBitBounds(xyz, 2, 3);
+
+    EXPECT_EQ(b.xMin, -5);
+    EXPECT_EQ(b.xMax, 1);
+    EXPECT_EQ(b.yMin, -2);
+    EXPECT_EQ(b.yMax, 7);
+    EXPECT_EQ(b.zMin, -3);
+    EXPECT_EQ(b.zMax, 900000);
+    EXPECT_FALSE(FieldBounds::isInsideField(b));
+}
+
+TEST(FieldBounds_Test, IsInsideField_AtAndBeyondFieldEdge) {
+    EXPECT_TRUE(FieldBounds::isInsideField({ FieldBounds::FIELD_MIN_BITS, FieldBounds::FIELD_MIN_BITS,
+                                             FieldBounds::FIELD_MAX_BITS, FieldBounds::FIELD_MAX_BITS }));
+    EXPECT_FALSE(FieldBounds::isInsideField({ 0, 0, FieldBounds::FIELD_MAX_BITS + 1, 0 }));
+    EXPECT_FALSE(FieldBounds::isInsideField({ 0, FieldBounds::FIELD_MIN_BITS - 1, 0, 0 }));
+}
+
+TEST(FieldBounds_Test, CountOutsideField_CountsOnlyOffendingPoints) {
+    const INT xy[] = { 10, 20,   700000, -5,   -3, -700000 };
+    EXPECT_EQ(FieldBounds::countOutsideField(xy, 3, 2), 2u);
+}
+
+TEST(FieldBounds_Test, ClipSegmentToField_LeavingTheField_EndsAtTheExitPoint) {
+    const INT from[] = { FieldBounds::FIELD_MAX_BITS - 100, 0 };
+    const INT to[] = { FieldBounds::FIELD_MAX_BITS + 100, 200 };
+    ClippedSegment segment;
+
+    ASSERT_TRUE(FieldBounds::clipSegmentToField(from, to, 2, segment));
+    EXPECT_EQ(segment.start[0], from[0]);
+    EXPECT_EQ(segment.start[1], 0);
+    EXPECT_EQ(segment.end[0], FieldBounds::FIELD_MAX_BITS);
+    EXPECT_EQ(segment.end[1], 100);
+    EXPECT_FALSE(segment.startClipped);
+    EXPECT_TRUE(segment.endClipped);
+}
+
+TEST(FieldBounds_Test, ClipSegmentToField_CrossingTheField_IsCutAtBothEdges) {
+    const INT from[] = { -600000, 5 };
+    const INT to[] = { 600000, 5 };
+    ClippedSegment segment;
+
+    ASSERT_TRUE(FieldBounds::clipSegmentToField(from, to, 2, segment));
+    EXPECT_EQ(segment.start[0], FieldBounds::FIELD_MIN_BITS);
+    EXPECT_EQ(segment.end[0], FieldBounds::FIELD_MAX_BITS);
+    EXPECT_EQ(segment.start[1], 5);
+    EXPECT_EQ(segment.end[1], 5);
+    EXPECT_TRUE(segment.startClipped);
+    EXPECT_TRUE(segment.endClipped);
+}
+
+TEST(FieldBounds_Test, ClipSegmentToField_EntirelyOutside_ReturnsFalse) {
+    // Both axes cross the field's range, but never at the same time.
+    const INT from[] = { 900000, 0 };
+    const INT to[] = { 0, 1800000 };
+    ClippedSegment segment;
+
+    EXPECT_FALSE(FieldBounds::clipSegmentToField(from, to, 2, segment));
+}
+
+TEST(FieldBounds_Test, ClipSegmentToField_ZLeavingTheField_IsClippedOnlyIn3D) {
+    const INT from[] = { 0, 0, 0 };
+    const INT to[] = { 1000, 0, 2 * FieldBounds::FIELD_MAX_BITS };
+    ClippedSegment segment;
+
+    ASSERT_TRUE(FieldBounds::clipSegmentToField(from, to, 3, segment));
+    EXPECT_EQ(segment.end[0], 500);
+    EXPECT_EQ(segment.end[2], FieldBounds::FIELD_MAX_BITS);
+    EXPECT_TRUE(segment.endClipped);
+
+    ASSERT_TRUE(FieldBounds::clipSegmentToField(from, to, 2, segment));
+    EXPECT_EQ(segment.end[0], 1000);
+    EXPECT_FALSE(segment.endClipped);
+}
+
+TEST(FieldBounds_Test, ComputeMmBounds_InterleavedFloats_ReturnsBox) {
+    const float xy[] = { 1.5f, -2.0f,   -4.0f, 3.0f,   0.0f, 8.25f };
+    const MmBounds b = FieldBounds::computeMmBounds(xy, 3, 2);
+
+    EXPECT_FLOAT_EQ(b.xMin, -4.0f);
+    EXPECT_FLOAT_EQ(b.xMax, 1.5f);
+    EXPECT_FLOAT_EQ(b.yMin, -2.0f);
+    EXPECT_FLOAT_EQ(b.yMax, 8.25f);
+}
\ No newline at end of file
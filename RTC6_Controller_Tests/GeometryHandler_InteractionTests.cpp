@@ -10,11 +10,14 @@
 #include "open_vector_format.pb.h"
 #include "MachineConfig.h"
 #include "MockListHandler.h"
+#include "Rtc6Constants.h"
+#include "Rtc6Exception.h"
 #include <cmath>
 
 using ::testing::_;
 using ::testing::InSequence;
 using ::testing::DoubleEq;
+using ::testing::DoubleNear;
 
 MATCHER_P(IsCloseToInt, expected, "") {
     *result_listener << "where the value " << arg << " is compared to " << expected;
@@ -85,12 +88,14 @@ TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithHatches_CallsList
 
     {
         InSequence s;
+        EXPECT_CALL(mockListHandler, beginShape()); // The block's geometry is one shape.
         // Hatch 1
         EXPECT_CALL(mockListHandler, addJumpAbsolute(IsCloseToInt(1.0 * factor), IsCloseToInt(1.0 * factor)));
         EXPECT_CALL(mockListHandler, addMarkAbsolute(IsCloseToInt(10.0 * factor), IsCloseToInt(1.0 * factor)));
         // Hatch 2
         EXPECT_CALL(mockListHandler, addJumpAbsolute(IsCloseToInt(1.0 * factor), IsCloseToInt(2.0 * factor)));
         EXPECT_CALL(mockListHandler, addMarkAbsolute(IsCloseToInt(10.0 * factor), IsCloseToInt(2.0 * factor)));
+        EXPECT_CALL(mockListHandler, endShape());
     }
 
     // Act
@@ -100,7 +105,8 @@ TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithHatches_CallsList
 TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithUnsupportedType_SetsParamsButMakesNoGeometryCalls) {
     // Arrange
     open_vector_format::VectorBlock block;
-    block.mutable_point_sequence();
+    block.mutable__arcs()->add_centers(1.0f);
+    block.mutable__arcs()->add_centers(1.0f);
     open_vector_format::MarkingParams params;
 
     EXPECT_CALL(mockListHandler, addSetMarkSpeed(_)).Times(1);
@@ -258,5 +264,604 @@ TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_MaxPowerParameter_Cor
     EXPECT_CALL(mockListHandler, addMarkAbsolute(_, _));
 
     // Act
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_AfterBeginWorkPlaneWithOffset_ShiftsAllCoordinates) {
+    // Arrange: The layer is placed 5mm right and 2mm down on the plate.
+    open_vector_format::WorkPlane workPlane;
+    workPlane.set_x_pos_in_mm(5.0f);
+    workPlane.set_y_pos_in_mm(-2.0f);
+
+    open_vector_format::VectorBlock block;
+    auto* hatches = block.mutable__hatches();
+    hatches->add_points(1.0f); hatches->add_points(1.0f);
+    hatches->add_points(10.0f); hatches->add_points(1.0f);
+    open_vector_format::MarkingParams params;
+    const double factor = MachineConfig::MM_TO_BITS_CONVERSION_FACTOR;
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    {
+        InSequence s;
+        EXPECT_CALL(mockListHandler, addJumpAbsolute(IsCloseToInt(6.0 * factor), IsCloseToInt(-1.0 * factor)));
+        EXPECT_CALL(mockListHandler, addMarkAbsolute(IsCloseToInt(15.0 * factor), IsCloseToInt(-1.0 * factor)));
+    }
+
+    // Act
+    handler->beginWorkPlane(workPlane);
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_AfterBeginWorkPlaneWithRotation_RotatesBeforeOffsetting) {
+    // Arrange: Rotate the layer by 90 degrees, then move it 1mm along x.
+    open_vector_format::WorkPlane workPlane;
+    workPlane.set_z_rot_in_deg(90.0f);
+    workPlane.set_x_pos_in_mm(1.0f);
+
+    open_vector_format::VectorBlock block;
+    auto* line_seq = block.mutable_line_sequence();
+    line_seq->add_points(2.0f); line_seq->add_points(0.0f);
+    line_seq->add_points(2.0f); line_seq->add_points(3.0f);
+    open_vector_format::MarkingParams params;
+    const double factor = MachineConfig::MM_TO_BITS_CONVERSION_FACTOR;
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    {
+        InSequence s;
+        // (2,0) -> rotated (0,2) -> shifted (1,2); (2,3) -> rotated (-3,2) -> shifted (-2,2)
+        EXPECT_CALL(mockListHandler, addJumpAbsolute(IsCloseToInt(1.0 * factor), IsCloseToInt(2.0 * factor)));
+        EXPECT_CALL(mockListHandler, addMarkAbsolute(IsCloseToInt(-2.0 * factor), IsCloseToInt(2.0 * factor)));
+    }
+
+    // Act
+    handler->beginWorkPlane(workPlane);
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithLineSequence3D_Uses3DJumpAndMarkWithZBitScale) {
+    // Arrange
+    open_vector_format::VectorBlock block;
+    auto* line_seq = block.mutable_line_sequence_3d();
+    line_seq->add_points(1.0f); line_seq->add_points(2.0f); line_seq->add_points(0.5f);
+    line_seq->add_points(3.0f); line_seq->add_points(4.0f); line_seq->add_points(-0.5f);
+    line_seq->add_points(5.0f); line_seq->add_points(6.0f); line_seq->add_points(0.0f);
+    open_vector_format::MarkingParams params;
+    const double factor = MachineConfig::MM_TO_BITS_CONVERSION_FACTOR;
+    const double zFactor = MachineConfig::Z_MM_TO_BITS_CONVERSION_FACTOR;
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    EXPECT_CALL(mockListHandler, addJumpAbsolute(_, _)).Times(0);
+    EXPECT_CALL(mockListHandler, addMarkAbsolute(_, _)).Times(0);
+    {
+        InSequence s;
+        EXPECT_CALL(mockListHandler, addJumpAbsolute3D(IsCloseToInt(1.0 * factor), IsCloseToInt(2.0 * factor), IsCloseToInt(0.5 * zFactor)));
+        EXPECT_CALL(mockListHandler, addMarkAbsolute3D(IsCloseToInt(3.0 * factor), IsCloseToInt(4.0 * factor), IsCloseToInt(-0.5 * zFactor)));
+        EXPECT_CALL(mockListHandler, addMarkAbsolute3D(IsCloseToInt(5.0 * factor), IsCloseToInt(6.0 * factor), IsCloseToInt(0.0)));
+    }
+
+    // Act
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithHatches3D_MakesOne3DJumpAndMarkPerHatch) {
+    // Arrange: Two hatches at different heights.
+    open_vector_format::VectorBlock block;
+    auto* hatches = block.mutable_hatches_3d();
+    hatches->add_points(1.0f); hatches->add_points(1.0f); hatches->add_points(0.1f);
+    hatches->add_points(9.0f); hatches->add_points(1.0f); hatches->add_points(0.1f);
+    hatches->add_points(1.0f); hatches->add_points(2.0f); hatches->add_points(0.2f);
+    hatches->add_points(9.0f); hatches->add_points(2.0f); hatches->add_points(0.2f);
+    open_vector_format::MarkingParams params;
+    const double factor = MachineConfig::MM_TO_BITS_CONVERSION_FACTOR;
+    const double zFactor = MachineConfig::Z_MM_TO_BITS_CONVERSION_FACTOR;
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    {
+        InSequence s;
+        EXPECT_CALL(mockListHandler, addJumpAbsolute3D(IsCloseToInt(1.0 * factor), IsCloseToInt(1.0 * factor), IsCloseToInt(0.1 * zFactor)));
+        EXPECT_CALL(mockListHandler, addMarkAbsolute3D(IsCloseToInt(9.0 * factor), IsCloseToInt(1.0 * factor), IsCloseToInt(0.1 * zFactor)));
+        EXPECT_CALL(mockListHandler, addJumpAbsolute3D(IsCloseToInt(1.0 * factor), IsCloseToInt(2.0 * factor), IsCloseToInt(0.2 * zFactor)));
+        EXPECT_CALL(mockListHandler, addMarkAbsolute3D(IsCloseToInt(9.0 * factor), IsCloseToInt(2.0 * factor), IsCloseToInt(0.2 * zFactor)));
+    }
+
+    // Act
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithPointSequence3D_JumpsAndDwellsAtEachPoint) {
+    // Arrange: Two points exposed for 50 us each (5 RTC6 periods of 10 us).
+    open_vector_format::VectorBlock block;
+    auto* points = block.mutable_point_sequence_3d();
+    points->add_points(1.0f); points->add_points(2.0f); points->add_points(0.3f);
+    points->add_points(4.0f); points->add_points(5.0f); points->add_points(0.0f);
+    open_vector_format::MarkingParams params;
+    params.set_point_exposure_time_in_us(50.0f);
+    const double factor = MachineConfig::MM_TO_BITS_CONVERSION_FACTOR;
+    const double zFactor = MachineConfig::Z_MM_TO_BITS_CONVERSION_FACTOR;
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    EXPECT_CALL(mockListHandler, addMarkAbsolute3D(_, _, _)).Times(0);
+    {
+        InSequence s;
+        EXPECT_CALL(mockListHandler, addJumpAbsolute3D(IsCloseToInt(1.0 * factor), IsCloseToInt(2.0 * factor), IsCloseToInt(0.3 * zFactor)));
+        EXPECT_CALL(mockListHandler, addLaserOn(5u));
+        EXPECT_CALL(mockListHandler, addJumpAbsolute3D(IsCloseToInt(4.0 * factor), IsCloseToInt(5.0 * factor), IsCloseToInt(0.0)));
+        EXPECT_CALL(mockListHandler, addLaserOn(5u));
+    }
+
+    // Act
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithPointSequenceAndRepetitions_FoldsRepetitionsIntoOneLaserOnPerPoint) {
+    // Arrange: Three points, each exposed 3 times for 20 us -> one 60 us dwell (6 periods).
+    open_vector_format::VectorBlock block;
+    auto* points = block.mutable_point_sequence();
+    points->add_points(1.0f); points->add_points(1.0f);
+    points->add_points(2.0f); points->add_points(2.0f);
+    points->add_points(3.0f); points->add_points(3.0f);
+    open_vector_format::MarkingParams params;
+    params.set_point_exposure_time_in_us(20.0f);
+    params.set_point_exposure_repetitions(3.0f);
+    const double factor = MachineConfig::MM_TO_BITS_CONVERSION_FACTOR;
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    EXPECT_CALL(mockListHandler, addMarkAbsolute(_, _)).Times(0);
+    {
+        InSequence s;
+        for (int i = 1; i <= 3; ++i) {
+            // Exactly two list commands per point, independent of the repetition count.
+            EXPECT_CALL(mockListHandler, addJumpAbsolute(IsCloseToInt(i * factor), IsCloseToInt(i * factor)));
+            EXPECT_CALL(mockListHandler, addLaserOn(6u));
+        }
+    }
+
+    // Act
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithPointSequenceAndZeroExposureTime_OnlyJumps) {
+    // Arrange
+    open_vector_format::VectorBlock block;
+    auto* points = block.mutable_point_sequence();
+    points->add_points(1.0f); points->add_points(1.0f);
+    open_vector_format::MarkingParams params;
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    EXPECT_CALL(mockListHandler, addJumpAbsolute(_, _)).Times(1);
+    EXPECT_CALL(mockListHandler, addLaserOn(_)).Times(0);
+
+    // Act
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithPowerParaAdapt_EmitsPowerOnlyWhenQuantizedValueChanges) {
+    // Arrange: Five vertices. Segment means are 100W, 100W, 150W, 200W.
+    open_vector_format::VectorBlock block;
+    auto* seq = block.mutable_line_sequence_para_adapt();
+    seq->set_parameter(open_vector_format::VectorBlock::LineSequenceParaAdapt::LASER_POWER_IN_W);
+    const float vertices[5][3] = { {0, 0, 100}, {1, 0, 100}, {2, 0, 100}, {3, 0, 200}, {4, 0, 200} };
+    for (const auto& v : vertices) {
+        seq->add_points_with_paras(v[0]); seq->add_points_with_paras(v[1]); seq->add_points_with_paras(v[2]);
+    }
+    open_vector_format::MarkingParams params;
+    params.set_laser_power_in_w(100.0f);
+    const double factor = MachineConfig::MM_TO_BITS_CONVERSION_FACTOR;
+    auto dacFor = [](double watts) { return (watts / MachineConfig::MAX_LASER_POWER_W) * 4095.0; };
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    {
+        InSequence s;
+        EXPECT_CALL(mockListHandler, addSetLaserPower(1, IsCloseToInt(dacFor(100.0))));
+        EXPECT_CALL(mockListHandler, addJumpAbsolute(IsCloseToInt(0.0), IsCloseToInt(0.0)));
+        EXPECT_CALL(mockListHandler, addMarkAbsolute(IsCloseToInt(1.0 * factor), _));
+        EXPECT_CALL(mockListHandler, addMarkAbsolute(IsCloseToInt(2.0 * factor), _));
+        EXPECT_CALL(mockListHandler, addSetLaserPower(1, IsCloseToInt(dacFor(150.0))));
+        EXPECT_CALL(mockListHandler, addMarkAbsolute(IsCloseToInt(3.0 * factor), _));
+        EXPECT_CALL(mockListHandler, addSetLaserPower(1, IsCloseToInt(dacFor(200.0))));
+        EXPECT_CALL(mockListHandler, addMarkAbsolute(IsCloseToInt(4.0 * factor), _));
+    }
+
+    // Act
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithFocusParaAdaptHatches_EmitsDefocusChangesPerHatch) {
+    // Arrange: Two single-segment hatches ramping the focus shift.
+    open_vector_format::VectorBlock block;
+    auto* hatches = block.mutable__hatchparaadapt();
+    for (float focus : { 1.0f, 2.0f }) {
+        auto* seq = hatches->add_hatchaslinesequence();
+        seq->set_parameter(open_vector_format::VectorBlock::LineSequenceParaAdapt::LASER_FOCUS_SHIFT_IN_MM);
+        seq->add_points_with_paras(0.0f); seq->add_points_with_paras(focus); seq->add_points_with_paras(focus);
+        seq->add_points_with_paras(5.0f); seq->add_points_with_paras(focus); seq->add_points_with_paras(focus);
+    }
+    open_vector_format::MarkingParams params;
+    const double factor = MachineConfig::MM_TO_BITS_CONVERSION_FACTOR;
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    {
+        InSequence s;
+        EXPECT_CALL(mockListHandler, addSetFocusOffset(0));
+        EXPECT_CALL(mockListHandler, addJumpAbsolute(_, _));
+        EXPECT_CALL(mockListHandler, addSetFocusOffset(IsCloseToInt(1.0 * factor)));
+        EXPECT_CALL(mockListHandler, addMarkAbsolute(_, _));
+        EXPECT_CALL(mockListHandler, addJumpAbsolute(_, _));
+        EXPECT_CALL(mockListHandler, addSetFocusOffset(IsCloseToInt(2.0 * factor)));
+        EXPECT_CALL(mockListHandler, addMarkAbsolute(_, _));
+    }
+
+    // Act
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithPowerParaAdaptHatchesReturningToBase_RestoresBasePower) {
+    // Arrange: First hatch runs at 200W, second hatch back at the block's 100W base power.
+    open_vector_format::VectorBlock block;
+    auto* hatches = block.mutable__hatchparaadapt();
+    for (float power : { 200.0f, 100.0f }) {
+        auto* seq = hatches->add_hatchaslinesequence();
+        seq->set_parameter(open_vector_format::VectorBlock::LineSequenceParaAdapt::LASER_POWER_IN_W);
+        seq->add_points_with_paras(0.0f); seq->add_points_with_paras(0.0f); seq->add_points_with_paras(power);
+        seq->add_points_with_paras(5.0f); seq->add_points_with_paras(0.0f); seq->add_points_with_paras(power);
+    }
+    open_vector_format::MarkingParams params;
+    params.set_laser_power_in_w(100.0f);
+    auto dacFor = [](double watts) { return (watts / MachineConfig::MAX_LASER_POWER_W) * 4095.0; };
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    {
+        InSequence s;
+        EXPECT_CALL(mockListHandler, addSetLaserPower(1, IsCloseToInt(dacFor(100.0))));
+        EXPECT_CALL(mockListHandler, addJumpAbsolute(_, _));
+        EXPECT_CALL(mockListHandler, addSetLaserPower(1, IsCloseToInt(dacFor(200.0))));
+        EXPECT_CALL(mockListHandler, addMarkAbsolute(_, _));
+        EXPECT_CALL(mockListHandler, addJumpAbsolute(_, _));
+        EXPECT_CALL(mockListHandler, addSetLaserPower(1, IsCloseToInt(dacFor(100.0))));
+        EXPECT_CALL(mockListHandler, addMarkAbsolute(_, _));
+    }
+
+    // Act
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithMicroHatchInVolume_DropsItAndReportsStats) {
+    // Arrange: a 1 mm hatch followed by one far below the VOLUME minimum length.
+    open_vector_format::VectorBlock block;
+    auto* hatches = block.mutable__hatches();
+    for (float v : { 0.0f, 0.0f, 1.0f, 0.0f,   5.0f, 5.0f, 5.001f, 5.0f }) hatches->add_points(v);
+    block.mutable_lpbf_metadata()->set_part_area(open_vector_format::VectorBlock::VOLUME);
+    open_vector_format::MarkingParams params;
+    params.set_laser_speed_in_mm_per_s(1000.0f);
+    handler->setShortVectorThresholds(open_vector_format::VectorBlock::VOLUME, { 0.01, 0.002 });
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    EXPECT_CALL(mockListHandler, addJumpAbsolute(_, _)).Times(1);
+    EXPECT_CALL(mockListHandler, addMarkAbsolute(_, _)).Times(1);
+
+    // Act
+    handler->beginWorkPlane(open_vector_format::WorkPlane());
+    handler->processVectorBlock(block, params);
+
+    // Assert
+    const ShortVectorStats stats = handler->getShortVectorStats();
+    EXPECT_EQ(stats.droppedVectors, 1u);
+    EXPECT_GE(stats.estimatedTimeSavedUs, MachineConfig::ESTIMATED_VECTOR_OVERHEAD_US);
+
+    // The statistics are per layer.
+    handler->beginWorkPlane(open_vector_format::WorkPlane());
+    EXPECT_EQ(handler->getShortVectorStats().droppedVectors, 0u);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithMicroHatchInContour_KeepsIt) {
+    // Arrange: every part area has the filter disabled by default.
+    open_vector_format::VectorBlock block;
+    auto* hatches = block.mutable__hatches();
+    for (float v : { 5.0f, 5.0f, 5.001f, 5.0f }) hatches->add_points(v);
+    block.mutable_lpbf_metadata()->set_part_area(open_vector_format::VectorBlock::CONTOUR);
+    open_vector_format::MarkingParams params;
+    for (const auto& thresholds : MachineConfig::SHORT_VECTOR_THRESHOLDS) {
+        ASSERT_EQ(thresholds.minLengthMm, 0.0);
+    }
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    EXPECT_CALL(mockListHandler, addJumpAbsolute(_, _)).Times(1);
+    EXPECT_CALL(mockListHandler, addMarkAbsolute(_, _)).Times(1);
+
+    // Act
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_OutsideScanField_ThrowsGeometryErrorBeforeEmittingGeometry) {
+    // Arrange: a WorkPlane offset that pushes the line past the +-2^19 bit field.
+    open_vector_format::WorkPlane workPlane;
+    workPlane.set_x_pos_in_mm(static_cast<float>((FieldBounds::FIELD_MAX_BITS + 1000) / MachineConfig::MM_TO_BITS_CONVERSION_FACTOR));
+    open_vector_format::VectorBlock block;
+    auto* line_seq = block.mutable_line_sequence();
+    line_seq->add_points(0.0f); line_seq->add_points(0.0f);
+    line_seq->add_points(1.0f); line_seq->add_points(0.0f);
+    open_vector_format::MarkingParams params;
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    EXPECT_CALL(mockListHandler, addJumpAbsolute(_, _)).Times(0);
+    EXPECT_CALL(mockListHandler, addMarkAbsolute(_, _)).Times(0);
+
+    // Act & Assert
+    handler->beginWorkPlane(workPlane);
+    EXPECT_THROW(handler->processVectorBlock(block, params), GeometryError);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_LineLeavingAndReenteringWithClipPolicy_JumpsOverTheOutsidePart) {
+    // Arrange: the line runs 200 mm (800000 bits) out along x and comes back to (0, 10) mm.
+    open_vector_format::VectorBlock block;
+    auto* line_seq = block.mutable_line_sequence();
+    line_seq->add_points(0.0f); line_seq->add_points(0.0f);
+    line_seq->add_points(200.0f); line_seq->add_points(0.0f);
+    line_seq->add_points(0.0f); line_seq->add_points(10.0f);
+    open_vector_format::MarkingParams params;
+    handler->setOutOfFieldPolicy(MachineConfig::OutOfFieldPolicy::Clip);
+
+    const double factor = MachineConfig::MM_TO_BITS_CONVERSION_FACTOR;
+    const double reentryT = (FieldBounds::FIELD_MAX_BITS - 200.0 * factor) / (-200.0 * factor);
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    {
+        InSequence s;
+        EXPECT_CALL(mockListHandler, addJumpAbsolute(0, 0));
+        EXPECT_CALL(mockListHandler, addMarkAbsolute(FieldBounds::FIELD_MAX_BITS, 0));
+        EXPECT_CALL(mockListHandler, addJumpAbsolute(FieldBounds::FIELD_MAX_BITS, IsCloseToInt(reentryT * 10.0 * factor)));
+        EXPECT_CALL(mockListHandler, addMarkAbsolute(0, IsCloseToInt(10.0 * factor)));
+    }
+
+    // Act
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_HatchesOutsideScanFieldWithClipPolicy_DropsOrShortensThem) {
+    // Arrange: one hatch entirely outside the field, one that runs past its +x edge.
+    open_vector_format::VectorBlock block;
+    auto* hatches = block.mutable__hatches();
+    hatches->add_points(150.0f); hatches->add_points(0.0f);
+    hatches->add_points(160.0f); hatches->add_points(0.0f);
+    hatches->add_points(100.0f); hatches->add_points(5.0f);
+    hatches->add_points(200.0f); hatches->add_points(5.0f);
+    open_vector_format::MarkingParams params;
+    handler->setOutOfFieldPolicy(MachineConfig::OutOfFieldPolicy::Clip);
+
+    const double factor = MachineConfig::MM_TO_BITS_CONVERSION_FACTOR;
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    {
+        InSequence s;
+        EXPECT_CALL(mockListHandler, addJumpAbsolute(IsCloseToInt(100.0 * factor), IsCloseToInt(5.0 * factor)));
+        EXPECT_CALL(mockListHandler, addMarkAbsolute(FieldBounds::FIELD_MAX_BITS, IsCloseToInt(5.0 * factor)));
+    }
+
+    // Act
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_3DLineWithZOutsideScanField_ThrowsGeometryError) {
+    // Arrange: x and y stay inside the field, z does not.
+    open_vector_format::VectorBlock block;
+    auto* line_seq = block.mutable_line_sequence_3d();
+    line_seq->add_points(0.0f); line_seq->add_points(0.0f); line_seq->add_points(0.0f);
+    line_seq->add_points(1.0f); line_seq->add_points(0.0f);
+    line_seq->add_points(static_cast<float>(2.0 * FieldBounds::FIELD_MAX_BITS / MachineConfig::Z_MM_TO_BITS_CONVERSION_FACTOR));
+    open_vector_format::MarkingParams params;
+
+    EXPECT_CALL(mockListHandler, addJumpAbsolute3D(_, _, _)).Times(0);
+    EXPECT_CALL(mockListHandler, addMarkAbsolute3D(_, _, _)).Times(0);
+
+    // Act & Assert
+    EXPECT_THROW(handler->processVectorBlock(block, params), GeometryError);
+}
+
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithTimingParams_MapsThemToBoardUnits) {
+    open_vector_format::VectorBlock block;
+    auto* line_seq = block.mutable_line_sequence();
+    line_seq->add_points(0.0f); line_seq->add_points(0.0f);
+    line_seq->add_points(1.0f); line_seq->add_points(0.0f);
+    open_vector_format::MarkingParams params;
+    params.set_jump_speed_in_mm_s(7500.0f);
+    params.set_jump_delay_in_us(120.0f);
+    params.set_mark_delay_in_us(64.0f);
+    params.set_polygon_delay_in_us(5.0f);
+    params.set_laser_on_delay_in_us(-1.5f);
+    params.set_laser_off_delay_in_us(20.0f);
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    EXPECT_CALL(mockListHandler, addSetJumpSpeed(DoubleEq(7500.0)));
+    EXPECT_CALL(mockListHandler, addSetScannerDelays(12u, 6u, 1u)); // 10 us steps, rounded
+    EXPECT_CALL(mockListHandler, addSetLaserDelays(-96, 1280u));    // 1/64 us steps
+    EXPECT_CALL(mockListHandler, addJumpAbsolute(_, _));
+    EXPECT_CALL(mockListHandler, addMarkAbsolute(_, _));
+
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithoutTimingParams_LeavesBoardSettingsAlone) {
+    open_vector_format::VectorBlock block;
+    auto* line_seq = block.mutable_line_sequence();
+    line_seq->add_points(0.0f); line_seq->add_points(0.0f);
+    line_seq->add_points(1.0f); line_seq->add_points(0.0f);
+    open_vector_format::MarkingParams params;
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    EXPECT_CALL(mockListHandler, addSetJumpSpeed(_)).Times(0);
+    EXPECT_CALL(mockListHandler, addSetScannerDelays(_, _, _)).Times(0);
+    EXPECT_CALL(mockListHandler, addSetLaserDelays(_, _)).Times(0);
+    EXPECT_CALL(mockListHandler, addJumpAbsolute(_, _));
+    EXPECT_CALL(mockListHandler, addMarkAbsolute(_, _));
+
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithSkyWritingMode3_EmitsParamsLimitThenMode) {
+    open_vector_format::VectorBlock block;
+    auto* line_seq = block.mutable_line_sequence();
+    line_seq->add_points(0.0f); line_seq->add_points(0.0f);
+    line_seq->add_points(1.0f); line_seq->add_points(0.0f);
+    open_vector_format::MarkingParams params;
+    params.set_marking_mode(open_vector_format::MarkingParams::SKY_3);
+    params.set_time_lag_in_us(174.0f);
+    params.set_laser_on_shift_in_us(-0.5f);
+    params.set_n_prev_in_us(94.0f);
+    params.set_n_post_in_us(36.0f);
+    params.set_limit(0.8f);
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    {
+        InSequence s;
+        EXPECT_CALL(mockListHandler, addSetSkyWritingParams(DoubleEq(174.0), -32, 9u, 4u)); // 1/64 us, 10 us steps
+        EXPECT_CALL(mockListHandler, addSetSkyWritingLimit(DoubleNear(0.8, 1e-6)));
+        EXPECT_CALL(mockListHandler, addSetSkyWritingMode(3u));
+        EXPECT_CALL(mockListHandler, addJumpAbsolute(_, _));
+        EXPECT_CALL(mockListHandler, addMarkAbsolute(_, _));
+    }
+
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithoutSkyWriting_OnlySwitchesModeOff) {
+    open_vector_format::VectorBlock block;
+    auto* line_seq = block.mutable_line_sequence();
+    line_seq->add_points(0.0f); line_seq->add_points(0.0f);
+    line_seq->add_points(1.0f); line_seq->add_points(0.0f);
+    open_vector_format::MarkingParams params;
+    params.set_n_prev_in_us(94.0f); // Ignored without a sky-writing mode.
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    EXPECT_CALL(mockListHandler, addSetSkyWritingMode(0u));
+    EXPECT_CALL(mockListHandler, addSetSkyWritingParams(_, _, _, _)).Times(0);
+    EXPECT_CALL(mockListHandler, addSetSkyWritingLimit(_)).Times(0);
+    EXPECT_CALL(mockListHandler, addJumpAbsolute(_, _));
+    EXPECT_CALL(mockListHandler, addMarkAbsolute(_, _));
+
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithScanaheadDelayModel_SkipsDelayCommands) {
+    open_vector_format::VectorBlock block;
+    auto* line_seq = block.mutable_line_sequence();
+    line_seq->add_points(0.0f); line_seq->add_points(0.0f);
+    line_seq->add_points(1.0f); line_seq->add_points(0.0f);
+    open_vector_format::MarkingParams params;
+    params.set_jump_speed_in_mm_s(7500.0f);
+    params.set_jump_delay_in_us(120.0f);
+    params.set_laser_off_delay_in_us(20.0f);
+    handler->setDelayModel(MachineConfig::DelayModel::ScanaheadAuto);
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    EXPECT_CALL(mockListHandler, addSetJumpSpeed(DoubleEq(7500.0)));
+    EXPECT_CALL(mockListHandler, addSetScannerDelays(_, _, _)).Times(0);
+    EXPECT_CALL(mockListHandler, addSetLaserDelays(_, _)).Times(0);
+    EXPECT_CALL(mockListHandler, addJumpAbsolute(_, _));
+    EXPECT_CALL(mockListHandler, addMarkAbsolute(_, _));
+
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithLyingEightWobble_MapsAmplitudesToBitsAndShape) {
+    open_vector_format::VectorBlock block;
+    auto* line_seq = block.mutable_line_sequence();
+    line_seq->add_points(0.0f); line_seq->add_points(0.0f);
+    line_seq->add_points(1.0f); line_seq->add_points(0.0f);
+    open_vector_format::MarkingParams params;
+    params.set_wobble_mode(open_vector_format::MarkingParams::LYING_EIGHT_WOBBLE);
+    params.set_wob_frequency_in_hz(1500.0f);
+    params.set_wob_amp_trans_in_mm(0.1f);
+    params.set_wob_amp_long_in_mm(0.05f);
+
+    const UINT expectedTrans = static_cast<UINT>(std::round(0.1f * MachineConfig::MM_TO_BITS_CONVERSION_FACTOR));
+    const UINT expectedLong = static_cast<UINT>(std::round(0.05f * MachineConfig::MM_TO_BITS_CONVERSION_FACTOR));
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    EXPECT_CALL(mockListHandler, addSetWobbleMode(expectedTrans, expectedLong, DoubleEq(1500.0), Rtc6Constants::Wobbel::MODE_LYING_EIGHT));
+    EXPECT_CALL(mockListHandler, addJumpAbsolute(_, _));
+    EXPECT_CALL(mockListHandler, addMarkAbsolute(_, _));
+
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithWobbleButNoFrequency_SwitchesWobbleOff) {
+    open_vector_format::VectorBlock block;
+    auto* line_seq = block.mutable_line_sequence();
+    line_seq->add_points(0.0f); line_seq->add_points(0.0f);
+    line_seq->add_points(1.0f); line_seq->add_points(0.0f);
+    open_vector_format::MarkingParams params;
+    params.set_wobble_mode(open_vector_format::MarkingParams::ELLIPSE_WOBBLE);
+    params.set_wob_amp_trans_in_mm(0.1f);
+
+    EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _));
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_));
+    EXPECT_CALL(mockListHandler, addSetWobbleMode(0u, 0u, DoubleEq(0.0), Rtc6Constants::Wobbel::MODE_ELLIPSE));
+    EXPECT_CALL(mockListHandler, addJumpAbsolute(_, _));
+    EXPECT_CALL(mockListHandler, addMarkAbsolute(_, _));
+
+    handler->processVectorBlock(block, params);
+}
+
+TEST_F(GeometryHandler_InteractionTest, ProcessVectorBlock_WithRepeats_EmitsTheBlockOnceInsideAListLoop) {
+    open_vector_format::VectorBlock block;
+    block.set_repeats(3);
+    auto* line_seq = block.mutable_line_sequence();
+    line_seq->add_points(0.0f); line_seq->add_points(0.0f);
+    line_seq->add_points(1.0f); line_seq->add_points(0.0f);
+    open_vector_format::MarkingParams params;
+
+    EXPECT_CALL(mockListHandler, addSetFocusOffset(_)).Times(::testing::AnyNumber());
+    EXPECT_CALL(mockListHandler, addSetLaserPower(_, _)).Times(::testing::AnyNumber());
+    EXPECT_CALL(mockListHandler, addSetSkyWritingMode(_)).Times(::testing::AnyNumber());
+    EXPECT_CALL(mockListHandler, addSetWobbleMode(_, _, _, _)).Times(::testing::AnyNumber());
+    {
+        InSequence s;
+        EXPECT_CALL(mockListHandler, addListRepeat());
+        EXPECT_CALL(mockListHandler, addSetMarkSpeed(_));
+        EXPECT_CALL(mockListHandler, addJumpAbsolute(_, _)).Times(1);
+        EXPECT_CALL(mockListHandler, addMarkAbsolute(_, _)).Times(1);
+        EXPECT_CALL(mockListHandler, addListUntil(4u));
+    }
+
     handler->processVectorBlock(block, params);
 }
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "LatencyHistogram.h"
+
+TEST(LatencyHistogram_Test, Record_PlacesSamplesInPowerOfTwoBuckets) {
+    LatencyHistogram histogram;
+    histogram.record(0.5);   // bucket 0: < 1 us
+    histogram.record(1.0);   // bucket 1: [1, 2)
+    histogram.record(3.0);   // bucket 2: [2, 4)
+    histogram.record(700.0); // bucket 10: [512, 1024)
+
+    EXPECT_EQ(histogram.count(), 4u);
+    EXPECT_EQ(histogram.bucketCount(0), 1u);
+    EXPECT_EQ(histogram.bucketCount(1), 1u);
+    EXPECT_EQ(histogram.bucketCount(2), 1u);
+    EXPECT_EQ(histogram.bucketCount(10), 1u);
+    EXPECT_DOUBLE_EQ(histogram.maxUs(), 700.0);
+    EXPECT_DOUBLE_EQ(histogram.meanUs(), 176.125);
+}
+
+TEST(LatencyHistogram_Test, Record_HugeLatency_LandsInLastBucket) {
+    LatencyHistogram histogram;
+    histogram.record(1.0e12);
+
+    EXPECT_EQ(histogram.bucketCount(LatencyHistogram::BUCKET_COUNT - 1), 1u);
+}
+
+TEST(LatencyHistogram_Test, PercentileUs_ReturnsUpperEdgeOfBucketCappedAtMax) {
+    LatencyHistogram histogram;
+    for (int i = 0; i < 99; ++i) histogram.record(10.0); // bucket [8, 16)
+    histogram.record(300.0);                             // bucket [256, 512)
+
+    EXPECT_DOUBLE_EQ(histogram.percentileUs(50.0), 16.0);
+    EXPECT_DOUBLE_EQ(histogram.percentileUs(99.0), 16.0);
+    EXPECT_DOUBLE_EQ(histogram.percentileUs(100.0), 300.0);
+    EXPECT_DOUBLE_EQ(LatencyHistogram().percentileUs(50.0), 0.0);
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include "ListHandler.h"
+#include "MachineConfig.h"
 #include "MockCommunicator.h"
 #include "MockRtcApi.h"
 #include "Rtc6Constants.h"
@@ -10,6 +11,7 @@ using ::testing::Return;
 using ::testing::_;
 using ::testing::NiceMock;
 using ::testing::DoubleEq;
+using ::testing::InSequence;
 
 class ListHandler_InteractionTest : public ::testing::Test {
 protected:
@@ -22,6 +24,7 @@ protected:
         mockRtcApi = std::make_unique<NiceMock<MockRtcApi>>();
 
         ON_CALL(*mockCommunicator, isSuccessfullySetup()).WillByDefault(Return(true));
+        ON_CALL(*mockRtcApi, api_get_list_space()).WillByDefault(Return(1u << 20));
 
         listHandler = std::make_unique<ListHandler>(*mockCommunicator, *mockRtcApi);
     }
@@ -145,10 +148,148 @@ TEST_F(ListHandler_InteractionTest, AddSetLaserPower_WithPortAndPower_CallsApiSe
 
 TEST_F(ListHandler_InteractionTest, AddSetMarkSpeed_WithSpeedInMmPerS_CallsApiWithCorrectlyCalculatedBitsPerMs) {
     const double speed_mm_s = 1000.0;
-    const double expected_bits_per_ms = 1000.0; // (1000 * 1000) / 1000 = 1000 bits/ms
+    const double expected_bits_per_ms = speed_mm_s * MachineConfig::MM_TO_BITS_CONVERSION_FACTOR / 1000.0;
 
     // We use a floating-point matcher to avoid precision issues.
     EXPECT_CALL(*mockRtcApi, api_set_mark_speed(DoubleEq(expected_bits_per_ms))).Times(1);
 
     listHandler->addSetMarkSpeed(speed_mm_s);
-}
\ No newline at end of file
+}
+
+TEST_F(ListHandler_InteractionTest, AddSetJumpSpeed_WithSpeedInMmPerS_CallsApiWithSameConversionAsMarkSpeed) {
+    EXPECT_CALL(*mockRtcApi, api_set_jump_speed(DoubleEq(5000.0 * MachineConfig::MM_TO_BITS_CONVERSION_FACTOR / 1000.0))).Times(1);
+
+    listHandler->addSetJumpSpeed(5000.0);
+}
+
+TEST_F(ListHandler_InteractionTest, AddSetScannerAndLaserDelays_PassBoardUnitsThrough) {
+    EXPECT_CALL(*mockRtcApi, api_set_scanner_delays(10u, 5u, 2u)).Times(1);
+    EXPECT_CALL(*mockRtcApi, api_set_laser_delays(-64, 128u)).Times(1);
+
+    listHandler->addSetScannerDelays(10, 5, 2);
+    listHandler->addSetLaserDelays(-64, 128);
+}
+
+TEST_F(ListHandler_InteractionTest, ParameterCommands_RepeatedValue_AreOnlyWrittenOnChange) {
+    EXPECT_CALL(*mockRtcApi, api_set_jump_speed(_)).Times(2);
+    EXPECT_CALL(*mockRtcApi, api_set_scanner_delays(_, _, _)).Times(1);
+    EXPECT_CALL(*mockRtcApi, api_set_laser_power(1u, 2000u)).Times(1);
+
+    listHandler->beginListPreparation();
+    listHandler->addSetJumpSpeed(5000.0);
+    listHandler->addSetScannerDelays(10, 5, 2);
+    listHandler->addSetLaserPower(1, 2000);
+    listHandler->addSetJumpSpeed(5000.0);      // repeat: dropped
+    listHandler->addSetScannerDelays(10, 5, 2); // repeat: dropped
+    listHandler->addSetLaserPower(1, 2000);    // repeat: dropped
+    listHandler->addSetJumpSpeed(8000.0);      // change: written
+
+    EXPECT_EQ(listHandler->getListCommandCount(), 4u);
+}
+
+TEST_F(ListHandler_InteractionTest, SkyWritingCommands_PassBoardUnitsAndSwitchModeOnlyOnChange) {
+    EXPECT_CALL(*mockRtcApi, api_set_sky_writing_para(DoubleEq(174.0), -32, 9u, 4u)).Times(1);
+    EXPECT_CALL(*mockRtcApi, api_set_sky_writing_limit(DoubleEq(0.5))).Times(1);
+    EXPECT_CALL(*mockRtcApi, api_set_sky_writing_mode(3u)).Times(1);
+    EXPECT_CALL(*mockRtcApi, api_set_sky_writing_mode(0u)).Times(1);
+
+    listHandler->beginListPreparation();
+    listHandler->addSetSkyWritingParams(174.0, -32, 9, 4);
+    listHandler->addSetSkyWritingLimit(0.5);
+    listHandler->addSetSkyWritingMode(3);
+    listHandler->addSetSkyWritingParams(174.0, -32, 9, 4); // repeat: dropped
+    listHandler->addSetSkyWritingMode(3);                  // repeat: dropped
+    listHandler->addSetSkyWritingMode(0);                  // change: written
+}
+
+TEST_F(ListHandler_InteractionTest, AddSetWobbleMode_IsWrittenOnlyWhenShapeAmplitudeOrFrequencyChange) {
+    EXPECT_CALL(*mockRtcApi, api_set_wobbel_mode(400u, 200u, DoubleEq(1500.0), -1)).Times(1);
+    EXPECT_CALL(*mockRtcApi, api_set_wobbel_mode(400u, 200u, DoubleEq(2000.0), -1)).Times(1);
+    EXPECT_CALL(*mockRtcApi, api_set_wobbel_mode(0u, 0u, DoubleEq(0.0), 0)).Times(1);
+
+    listHandler->beginListPreparation();
+    listHandler->addSetWobbleMode(400, 200, 1500.0, -1);
+    listHandler->addSetWobbleMode(400, 200, 1500.0, -1); // repeat: dropped
+    listHandler->addSetWobbleMode(400, 200, 2000.0, -1);
+    listHandler->addSetWobbleMode(0, 0, 0.0, 0);
+}
+
+TEST_F(ListHandler_InteractionTest, Jumps_WithJumpModeThreshold_SwitchModeOnlyWhenLengthClassChanges) {
+    const INT longJump = static_cast<INT>(10.0 * MachineConfig::MM_TO_BITS_CONVERSION_FACTOR);
+    listHandler->setJumpModeMinLength(5.0);
+    {
+        InSequence s;
+        EXPECT_CALL(*mockRtcApi, api_set_jump_mode(1));
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(longJump, 0));
+        EXPECT_CALL(*mockRtcApi, api_mark_abs(longJump + 100, 0));
+        EXPECT_CALL(*mockRtcApi, api_set_jump_mode(0));
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(longJump + 200, 0));
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(longJump + 300, 0)); // still short: no mode change
+        EXPECT_CALL(*mockRtcApi, api_set_jump_mode(1));
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(0, 0));
+    }
+
+    listHandler->beginListPreparation();
+    listHandler->addJumpAbsolute(longJump, 0);
+    listHandler->addMarkAbsolute(longJump + 100, 0);
+    listHandler->addJumpAbsolute(longJump + 200, 0);
+    listHandler->addJumpAbsolute(longJump + 300, 0);
+    listHandler->addJumpAbsolute(0, 0);
+}
+
+TEST_F(ListHandler_InteractionTest, ListLoop_FirstJumpLongOnlyFromTheBodyEnd_RunsInJumpModeOnEveryPass) {
+    const INT longJump = static_cast<INT>(10.0 * MachineConfig::MM_TO_BITS_CONVERSION_FACTOR);
+    listHandler->setJumpModeMinLength(5.0);
+    {
+        InSequence s;
+        EXPECT_CALL(*mockRtcApi, api_list_repeat());
+        EXPECT_CALL(*mockRtcApi, api_set_jump_mode(1)); // Short from (0, 0), long from the body end.
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(100, 0));
+        EXPECT_CALL(*mockRtcApi, api_mark_abs(longJump, 0));
+        EXPECT_CALL(*mockRtcApi, api_list_until(3u));
+        EXPECT_CALL(*mockRtcApi, api_set_jump_mode(0)); // The active mode after the loop is 1.
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(longJump + 100, 0));
+    }
+
+    listHandler->beginListPreparation();
+    listHandler->addListRepeat();
+    listHandler->addJumpAbsolute(100, 0);
+    listHandler->addMarkAbsolute(longJump, 0);
+    listHandler->addListUntil(3);
+    listHandler->addJumpAbsolute(longJump + 100, 0);
+}
+
+TEST_F(ListHandler_InteractionTest, Jumps_WithoutJumpModeThreshold_NeverSwitchJumpMode) {
+    listHandler->setJumpModeMinLength(0.0);
+    EXPECT_CALL(*mockRtcApi, api_set_jump_mode(_)).Times(0);
+
+    listHandler->beginListPreparation();
+    listHandler->addJumpAbsolute(1000000, 0);
+}
+
+TEST_F(ListHandler_InteractionTest, ParameterCommands_NewList_AreWrittenAgain) {
+    EXPECT_CALL(*mockRtcApi, api_set_jump_speed(_)).Times(2);
+
+    listHandler->beginListPreparation();
+    listHandler->addSetJumpSpeed(5000.0);
+    listHandler->beginListPreparation();
+    listHandler->addSetJumpSpeed(5000.0);
+}
+
+TEST_F(ListHandler_InteractionTest, AddJumpAbsolute3D_WithCoordinates_CallsApiJumpAbs3DWithSameCoordinates) {
+    EXPECT_CALL(*mockRtcApi, api_jump_abs_3d(100, -200, 300)).Times(1);
+
+    listHandler->addJumpAbsolute3D(100, -200, 300);
+}
+
+TEST_F(ListHandler_InteractionTest, AddMarkAbsolute3D_WithCoordinates_CallsApiMarkAbs3DWithSameCoordinates) {
+    EXPECT_CALL(*mockRtcApi, api_mark_abs_3d(-100, 200, -300)).Times(1);
+
+    listHandler->addMarkAbsolute3D(-100, 200, -300);
+}
+
+TEST_F(ListHandler_InteractionTest, AddLaserOn_WithPeriod_CallsApiLaserOnListWithSamePeriod) {
+    EXPECT_CALL(*mockRtcApi, api_laser_on_list(25u)).Times(1);
+
+    listHandler->addLaserOn(25u);
+}
@@ -1,18 +1,27 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include "ListHandler.h"
+#include "MachineConfig.h"
 #include "MockCommunicator.h"
 #include "MockRtcApi.h"
+#include "Rtc6Constants.h"
+#include "Rtc6Exception.h"
+#include "SimulatedRtcApi.h"
+#include <chrono>
 #include <memory>
 
 using ::testing::Return;
 using ::testing::_;
+using ::testing::InSequence;
+using ::testing::Invoke;
+using ::testing::InvokeWithoutArgs;
 
 class ListHandler_LogicTest : public ::testing::Test {
 protected:
     std::unique_ptr<MockCommunicator> mockCommunicator;
     std::unique_ptr<MockRtcApi> mockRtcApi;
     std::unique_ptr<ListHandler> listHandler;
+    UINT inputPointer = 0; // One position per list command, as the board's input pointer.
 
     void SetUp() override {
         mockCommunicator = std::make_unique<MockCommunicator>();
@@ -21,12 +30,56 @@ protected:
         ON_CALL(*mockCommunicator, isSuccessfullySetup()).WillByDefault(Return(true));
 
         ON_CALL(*mockRtcApi, api_execute_list(_)).WillByDefault(Return());
+        ON_CALL(*mockRtcApi, api_get_list_space()).WillByDefault(Return(1u << 20));
+        trackInputPointer();
 
         listHandler = std::make_unique<ListHandler>(*mockCommunicator, *mockRtcApi);
     }
 
     void TearDown() override {
     }
+
+    // Every list command advances the input pointer. Subroutines are loaded far behind the lists.
+    void trackInputPointer() {
+        auto advance = InvokeWithoutArgs([this] { ++inputPointer; });
+        ON_CALL(*mockRtcApi, api_get_input_pointer()).WillByDefault(Invoke([this] { return inputPointer; }));
+        ON_CALL(*mockRtcApi, api_set_start_list(_)).WillByDefault(InvokeWithoutArgs([this] { inputPointer = 0; }));
+        ON_CALL(*mockRtcApi, api_load_sub(_)).WillByDefault(InvokeWithoutArgs([this] { inputPointer = 1u << 24; }));
+        ON_CALL(*mockRtcApi, api_load_list(_, _)).WillByDefault(Invoke([this](UINT, UINT pos) { inputPointer = pos; }));
+        ON_CALL(*mockRtcApi, api_set_end_of_list()).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_jump_abs(_, _)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_mark_abs(_, _)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_jump_abs_3d(_, _, _)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_mark_abs_3d(_, _, _)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_laser_on_list(_)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_set_defocus_list(_)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_set_mark_speed(_)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_set_laser_power(_, _)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_set_jump_speed(_)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_set_scanner_delays(_, _, _)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_set_laser_delays(_, _)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_set_sky_writing_mode(_)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_set_sky_writing_para(_, _, _, _)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_set_sky_writing_limit(_)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_set_wobbel_mode(_, _, _, _)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_set_jump_mode(_)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_list_repeat()).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_list_until(_)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_jump_rel(_, _)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_mark_rel(_, _)).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_list_return()).WillByDefault(advance);
+        ON_CALL(*mockRtcApi, api_sub_call(_)).WillByDefault(advance);
+    }
+
+    // A zigzag of SUBROUTINE_MIN_MOVES marks, as one shape starting at (x, y).
+    void addZigzagShape(INT x, INT y) {
+        listHandler->beginShape();
+        listHandler->addJumpAbsolute(x, y);
+        for (UINT i = 1; i <= MachineConfig::SUBROUTINE_MIN_MOVES; ++i) {
+            listHandler->addMarkAbsolute(x + static_cast<INT>(i) * 10, y + (i % 2) * 10);
+        }
+        listHandler->endShape();
+    }
 };
 
 TEST_F(ListHandler_LogicTest, ExecuteCurrentListAndCycle_WhenCalledOnce_SwitchesFillListTargetFrom1To2) {
@@ -50,4 +103,559 @@ TEST_F(ListHandler_LogicTest, ExecuteCurrentListAndCycle_WhenCalledThreeTimes_Sw
     listHandler->executeCurrentListAndCycle();
 
     EXPECT_EQ(listHandler->getCurrentFillListId(), 2);
-}
\ No newline at end of file
+}
+
+TEST_F(ListHandler_LogicTest, GetListCommandCount_AfterAddingCommands_CountsEveryListCommand) {
+    EXPECT_CALL(*mockRtcApi, api_set_start_list(_)).Times(2);
+    EXPECT_CALL(*mockRtcApi, api_jump_abs(_, _)).Times(1);
+    EXPECT_CALL(*mockRtcApi, api_laser_on_list(_)).Times(1);
+    EXPECT_CALL(*mockRtcApi, api_mark_abs(_, _)).Times(1);
+
+    listHandler->beginListPreparation();
+    listHandler->addJumpAbsolute(0, 0);
+    listHandler->addLaserOn(10);
+    listHandler->addMarkAbsolute(1, 1);
+
+    EXPECT_EQ(listHandler->getListCommandCount(), 3u);
+
+    // Starting a new list resets the count.
+    listHandler->beginListPreparation();
+    EXPECT_EQ(listHandler->getListCommandCount(), 0u);
+}
+
+
+TEST_F(ListHandler_LogicTest, GetListTimeEstimate_AfterAddingCommands_AccumulatesAndResetsPerList) {
+    EXPECT_CALL(*mockRtcApi, api_set_start_list(_)).Times(2);
+    EXPECT_CALL(*mockRtcApi, api_set_mark_speed(_)).Times(1);
+    EXPECT_CALL(*mockRtcApi, api_jump_abs(_, _)).Times(1);
+    EXPECT_CALL(*mockRtcApi, api_mark_abs(_, _)).Times(1);
+
+    listHandler->beginListPreparation();
+    listHandler->addSetMarkSpeed(1000.0);
+    listHandler->addJumpAbsolute(0, 0);
+    listHandler->addMarkAbsolute(static_cast<INT>(MachineConfig::MM_TO_BITS_CONVERSION_FACTOR), 0);
+
+    const ScanTimeEstimate estimate = listHandler->getListTimeEstimate();
+    EXPECT_DOUBLE_EQ(estimate.markTimeUs, 1000.0); // 1 mm at 1000 mm/s
+    EXPECT_GT(estimate.delayTimeUs, 0.0);
+
+    // Starting a new list resets the estimate.
+    listHandler->beginListPreparation();
+    EXPECT_DOUBLE_EQ(listHandler->getListTimeEstimate().totalUs(), 0.0);
+}
+
+
+TEST_F(ListHandler_LogicTest, ExecuteCurrentListAndCycle_LayerLargerThanList_StreamsChunksAcrossBothLists) {
+    // Each list holds four commands beyond the reserve.
+    ON_CALL(*mockRtcApi, api_get_list_space()).WillByDefault(Return(MachineConfig::LIST_RESERVED_POSITIONS + 4));
+    ON_CALL(*mockRtcApi, api_read_status()).WillByDefault(Return(0u));
+    {
+        InSequence seq;
+        EXPECT_CALL(*mockRtcApi, api_set_start_list(1));
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(_, _)).Times(4);
+        EXPECT_CALL(*mockRtcApi, api_set_end_of_list());
+        EXPECT_CALL(*mockRtcApi, api_execute_list(1));
+        EXPECT_CALL(*mockRtcApi, api_set_start_list(2));
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(_, _)).Times(4);
+        EXPECT_CALL(*mockRtcApi, api_set_end_of_list());
+        EXPECT_CALL(*mockRtcApi, api_execute_list(2));
+        EXPECT_CALL(*mockRtcApi, api_set_start_list(1));
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(8, 0));
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(9, 0));
+        EXPECT_CALL(*mockRtcApi, api_set_end_of_list());
+        EXPECT_CALL(*mockRtcApi, api_execute_list(1));
+    }
+
+    listHandler->beginListPreparation();
+    for (INT i = 0; i < 10; ++i) {
+        listHandler->addJumpAbsolute(i, 0);
+    }
+    listHandler->endListPreparation();
+    EXPECT_EQ(listHandler->getListCommandCount(), 10u) << "Held-back commands still belong to the layer.";
+
+    listHandler->executeCurrentListAndCycle();
+
+    EXPECT_EQ(listHandler->getLastExecutedListId(), 1u);
+    EXPECT_EQ(listHandler->getCurrentFillListId(), 2u);
+}
+
+TEST_F(ListHandler_LogicTest, ExecuteCurrentListAndCycle_LayerThatFits_ExecutesSingleList) {
+    ON_CALL(*mockRtcApi, api_get_list_space()).WillByDefault(Return(MachineConfig::LIST_RESERVED_POSITIONS + 4));
+    EXPECT_CALL(*mockRtcApi, api_set_start_list(_)).Times(1);
+    EXPECT_CALL(*mockRtcApi, api_jump_abs(_, _)).Times(4);
+    EXPECT_CALL(*mockRtcApi, api_execute_list(_)).Times(1);
+
+    listHandler->beginListPreparation();
+    for (INT i = 0; i < 4; ++i) {
+        listHandler->addJumpAbsolute(i, 0);
+    }
+    listHandler->endListPreparation();
+    listHandler->executeCurrentListAndCycle();
+}
+
+TEST_F(ListHandler_LogicTest, ExecuteCurrentListAndCycle_StreamedChunkWhileListRuns_ChainsItWithAutoChange) {
+    ON_CALL(*mockRtcApi, api_get_list_space()).WillByDefault(Return(MachineConfig::LIST_RESERVED_POSITIONS + 1));
+    bool list1Started = false;
+    ON_CALL(*mockRtcApi, api_read_status()).WillByDefault([&]() {
+        return list1Started ? static_cast<UINT>(Rtc6Constants::Status::BUSY1) : 0u;
+    });
+    EXPECT_CALL(*mockRtcApi, api_execute_list(1)).WillOnce([&](UINT) { list1Started = true; });
+    EXPECT_CALL(*mockRtcApi, api_auto_change()).Times(1);
+    EXPECT_CALL(*mockRtcApi, api_execute_list(2)).Times(0);
+
+    listHandler->beginListPreparation();
+    listHandler->addJumpAbsolute(0, 0);
+    listHandler->addJumpAbsolute(1, 0);
+    listHandler->endListPreparation();
+    listHandler->executeCurrentListAndCycle();
+
+    EXPECT_EQ(listHandler->getLastExecutedListId(), 2u);
+}
+
+namespace {
+    // A minimal board model in which time advances by one tick per status read. A started
+    // list runs for a fixed number of ticks; an armed auto_change starts the other list in
+    // the same tick the running one ends. An arm made while no list runs stays pending.
+    struct TickBoard {
+        int ticksPerList = 5;
+        UINT running = 0;
+        UINT lastStarted = 0;   // The list the output pointer is in.
+        int ticksLeft = 0;
+        bool autoChangeArmed = false;
+        int listStarts = 0;
+        int expectedStarts = 0;
+        int idleTicks = 0;  // Ticks without a running list between the first and the last start.
+        // Ticks that pass around the auto_change call, as if the host were descheduled.
+        int ticksBeforeArm = 0;
+        int ticksAfterArm = 0;
+
+        void start(UINT list) {
+            running = list;
+            lastStarted = list;
+            ticksLeft = ticksPerList;
+            ++listStarts;
+        }
+
+        void tick() {
+            if (running != 0 && --ticksLeft == 0) {
+                const UINT other = running == 1 ? 2 : 1;
+                running = 0;
+                if (autoChangeArmed) {
+                    autoChangeArmed = false;
+                    start(other);
+                }
+            }
+            if (running == 0 && listStarts > 0 && listStarts < expectedStarts) {
+                ++idleTicks;
+            }
+        }
+
+        void armAutoChange() {
+            for (int i = 0; i < ticksBeforeArm; ++i) tick();
+            autoChangeArmed = true;
+            for (int i = 0; i < ticksAfterArm; ++i) tick();
+        }
+
+        void stopExecution() {
+            running = 0;
+            autoChangeArmed = false;
+        }
+
+        UINT readStatus() {
+            tick();
+            if (running == 1) return Rtc6Constants::Status::BUSY1;
+            if (running == 2) return Rtc6Constants::Status::BUSY2;
+            return 0u;
+        }
+    };
+}
+
+TEST_F(ListHandler_LogicTest, ExecuteCurrentListAndCycle_MultiChunkLayer_HasNoIdleTimeBetweenChunks) {
+    TickBoard board;
+    board.expectedStarts = 3;
+    ON_CALL(*mockRtcApi, api_get_list_space()).WillByDefault(Return(MachineConfig::LIST_RESERVED_POSITIONS + 2));
+    ON_CALL(*mockRtcApi, api_read_status()).WillByDefault([&board]() { return board.readStatus(); });
+    ON_CALL(*mockRtcApi, api_execute_list(_)).WillByDefault([&board](UINT list) { board.start(list); });
+    ON_CALL(*mockRtcApi, api_auto_change()).WillByDefault([&board]() { board.armAutoChange(); });
+
+    listHandler->beginListPreparation();
+    for (INT i = 0; i < 6; ++i) {
+        listHandler->addMarkAbsolute(i, i);
+    }
+    listHandler->endListPreparation();
+    listHandler->executeCurrentListAndCycle();
+    // The last chunk is chained, so waiting for it must also cover the chunk ahead of it.
+    EXPECT_TRUE(listHandler->waitForListCompletion(listHandler->getLastExecutedListId()));
+
+    EXPECT_EQ(board.listStarts, 3);
+    EXPECT_EQ(board.running, 0u);
+    EXPECT_EQ(board.idleTicks, 0);
+}
+
+TEST_F(ListHandler_LogicTest, ExecuteCurrentListAndCycle_ChainedChunkRunsToItsEndBeforeTheRecheck_IsNotStartedAgain) {
+    TickBoard board;
+    board.ticksPerList = 3;
+    // Both the running list and the short chained one end while the host is descheduled.
+    board.ticksAfterArm = 2 * board.ticksPerList;
+    ON_CALL(*mockRtcApi, api_get_list_space()).WillByDefault(Return(MachineConfig::LIST_RESERVED_POSITIONS + 1));
+    ON_CALL(*mockRtcApi, api_read_status()).WillByDefault([&board]() { return board.readStatus(); });
+    ON_CALL(*mockRtcApi, api_execute_list(_)).WillByDefault([&board](UINT list) { board.start(list); });
+    ON_CALL(*mockRtcApi, api_auto_change()).WillByDefault([&board]() { board.armAutoChange(); });
+    ON_CALL(*mockRtcApi, api_get_out_pointer(_, _)).WillByDefault([&board](UINT& list, UINT& pos) {
+        list = board.lastStarted;
+        pos = 0;
+    });
+    EXPECT_CALL(*mockRtcApi, api_execute_list(1)).Times(1);
+    EXPECT_CALL(*mockRtcApi, api_execute_list(2)).Times(0);
+    EXPECT_CALL(*mockRtcApi, api_stop_execution()).Times(0);
+
+    listHandler->beginListPreparation();
+    listHandler->addJumpAbsolute(0, 0);
+    listHandler->addJumpAbsolute(1, 0);
+    listHandler->endListPreparation();
+    listHandler->executeCurrentListAndCycle();
+
+    EXPECT_EQ(board.listStarts, 2);
+    EXPECT_FALSE(board.autoChangeArmed);
+}
+
+TEST_F(ListHandler_LogicTest, ExecuteCurrentListAndCycle_RunningListEndsBeforeTheArm_CancelsTheArmAndStartsTheChunk) {
+    TickBoard board;
+    board.ticksPerList = 3;
+    board.ticksBeforeArm = board.ticksPerList;
+    ON_CALL(*mockRtcApi, api_get_list_space()).WillByDefault(Return(MachineConfig::LIST_RESERVED_POSITIONS + 1));
+    ON_CALL(*mockRtcApi, api_read_status()).WillByDefault([&board]() { return board.readStatus(); });
+    ON_CALL(*mockRtcApi, api_execute_list(_)).WillByDefault([&board](UINT list) { board.start(list); });
+    ON_CALL(*mockRtcApi, api_auto_change()).WillByDefault([&board]() { board.armAutoChange(); });
+    ON_CALL(*mockRtcApi, api_stop_execution()).WillByDefault([&board]() { board.stopExecution(); });
+    ON_CALL(*mockRtcApi, api_get_out_pointer(_, _)).WillByDefault([&board](UINT& list, UINT& pos) {
+        list = board.lastStarted;
+        pos = 0;
+    });
+    {
+        InSequence seq;
+        EXPECT_CALL(*mockRtcApi, api_execute_list(1));
+        EXPECT_CALL(*mockRtcApi, api_auto_change());
+        EXPECT_CALL(*mockRtcApi, api_stop_execution());
+        EXPECT_CALL(*mockRtcApi, api_execute_list(2));
+    }
+
+    listHandler->beginListPreparation();
+    listHandler->addJumpAbsolute(0, 0);
+    listHandler->addJumpAbsolute(1, 0);
+    listHandler->endListPreparation();
+    listHandler->executeCurrentListAndCycle();
+    listHandler->waitForListCompletion(2);
+
+    // No stale arm is left to restart list 1 after list 2.
+    EXPECT_EQ(board.listStarts, 2);
+    EXPECT_EQ(board.running, 0u);
+}
+
+TEST_F(ListHandler_LogicTest, ExecuteCurrentListAndCycle_NoListSpaceWhileStreaming_ThrowsHardwareError) {
+    EXPECT_CALL(*mockRtcApi, api_get_list_space())
+        .WillOnce(Return(MachineConfig::LIST_RESERVED_POSITIONS + 1))
+        .WillRepeatedly(Return(0u));
+
+    listHandler->beginListPreparation();
+    listHandler->addJumpAbsolute(0, 0);
+    listHandler->addJumpAbsolute(1, 0);
+    listHandler->endListPreparation();
+
+    EXPECT_THROW(listHandler->executeCurrentListAndCycle(), HardwareError);
+}
+
+TEST_F(ListHandler_LogicTest, ListLoop_ThatFits_IsWrittenOnceWithItsParametersSetInsideTheBody) {
+    {
+        InSequence seq;
+        EXPECT_CALL(*mockRtcApi, api_set_mark_speed(_));
+        EXPECT_CALL(*mockRtcApi, api_list_repeat());
+        EXPECT_CALL(*mockRtcApi, api_set_mark_speed(_)); // Active before, but every pass needs it.
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(0, 0));
+        EXPECT_CALL(*mockRtcApi, api_mark_abs(10, 0));
+        EXPECT_CALL(*mockRtcApi, api_list_until(5u));
+        EXPECT_CALL(*mockRtcApi, api_mark_abs(20, 0));
+    }
+
+    listHandler->beginListPreparation();
+    listHandler->addSetMarkSpeed(500.0);
+    listHandler->addListRepeat();
+    listHandler->addSetMarkSpeed(500.0);
+    listHandler->addJumpAbsolute(0, 0);
+    listHandler->addMarkAbsolute(10, 0);
+    listHandler->addListUntil(5);
+    listHandler->addSetMarkSpeed(500.0); // Still active after the loop: dropped.
+    listHandler->addMarkAbsolute(20, 0);
+
+    EXPECT_EQ(listHandler->getListCommandCount(), 7u);
+}
+
+TEST_F(ListHandler_LogicTest, ListLoop_NotFittingTheRestOfTheList_StartsTheNextChunkInsteadOfBeingSplit) {
+    // Room for 4 commands of 2 positions: the loop fits into a list, but not behind 2 jumps.
+    ON_CALL(*mockRtcApi, api_get_list_space()).WillByDefault(Return(MachineConfig::LIST_RESERVED_POSITIONS + 7));
+    ON_CALL(*mockRtcApi, api_read_status()).WillByDefault(Return(0u));
+    {
+        InSequence seq;
+        EXPECT_CALL(*mockRtcApi, api_set_start_list(1));
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(_, _)).Times(2);
+        EXPECT_CALL(*mockRtcApi, api_set_end_of_list());
+        EXPECT_CALL(*mockRtcApi, api_execute_list(1));
+        EXPECT_CALL(*mockRtcApi, api_set_start_list(2));
+        EXPECT_CALL(*mockRtcApi, api_list_repeat());
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(_, _)).Times(2);
+        EXPECT_CALL(*mockRtcApi, api_list_until(2u));
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(9, 0));
+        EXPECT_CALL(*mockRtcApi, api_set_end_of_list());
+        EXPECT_CALL(*mockRtcApi, api_execute_list(2));
+    }
+
+    listHandler->beginListPreparation();
+    listHandler->addJumpAbsolute(0, 0);
+    listHandler->addJumpAbsolute(1, 0);
+    listHandler->addListRepeat();
+    listHandler->addJumpAbsolute(2, 0);
+    listHandler->addJumpAbsolute(3, 0);
+    listHandler->addListUntil(2);
+    listHandler->addJumpAbsolute(9, 0);
+    listHandler->endListPreparation();
+    listHandler->executeCurrentListAndCycle();
+}
+
+TEST_F(ListHandler_LogicTest, Submit_CommandsTakingTwoPositions_FillTheListByTheInputPointer) {
+    ON_CALL(*mockRtcApi, api_get_list_space()).WillByDefault(Return(MachineConfig::LIST_RESERVED_POSITIONS + 6));
+    ON_CALL(*mockRtcApi, api_read_status()).WillByDefault(Return(0u));
+    ON_CALL(*mockRtcApi, api_jump_abs(_, _)).WillByDefault(InvokeWithoutArgs([this] { inputPointer += 2; }));
+    {
+        InSequence seq;
+        EXPECT_CALL(*mockRtcApi, api_set_start_list(1));
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(_, _)).Times(3);
+        EXPECT_CALL(*mockRtcApi, api_set_end_of_list());
+        EXPECT_CALL(*mockRtcApi, api_execute_list(1));
+        EXPECT_CALL(*mockRtcApi, api_set_start_list(2));
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(_, _)).Times(3);
+        EXPECT_CALL(*mockRtcApi, api_set_end_of_list());
+        EXPECT_CALL(*mockRtcApi, api_execute_list(2));
+    }
+
+    listHandler->beginListPreparation();
+    for (INT i = 0; i < 6; ++i) {
+        listHandler->addJumpAbsolute(i, 0);
+    }
+    listHandler->endListPreparation();
+    listHandler->executeCurrentListAndCycle();
+}
+
+TEST_F(ListHandler_LogicTest, ListLoop_LargerThanAList_IsWrittenOutPassByPass) {
+    ON_CALL(*mockRtcApi, api_get_list_space()).WillByDefault(Return(MachineConfig::LIST_RESERVED_POSITIONS + 4));
+    ON_CALL(*mockRtcApi, api_read_status()).WillByDefault(Return(0u));
+    EXPECT_CALL(*mockRtcApi, api_list_repeat()).Times(0);
+    EXPECT_CALL(*mockRtcApi, api_list_until(_)).Times(0);
+    EXPECT_CALL(*mockRtcApi, api_jump_abs(_, _)).Times(6);
+
+    listHandler->beginListPreparation();
+    listHandler->addListRepeat();
+    listHandler->addJumpAbsolute(1, 0);
+    listHandler->addJumpAbsolute(2, 0);
+    listHandler->addJumpAbsolute(3, 0);
+    listHandler->addListUntil(2);
+    listHandler->endListPreparation();
+    EXPECT_EQ(listHandler->getListCommandCount(), 6u);
+    listHandler->executeCurrentListAndCycle();
+}
+
+TEST_F(ListHandler_LogicTest, ListLoop_Nested_ThrowsConfigurationError) {
+    listHandler->beginListPreparation();
+    listHandler->addListRepeat();
+    EXPECT_THROW(listHandler->addListRepeat(), ConfigurationError);
+}
+
+TEST_F(ListHandler_LogicTest, Shape_TranslatedCopies_AreLoadedOnceAsSubroutineAndCalled) {
+    const UINT moves = MachineConfig::SUBROUTINE_MIN_MOVES;
+    EXPECT_CALL(*mockRtcApi, api_mark_abs(_, _)).Times(moves); // Only the first copy.
+    EXPECT_CALL(*mockRtcApi, api_mark_rel(_, _)).Times(moves); // Once, into the subroutine.
+    {
+        InSequence seq;
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(0, 0));
+        EXPECT_CALL(*mockRtcApi, api_load_sub(0u));
+        EXPECT_CALL(*mockRtcApi, api_list_return());
+        EXPECT_CALL(*mockRtcApi, api_load_list(1u, moves + 1)); // Right after the first copy.
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(500, 700));
+        EXPECT_CALL(*mockRtcApi, api_sub_call(0u));
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(-300, 100));
+        EXPECT_CALL(*mockRtcApi, api_sub_call(0u));
+    }
+
+    listHandler->setSubroutineInstancing(true);
+    listHandler->beginListPreparation();
+    addZigzagShape(0, 0);
+    addZigzagShape(500, 700);
+    addZigzagShape(-300, 100);
+
+    EXPECT_EQ(listHandler->getListCommandCount(), (moves + 1) + 2 + 2);
+}
+
+TEST_F(ListHandler_LogicTest, Shape_SubroutineFromAnEarlierLayer_IsCalledWithoutReloading) {
+    ON_CALL(*mockRtcApi, api_read_status()).WillByDefault(Return(0u));
+    EXPECT_CALL(*mockRtcApi, api_load_sub(_)).Times(1);
+    EXPECT_CALL(*mockRtcApi, api_sub_call(0u)).Times(2);
+
+    listHandler->setSubroutineInstancing(true);
+    listHandler->beginListPreparation();
+    addZigzagShape(0, 0);
+    addZigzagShape(100, 0);
+    listHandler->endListPreparation();
+    listHandler->executeCurrentListAndCycle();
+
+    listHandler->beginListPreparation();
+    addZigzagShape(200, 0);
+}
+
+TEST_F(ListHandler_LogicTest, Shape_InstancingDisabled_WritesEveryCopyOut) {
+    EXPECT_CALL(*mockRtcApi, api_jump_abs(_, _)).Times(2);
+    EXPECT_CALL(*mockRtcApi, api_mark_abs(_, _)).Times(2 * MachineConfig::SUBROUTINE_MIN_MOVES);
+    EXPECT_CALL(*mockRtcApi, api_load_sub(_)).Times(0);
+    EXPECT_CALL(*mockRtcApi, api_sub_call(_)).Times(0);
+
+    listHandler->setSubroutineInstancing(false);
+    listHandler->beginListPreparation();
+    addZigzagShape(0, 0);
+    addZigzagShape(500, 700);
+}
+
+TEST_F(ListHandler_LogicTest, RepeatLastLayer_LayerThatFits_ExecutesTheLoadedListAgainWithoutReloading) {
+    ON_CALL(*mockRtcApi, api_read_status()).WillByDefault(Return(0u));
+    EXPECT_CALL(*mockRtcApi, api_set_start_list(_)).Times(1);
+    EXPECT_CALL(*mockRtcApi, api_jump_abs(_, _)).Times(2);
+    EXPECT_CALL(*mockRtcApi, api_execute_list(1)).Times(3);
+
+    listHandler->beginListPreparation();
+    listHandler->addJumpAbsolute(0, 0);
+    listHandler->addJumpAbsolute(1, 0);
+    listHandler->endListPreparation();
+    listHandler->executeCurrentListAndCycle();
+
+    EXPECT_TRUE(listHandler->repeatLastLayer());
+    EXPECT_TRUE(listHandler->repeatLastLayer());
+    EXPECT_EQ(listHandler->getLastExecutedListId(), 1u);
+    EXPECT_EQ(listHandler->getCurrentFillListId(), 2u) << "The next layer still goes into the other list.";
+}
+
+TEST_F(ListHandler_LogicTest, RepeatLastLayer_ChunkedLayerThatWasRetained_StreamsTheWholeLayerAgain) {
+    ON_CALL(*mockRtcApi, api_get_list_space()).WillByDefault(Return(MachineConfig::LIST_RESERVED_POSITIONS + 4));
+    ON_CALL(*mockRtcApi, api_read_status()).WillByDefault(Return(0u));
+
+    listHandler->retainLayerForRepeat(true);
+    listHandler->beginListPreparation();
+    for (INT i = 0; i < 6; ++i) {
+        listHandler->addJumpAbsolute(i, 0);
+    }
+    listHandler->endListPreparation();
+    listHandler->executeCurrentListAndCycle();
+
+    {
+        InSequence seq;
+        EXPECT_CALL(*mockRtcApi, api_set_start_list(1));
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(0, 0));
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(_, _)).Times(3);
+        EXPECT_CALL(*mockRtcApi, api_set_end_of_list());
+        EXPECT_CALL(*mockRtcApi, api_execute_list(1));
+        EXPECT_CALL(*mockRtcApi, api_set_start_list(2));
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(4, 0));
+        EXPECT_CALL(*mockRtcApi, api_jump_abs(5, 0));
+        EXPECT_CALL(*mockRtcApi, api_set_end_of_list());
+        EXPECT_CALL(*mockRtcApi, api_execute_list(2));
+    }
+    EXPECT_TRUE(listHandler->repeatLastLayer());
+    EXPECT_EQ(listHandler->getLastExecutedListId(), 2u);
+}
+
+TEST_F(ListHandler_LogicTest, RepeatLastLayer_ChunkedLayerNotRetainedOrNothingExecuted_ReturnsFalse) {
+    EXPECT_FALSE(listHandler->repeatLastLayer());
+
+    ON_CALL(*mockRtcApi, api_get_list_space()).WillByDefault(Return(MachineConfig::LIST_RESERVED_POSITIONS + 1));
+    ON_CALL(*mockRtcApi, api_read_status()).WillByDefault(Return(0u));
+    listHandler->beginListPreparation();
+    listHandler->addJumpAbsolute(0, 0);
+    listHandler->addJumpAbsolute(1, 0);
+    listHandler->endListPreparation();
+    listHandler->executeCurrentListAndCycle();
+
+    EXPECT_CALL(*mockRtcApi, api_execute_list(_)).Times(0);
+    EXPECT_FALSE(listHandler->repeatLastLayer());
+}
+
+TEST_F(ListHandler_LogicTest, BeginListPreparation_AfterAChunkedLayer_WaitsForTheFillListToFinish) {
+    // The layer's next-to-last chunk still runs in the list the next layer is prepared in.
+    SimulatedRtcApi board(SimulatedTime::Virtual, 1.0, MachineConfig::LIST_RESERVED_POSITIONS + 100);
+    SimulatedCommunicator communicator;
+    communicator.connectAndSetupBoard();
+    ListHandler handler(communicator, board);
+
+    handler.beginListPreparation();
+    for (INT i = 0; i < 350; ++i) {
+        handler.addJumpAbsolute(0, i * 40);
+        handler.addMarkAbsolute(20000, i * 40);
+    }
+    handler.endListPreparation();
+    handler.executeCurrentListAndCycle();
+
+    ASSERT_TRUE(handler.beginListPreparation());
+    handler.addJumpAbsolute(0, 0);
+    handler.addMarkAbsolute(20000, 0);
+    handler.endListPreparation();
+    handler.waitForListCompletion(handler.getLastExecutedListId());
+    handler.executeCurrentListAndCycle();
+    handler.waitForListCompletion(handler.getLastExecutedListId());
+
+    const SimulationStats stats = board.stats();
+    EXPECT_EQ(stats.rejectedCalls, 0u);
+    EXPECT_EQ(stats.listsExecuted, 8u); // 700 commands in chunks of 100, then the next layer.
+}
+
+TEST_F(ListHandler_LogicTest, WaitForListCompletion_ListAlreadyIdle_ReturnsFalseWithoutRecording) {
+    EXPECT_CALL(*mockRtcApi, api_read_status()).WillOnce(Return(0u));
+
+    EXPECT_FALSE(listHandler->waitForListCompletion(1));
+    EXPECT_EQ(listHandler->getHandoverLatency().count(), 0u);
+}
+
+TEST_F(ListHandler_LogicTest, WaitForListCompletion_ListBusy_PollsUntilIdleAndRecordsLatency) {
+    EXPECT_CALL(*mockRtcApi, api_read_status())
+        .WillOnce(Return(Rtc6Constants::Status::BUSY2))
+        .WillOnce(Return(Rtc6Constants::Status::BUSY2))
+        .WillOnce(Return(Rtc6Constants::Status::BUSY2 | Rtc6Constants::Status::BUSY1))
+        .WillOnce(Return(Rtc6Constants::Status::BUSY1));
+
+    EXPECT_TRUE(listHandler->waitForListCompletion(2));
+
+    const LatencyHistogram latency = listHandler->getHandoverLatency();
+    EXPECT_EQ(latency.count(), 1u);
+    // One poll interval at most; the backoff never sleeps longer than the configured maximum.
+    EXPECT_LT(latency.maxUs(), 1.0e6);
+}
+
+TEST_F(ListHandler_LogicTest, WaitForListCompletion_ListNeverEnds_ThrowsAfterTheTimeout) {
+    ON_CALL(*mockRtcApi, api_read_status()).WillByDefault(Return(Rtc6Constants::Status::BUSY1));
+    EXPECT_CALL(*mockRtcApi, api_read_status()).Times(testing::AtLeast(2));
+    listHandler->setListWaitTimeout(std::chrono::milliseconds(20));
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_THROW(listHandler->waitForListCompletion(1), HardwareError);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+}
+
+TEST_F(ListHandler_LogicTest, WaitForListCompletion_LongRunningList_BacksOffInsteadOfHammeringStatus) {
+    using Clock = std::chrono::steady_clock;
+    const auto listEnd = Clock::now() + std::chrono::milliseconds(30);
+    int statusReads = 0;
+    ON_CALL(*mockRtcApi, api_read_status()).WillByDefault([&]() {
+        ++statusReads;
+        return Clock::now() < listEnd ? static_cast<UINT>(Rtc6Constants::Status::BUSY1) : 0u;
+    });
+
+    EXPECT_TRUE(listHandler->waitForListCompletion(1));
+
+    // Back-to-back polling over 30 ms would read the status thousands of times.
+    EXPECT_LT(statusReads, 1000);
+    EXPECT_LE(listHandler->getHandoverLatency().maxUs(), MachineConfig::LIST_WAIT_MAX_SLEEP_US * 20.0);
+}
@@ -0,0 +1,131 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "Logger.h"
+#include "LockFreeRingBuffer.h"
+#include <sstream>
+#include <thread>
+#include <vector>
+
+TEST(LockFreeRingBuffer_Test, PushThenPop_PreservesOrder) {
+    LockFreeRingBuffer<int> buffer(8);
+    for (int i = 0; i < 5; ++i) ASSERT_TRUE(buffer.tryPush(i));
+
+    int value = -1;
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(buffer.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(buffer.tryPop(value));
+}
+
+TEST(LockFreeRingBuffer_Test, TryPush_WhenFull_FailsWithoutBlocking) {
+    LockFreeRingBuffer<int> buffer(3); // Rounded up to 4.
+    ASSERT_EQ(buffer.capacity(), 4u);
+    for (int i = 0; i < 4; ++i) ASSERT_TRUE(buffer.tryPush(i));
+
+    EXPECT_FALSE(buffer.tryPush(99));
+
+    int value = -1;
+    ASSERT_TRUE(buffer.tryPop(value));
+    EXPECT_TRUE(buffer.tryPush(4));
+}
+
+TEST(LockFreeRingBuffer_Test, ConcurrentProducers_EveryValueArrivesOnce) {
+    constexpr int PRODUCERS = 4;
+    constexpr int PER_PRODUCER = 5000;
+    LockFreeRingBuffer<int> buffer(1024);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&buffer, p]() {
+            for (int i = 0; i < PER_PRODUCER; ++i) {
+                while (!buffer.tryPush(p * PER_PRODUCER + i)) std::this_thread::yield();
+            }
+        });
+    }
+
+    std::vector<int> seen(PRODUCERS * PER_PRODUCER, 0);
+    int received = 0;
+    int value = 0;
+    while (received < PRODUCERS * PER_PRODUCER) {
+        if (buffer.tryPop(value)) {
+            ++seen[value];
+            ++received;
+        }
+    }
+    for (auto& t : producers) t.join();
+
+    for (int count : seen) ASSERT_EQ(count, 1);
+}
+
+TEST(Logger_Test, Log_FormatsEventTextWithLevel) {
+    std::ostringstream out, err;
+    {
+        Logger logger(out, err);
+        logger.log(LogLevel::Info, LogEvent::ListPreparationBegin, 2);
+        logger.flush();
+    }
+
+    EXPECT_NE(out.str().find("INFO  [ListHandler] Beginning preparation for List 2"), std::string::npos);
+    EXPECT_TRUE(err.str().empty());
+}
+
+TEST(Logger_Test, Log_BelowRuntimeLevel_IsDiscarded) {
+    std::ostringstream out, err;
+    {
+        Logger logger(out, err);
+        logger.setLevel(LogLevel::Warning);
+        logger.log(LogLevel::Info, LogEvent::ListExecute, 1);
+        logger.log(LogLevel::Trace, LogEvent::ApiJumpAbs, 10, 20);
+        logger.flush();
+    }
+
+    EXPECT_TRUE(out.str().empty());
+    EXPECT_TRUE(err.str().empty());
+}
+
+TEST(Logger_Test, Log_WarningsAndErrors_GoToErrorStream) {
+    std::ostringstream out, err;
+    {
+        Logger logger(out, err);
+        logger.log(LogLevel::Warning, LogEvent::ListBusyCheckInvalidId, 7);
+        logger.log(LogLevel::Error, LogEvent::ListExecuteNotReady);
+        logger.flush();
+    }
+
+    EXPECT_TRUE(out.str().empty());
+    EXPECT_NE(err.str().find("WARN  [ListHandler] Invalid listId 7"), std::string::npos);
+    EXPECT_NE(err.str().find("ERROR"), std::string::npos);
+}
+
+TEST(Logger_Test, Log_DoubleArguments_AreFormattedAsDoubles) {
+    std::ostringstream out, err;
+    {
+        Logger logger(out, err);
+        logger.setLevel(LogLevel::Trace);
+        logger.log(LogLevel::Trace, LogEvent::MarkSpeedAdded, 4000.5, 1000.0);
+        logger.flush();
+    }
+
+    EXPECT_NE(out.str().find("Adding set_mark_speed: 4000.5 bits/ms (1000 mm/s)"), std::string::npos);
+}
+
+TEST(Logger_Test, Destructor_WritesRecordsStillInTheBuffer) {
+    std::ostringstream out, err;
+    {
+        Logger logger(out, err);
+        for (int i = 0; i < 100; ++i) logger.log(LogLevel::Info, LogEvent::ListExecute, i);
+    }
+
+    EXPECT_NE(out.str().find("Commanding execution of List 99"), std::string::npos);
+}
+
+TEST(Logger_Test, ParseLevel_AcceptsKnownNamesOnly) {
+    LogLevel level = LogLevel::Info;
+    EXPECT_TRUE(Logger::parseLevel("trace", level));
+    EXPECT_EQ(level, LogLevel::Trace);
+    EXPECT_TRUE(Logger::parseLevel("off", level));
+    EXPECT_EQ(level, LogLevel::Off);
+    EXPECT_FALSE(Logger::parseLevel("verbose", level));
+    EXPECT_EQ(level, LogLevel::Off);
+}
\ No newline at end of file
@@ -4,5 +4,8 @@
 
 class MockGeometryHandler : public InterfaceGeometryHandler {
 public:
+    MOCK_METHOD(void, beginWorkPlane, (const open_vector_format::WorkPlane&), (override));
     MOCK_METHOD(void, processVectorBlock, (const open_vector_format::VectorBlock&, const open_vector_format::MarkingParams&), (override));
+    MOCK_METHOD(void, endWorkPlane, (), (override));
+    MOCK_METHOD(ShortVectorStats, getShortVectorStats, (), (const, override));
 };
\ No newline at end of file
@@ -9,12 +9,32 @@ public:
     MOCK_METHOD(bool, beginListPreparation, (), (override));
     MOCK_METHOD(void, endListPreparation, (), (override));
     MOCK_METHOD(bool, executeCurrentListAndCycle, (), (override));
+    MOCK_METHOD(void, retainLayerForRepeat, (bool retain), (override));
+    MOCK_METHOD(bool, repeatLastLayer, (), (override));
     MOCK_METHOD(bool, isListBusy, (UINT listIdToCheck), (const, override));
+    MOCK_METHOD(bool, waitForListCompletion, (UINT listId), (override));
+    MOCK_METHOD(LatencyHistogram, getHandoverLatency, (), (const, override));
     MOCK_METHOD(UINT, getCurrentFillListId, (), (const, override));
+    MOCK_METHOD(UINT, getListCommandCount, (), (const, override));
+    MOCK_METHOD(ScanTimeEstimate, getListTimeEstimate, (), (const, override));
     MOCK_METHOD(void, addJumpAbsolute, (INT x, INT y), (override));
     MOCK_METHOD(void, addMarkAbsolute, (INT x, INT y), (override));
+    MOCK_METHOD(void, addJumpAbsolute3D, (INT x, INT y, INT z), (override));
+    MOCK_METHOD(void, addMarkAbsolute3D, (INT x, INT y, INT z), (override));
+    MOCK_METHOD(void, addLaserOn, (UINT period_10us), (override));
     MOCK_METHOD(void, addSetFocusOffset, (INT offset_bits), (override));
     MOCK_METHOD(void, addSetMarkSpeed, (double speed_mm_s), (override));
     MOCK_METHOD(void, addSetLaserPower, (UINT port, UINT power), (override));
+    MOCK_METHOD(void, addSetJumpSpeed, (double speed_mm_s), (override));
+    MOCK_METHOD(void, addSetScannerDelays, (UINT jump_10us, UINT mark_10us, UINT polygon_10us), (override));
+    MOCK_METHOD(void, addSetLaserDelays, (INT laserOn_64thUs, UINT laserOff_64thUs), (override));
+    MOCK_METHOD(void, addSetSkyWritingMode, (UINT mode), (override));
+    MOCK_METHOD(void, addSetSkyWritingParams, (double timelagUs, INT laserOnShift_64thUs, UINT nPrev_10us, UINT nPost_10us), (override));
+    MOCK_METHOD(void, addSetSkyWritingLimit, (double cosAngle), (override));
+    MOCK_METHOD(void, addSetWobbleMode, (UINT transversal_bits, UINT longitudinal_bits, double freqHz, INT mode), (override));
+    MOCK_METHOD(void, addListRepeat, (), (override));
+    MOCK_METHOD(void, addListUntil, (UINT passes), (override));
+    MOCK_METHOD(void, beginShape, (), (override));
+    MOCK_METHOD(void, endShape, (), (override));
 	MOCK_METHOD(UINT, getLastExecutedListId, (), (const, override));
 };
\ No newline at end of file
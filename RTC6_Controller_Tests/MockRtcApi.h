@@ -9,9 +9,32 @@ public:
     MOCK_METHOD(void, api_set_end_of_list, (), (override));
     MOCK_METHOD(void, api_execute_list, (UINT listNo), (override));
     MOCK_METHOD(UINT, api_read_status, (), (override));
+    MOCK_METHOD(UINT, api_get_list_space, (), (override));
     MOCK_METHOD(void, api_jump_abs, (INT x, INT y), (override));
     MOCK_METHOD(void, api_mark_abs, (INT x, INT y), (override));
+    MOCK_METHOD(void, api_jump_abs_3d, (INT x, INT y, INT z), (override));
+    MOCK_METHOD(void, api_mark_abs_3d, (INT x, INT y, INT z), (override));
+    MOCK_METHOD(void, api_laser_on_list, (UINT period), (override));
     MOCK_METHOD(void, api_set_defocus_list, (INT offset), (override));
     MOCK_METHOD(void, api_set_mark_speed, (double speed), (override));
     MOCK_METHOD(void, api_set_laser_power, (UINT port, UINT power), (override));
+    MOCK_METHOD(void, api_set_jump_speed, (double speed), (override));
+    MOCK_METHOD(void, api_set_scanner_delays, (UINT jump, UINT mark, UINT polygon), (override));
+    MOCK_METHOD(void, api_set_laser_delays, (INT laserOnDelay, UINT laserOffDelay), (override));
+    MOCK_METHOD(void, api_set_sky_writing_mode, (UINT mode), (override));
+    MOCK_METHOD(void, api_set_sky_writing_para, (double timelag, INT laserOnShift, UINT nPrev, UINT nPost), (override));
+    MOCK_METHOD(void, api_set_sky_writing_limit, (double cosAngle), (override));
+    MOCK_METHOD(void, api_set_wobbel_mode, (UINT transversal, UINT longitudinal, double freq, INT mode), (override));
+    MOCK_METHOD(void, api_set_jump_mode, (INT flag), (override));
+    MOCK_METHOD(void, api_list_repeat, (), (override));
+    MOCK_METHOD(void, api_list_until, (UINT number), (override));
+    MOCK_METHOD(void, api_jump_rel, (INT dx, INT dy), (override));
+    MOCK_METHOD(void, api_mark_rel, (INT dx, INT dy), (override));
+    MOCK_METHOD(void, api_load_sub, (UINT index), (override));
+    MOCK_METHOD(void, api_list_return, (), (override));
+    MOCK_METHOD(void, api_sub_call, (UINT index), (override));
+    MOCK_METHOD(void, api_load_list, (UINT listNo, UINT pos), (override));
+    MOCK_METHOD(void, api_stop_execution, (), (override));
+    MOCK_METHOD(void, api_get_out_pointer, (UINT& listNo, UINT& pos), (override));
+    MOCK_METHOD(UINT, api_get_input_pointer, (), (override));
 };
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "ParallelGeometryHandler.h"
+#include "GeometryHandler.h"
+#include "CommandBuffer.h"
+#include "WorkerPool.h"
+#include "MockListHandler.h"
+
+#include <atomic>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using ::testing::InSequence;
+
+namespace {
+    // Builds a layer with a deterministic mix of every block type GeometryHandler emits.
+    open_vector_format::Job makeRandomLayer(unsigned seed, size_t blockCount, open_vector_format::WorkPlane& workPlane) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> coord(-80.0f, 80.0f);
+        std::uniform_int_distribution<int> pointCount(1, 200);
+
+        open_vector_format::Job jobShell;
+        for (int key = 0; key < 4; ++key) {
+            open_vector_format::MarkingParams params;
+            params.set_laser_power_in_w(50.0f + 50.0f * key);
+            params.set_laser_speed_in_mm_per_s(500.0f + 250.0f * key);
+            params.set_laser_focus_shift_in_mm(0.1f * key);
+            params.set_point_exposure_time_in_us(20.0f);
+            (*jobShell.mutable_marking_params_map())[key] = params;
+        }
+
+        workPlane.set_x_pos_in_mm(3.5f);
+        workPlane.set_y_pos_in_mm(-1.25f);
+        workPlane.set_z_rot_in_deg(17.0f);
+        for (size_t b = 0; b < blockCount; ++b) {
+            auto* block = workPlane.add_vector_blocks();
+            block->set_marking_params_key(static_cast<int>(b % 4));
+            const int n = pointCount(rng);
+            switch (b % 5) {
+            case 0:
+                for (int i = 0; i < 2 * n + 4; ++i) block->mutable_line_sequence()->add_points(coord(rng));
+                break;
+            case 1:
+                for (int i = 0; i < 4 * n; ++i) block->mutable__hatches()->add_points(coord(rng));
+                break;
+            case 2:
+                for (int i = 0; i < 2 * n; ++i) block->mutable_point_sequence()->add_points(coord(rng));
+                break;
+            case 3:
+                for (int i = 0; i < 3 * n + 3; ++i) block->mutable_line_sequence_3d()->add_points(coord(rng));
+                break;
+            default: {
+                auto* seq = block->mutable_line_sequence_para_adapt();
+                seq->set_parameter(open_vector_format::VectorBlock::LineSequenceParaAdapt::LASER_POWER_IN_W);
+                for (int i = 0; i < n + 2; ++i) {
+                    seq->add_points_with_paras(coord(rng));
+                    seq->add_points_with_paras(coord(rng));
+                    seq->add_points_with_paras(100.0f + coord(rng));
+                }
+                break;
+            }
+            }
+        }
+        return jobShell;
+    }
+
+    void runLayer(InterfaceGeometryHandler& handler, const open_vector_format::WorkPlane& workPlane, const open_vector_format::Job& jobShell) {
+        handler.beginWorkPlane(workPlane);
+        for (const auto& block : workPlane.vector_blocks()) {
+            handler.processVectorBlock(block, jobShell.marking_params_map().at(block.marking_params_key()));
+        }
+        handler.endWorkPlane();
+    }
+}
+
+TEST(WorkerPool_Test, Run_ManyTasks_RunsEachTaskExactlyOnceWithValidWorkerIndex) {
+    WorkerPool pool(4);
+    std::vector<std::atomic<int>> hits(1000);
+    std::atomic<bool> badWorker{ false };
+
+    pool.run(hits.size(), [&](unsigned worker, size_t task) {
+        if (worker >= pool.size()) badWorker = true;
+        hits[task].fetch_add(1);
+    });
+
+    EXPECT_FALSE(badWorker);
+    for (size_t i = 0; i < hits.size(); ++i) {
+        ASSERT_EQ(hits[i].load(), 1) << "task " << i;
+    }
+}
+
+TEST(WorkerPool_Test, Run_TaskThrows_RethrowsOnCallerAndPoolStaysUsable) {
+    WorkerPool pool(3);
+
+    EXPECT_THROW(pool.run(50, [](unsigned, size_t task) {
+        if (task == 7) throw std::runtime_error("boom");
+    }), std::runtime_error);
+
+    std::atomic<int> count{ 0 };
+    pool.run(20, [&](unsigned, size_t) { ++count; });
+    EXPECT_EQ(count.load(), 20);
+}
+
+TEST(CommandBuffer_Test, Replay_RecordedCommands_AreReissuedInOrder) {
+    CommandBuffer buffer;
+    buffer.addSetMarkSpeed(750.0);
+    buffer.addSetLaserPower(1, 2048);
+    buffer.addJumpAbsolute(1, 2);
+    buffer.addMarkAbsolute3D(3, 4, 5);
+    buffer.addLaserOn(9);
+    buffer.addSetFocusOffset(-12);
+
+    MockListHandler target;
+    {
+        InSequence s;
+        EXPECT_CALL(target, addSetMarkSpeed(750.0));
+        EXPECT_CALL(target, addSetLaserPower(1, 2048));
+        EXPECT_CALL(target, addJumpAbsolute(1, 2));
+        EXPECT_CALL(target, addMarkAbsolute3D(3, 4, 5));
+        EXPECT_CALL(target, addLaserOn(9));
+        EXPECT_CALL(target, addSetFocusOffset(-12));
+    }
+
+    CommandBuffer::replay(buffer.commands(), target);
+    EXPECT_EQ(buffer.getListCommandCount(), 6u);
+}
+
+TEST(ParallelGeometryHandler_Test, EndWorkPlane_AnyThreadCount_EmitsExactlyTheSerialCommandStream) {
+    open_vector_format::WorkPlane workPlane;
+    const open_vector_format::Job jobShell = makeRandomLayer(11, 300, workPlane);
+
+    CommandBuffer serialOutput;
+    GeometryHandler serial(serialOutput);
+    runLayer(serial, workPlane, jobShell);
+    ASSERT_FALSE(serialOutput.commands().empty());
+
+    for (unsigned threads : { 1u, 2u, 4u, 8u }) {
+        CommandBuffer parallelOutput;
+        ParallelGeometryHandler parallel(parallelOutput, threads);
+        // Two layers in a row, to cover reuse of the per-block buffers.
+        runLayer(parallel, workPlane, jobShell);
+        ASSERT_EQ(parallelOutput.commands(), serialOutput.commands()) << threads << " thread(s), first layer";
+
+        parallelOutput.clear();
+        runLayer(parallel, workPlane, jobShell);
+        ASSERT_EQ(parallelOutput.commands(), serialOutput.commands()) << threads << " thread(s), second layer";
+    }
+}
+
+TEST(ParallelGeometryHandler_Test, ProcessVectorBlock_BeforeEndWorkPlane_EmitsNothing) {
+    open_vector_format::WorkPlane workPlane;
+    const open_vector_format::Job jobShell = makeRandomLayer(3, 5, workPlane);
+
+    CommandBuffer output;
+    ParallelGeometryHandler parallel(output, 2);
+    parallel.beginWorkPlane(workPlane);
+    for (const auto& block : workPlane.vector_blocks()) {
+        parallel.processVectorBlock(block, jobShell.marking_params_map().at(block.marking_params_key()));
+    }
+    EXPECT_TRUE(output.commands().empty());
+
+    parallel.endWorkPlane();
+    EXPECT_FALSE(output.commands().empty());
+}
\ No newline at end of file
@@ -65,6 +65,21 @@ protected:
 
     // The System Under Test (SUT)
     std::unique_ptr<PrintController> controller;
+
+    // Hardware and file set up, one layer on List 1 whose list ends without waiting, and any
+    // UI output. Tests add the expectations they check on top; the later ones take precedence.
+    void expectSingleLayerRun() {
+        EXPECT_CALL(mockCommunicator, connectAndSetupBoard()).WillOnce(Return(true));
+        EXPECT_CALL(mockParser, openFile(_)).WillOnce(Return(true));
+        EXPECT_CALL(mockParser, getNumberOfWorkPlanes()).WillRepeatedly(Return(1));
+        EXPECT_CALL(mockParser, getJobShell()).WillRepeatedly(Return(dummyJobShell));
+        EXPECT_CALL(mockParser, getWorkPlane(0)).WillOnce(Return(dummyWorkPlane_0));
+        EXPECT_CALL(mockListHandler, getCurrentFillListId()).WillRepeatedly(Return(1));
+        EXPECT_CALL(mockListHandler, getLastExecutedListId()).WillRepeatedly(Return(1));
+        EXPECT_CALL(mockListHandler, waitForListCompletion(_)).WillRepeatedly(Return(false));
+        EXPECT_CALL(mockUI, displayMessage(_)).Times(::testing::AnyNumber());
+        EXPECT_CALL(mockUI, displayProgress(_, _, _)).Times(::testing::AnyNumber());
+    }
 };
 
 
@@ -76,7 +91,9 @@ TEST_F(PrintControllerTest, Run_HappyPathForTwoLayers_ExecutesFullProcessInOrder
         .WillOnce(Return(1)).WillOnce(Return(1))
         .WillOnce(Return(2)).WillOnce(Return(2));
 
-    // This call happens once per layer, for a total of two times.
+    // These calls happen once per layer, for a total of two times.
+    EXPECT_CALL(mockGeoHandler, beginWorkPlane(_)).Times(2);
+    EXPECT_CALL(mockGeoHandler, endWorkPlane()).Times(2);
     EXPECT_CALL(mockGeoHandler, processVectorBlock(_, _)).Times(2);
 
     // --- Enforce the main sequence of events ---
@@ -110,7 +127,7 @@ TEST_F(PrintControllerTest, Run_HappyPathForTwoLayers_ExecutesFullProcessInOrder
     EXPECT_CALL(mockListHandler, beginListPreparation());
     EXPECT_CALL(mockListHandler, endListPreparation());
     EXPECT_CALL(mockUI, displayMessage("Waiting for previous layer on List 1 to finish..."));
-    EXPECT_CALL(mockListHandler, isListBusy(1)).WillOnce(Return(false));
+    EXPECT_CALL(mockListHandler, waitForListCompletion(1)).WillOnce(Return(false));
     EXPECT_CALL(mockUI, displayMessage("List 1 is now free."));
     EXPECT_CALL(mockUI, displayMessage("Simulating 100ms for powder bed recoating..."));
     EXPECT_CALL(mockUI, displayMessage("Executing Layer 1 on List 2."));
@@ -119,7 +136,7 @@ TEST_F(PrintControllerTest, Run_HappyPathForTwoLayers_ExecutesFullProcessInOrder
 
     // Final wait
     EXPECT_CALL(mockUI, displayMessage("Waiting for previous layer on List 2 to finish..."));
-    EXPECT_CALL(mockListHandler, isListBusy(2)).WillOnce(Return(false));
+    EXPECT_CALL(mockListHandler, waitForListCompletion(2)).WillOnce(Return(false));
     EXPECT_CALL(mockUI, displayMessage("List 2 is now free."));
     EXPECT_CALL(mockUI, displayMessage("Simulating 100ms for powder bed recoating..."));
 
@@ -217,5 +234,156 @@ TEST_F(PrintControllerTest, Run_VectorBlockWithMissingParamsKey_ThrowsConfigurat
     // ACT & ASSERT:
     // Now, we assert that calling run() under these conditions throws the exact exception we expect.
     // This is the only assertion this test needs.
+    ASSERT_THROW(controller->run(), ConfigurationError);
+}
+
+TEST_F(PrintControllerTest, Run_LayerWithModelledScanTime_DisplaysLayerAndJobEstimate) {
+    ScanTimeEstimate layerEstimate;
+    layerEstimate.markTimeUs = 1.5e6;
+    layerEstimate.jumpTimeUs = 0.25e6;
+    layerEstimate.delayTimeUs = 0.25e6;
+
+    expectSingleLayerRun();
+    EXPECT_CALL(mockListHandler, getListTimeEstimate()).WillOnce(Return(layerEstimate));
+
+    // 2 s of scanning plus 100 ms recoating for the single layer.
+    EXPECT_CALL(mockUI, displayMessage(
+        "Estimated scan time for Layer 0: 2.000 s (mark 1.500 s, jump 0.250 s, delays 0.250 s). Estimated job time: 0.0 min."));
+
+    controller->run();
+}
+
+
+TEST_F(PrintControllerTest, Run_LayerWithRepeats_RepeatsTheLoadedLayerAndScalesItsEstimate) {
+    dummyWorkPlane_0.set_repeats(2);
+    ScanTimeEstimate layerEstimate;
+    layerEstimate.markTimeUs = 0.5e6;
+    layerEstimate.jumpTimeUs = 0.25e6;
+    layerEstimate.delayTimeUs = 0.25e6;
+
+    expectSingleLayerRun();
+    EXPECT_CALL(mockListHandler, getListTimeEstimate()).WillOnce(Return(layerEstimate));
+    {
+        InSequence seq;
+        EXPECT_CALL(mockListHandler, retainLayerForRepeat(true));
+        EXPECT_CALL(mockListHandler, beginListPreparation());
+        EXPECT_CALL(mockListHandler, executeCurrentListAndCycle());
+        EXPECT_CALL(mockListHandler, repeatLastLayer()).Times(2).WillRepeatedly(Return(true));
+    }
+
+    EXPECT_CALL(mockUI, displayMessage(
+        "Estimated scan time for Layer 0: 3.000 s (mark 1.500 s, jump 0.750 s, delays 0.750 s). Estimated job time: 0.1 min."));
+    EXPECT_CALL(mockUI, displayMessage("Repeating Layer 0 (pass 2 of 3)."));
+    EXPECT_CALL(mockUI, displayMessage("Repeating Layer 0 (pass 3 of 3)."));
+
+    controller->run();
+}
+
+TEST_F(PrintControllerTest, Run_LayerRepeatThatCannotRun_ThrowsHardwareError) {
+    dummyWorkPlane_0.set_repeats(1);
+
+    expectSingleLayerRun();
+    EXPECT_CALL(mockListHandler, repeatLastLayer()).WillOnce(Return(false));
+
+    EXPECT_THROW(controller->run(), HardwareError);
+}
+
+TEST_F(PrintControllerTest, Run_ListsThatHadToBeWaitedFor_DisplaysHandoverLatencySummary) {
+    LatencyHistogram latency;
+    latency.record(100.0);
+    latency.record(900.0);
+
+    expectSingleLayerRun();
+    EXPECT_CALL(mockListHandler, waitForListCompletion(1)).WillOnce(Return(true));
+    EXPECT_CALL(mockListHandler, getHandoverLatency()).WillOnce(Return(latency));
+
+    EXPECT_CALL(mockUI, displayMessage("List hand-over latency over 2 wait(s): p50 <= 128 us, p99 <= 900 us, max 900 us."));
+
+    controller->run();
+}
+
+
+// =================================================================================
+// ===                           MULTI-LASER TESTS                               ===
+// =================================================================================
+
+class PrintControllerMultiLaserTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        open_vector_format::MarkingParams defaultParams;
+        jobShell.mutable_marking_params_map()->insert({ 0, defaultParams });
+
+        workPlane.set_work_plane_number(0);
+        workPlane.add_vector_blocks()->set_laser_index(1);
+        workPlane.add_vector_blocks()->set_laser_index(0);
+        workPlane.add_vector_blocks()->set_laser_index(1);
+
+        EXPECT_CALL(mockParser, openFile(_)).WillOnce(Return(true));
+        EXPECT_CALL(mockParser, getNumberOfWorkPlanes()).WillRepeatedly(Return(1));
+        EXPECT_CALL(mockParser, getJobShell()).WillRepeatedly(Return(jobShell));
+        EXPECT_CALL(mockParser, getWorkPlane(0)).WillOnce(::testing::ReturnPointee(&workPlane));
+        EXPECT_CALL(mockUI, displayMessage(_)).Times(::testing::AnyNumber());
+        EXPECT_CALL(mockUI, displayProgress(_, _, _)).Times(::testing::AnyNumber());
+        for (int laser = 0; laser < 2; ++laser) {
+            EXPECT_CALL(communicators[laser], connectAndSetupBoard()).WillOnce(Return(true));
+            EXPECT_CALL(listHandlers[laser], getCurrentFillListId()).WillRepeatedly(Return(1));
+        }
+
+        controller = std::make_unique<PrintController>(mockParser, mockUI, std::vector<LaserChannel>{
+            { communicators[0], listHandlers[0], geoHandlers[0] },
+            { communicators[1], listHandlers[1], geoHandlers[1] } }, config);
+    }
+
+    MockOvfParser mockParser;
+    MockUI mockUI;
+    MockCommunicator communicators[2];
+    MockListHandler listHandlers[2];
+    MockGeometryHandler geoHandlers[2];
+    PrintJobConfig config{ "dummy_path.ovf", 0 };
+    open_vector_format::Job jobShell;
+    open_vector_format::WorkPlane workPlane;
+    std::unique_ptr<PrintController> controller;
+};
+
+TEST_F(PrintControllerMultiLaserTest, Run_SplitsBlocksByLaserIndexAndWaitsForEveryBoard) {
+    for (int laser = 0; laser < 2; ++laser) {
+        InSequence s;
+        EXPECT_CALL(listHandlers[laser], beginListPreparation());
+        EXPECT_CALL(geoHandlers[laser], beginWorkPlane(_));
+        EXPECT_CALL(geoHandlers[laser], processVectorBlock(_, _)).Times(laser == 0 ? 1 : 2);
+        EXPECT_CALL(geoHandlers[laser], endWorkPlane());
+        EXPECT_CALL(listHandlers[laser], endListPreparation());
+        EXPECT_CALL(listHandlers[laser], executeCurrentListAndCycle()).WillOnce(Return(true));
+        EXPECT_CALL(listHandlers[laser], getLastExecutedListId()).WillOnce(Return(1));
+        EXPECT_CALL(listHandlers[laser], waitForListCompletion(1)).WillOnce(Return(false));
+    }
+
+    controller->run();
+}
+
+TEST_F(PrintControllerMultiLaserTest, Run_LayerTime_IsTheSlowestLasersEstimate) {
+    ScanTimeEstimate fast;
+    fast.markTimeUs = 1.0e6;
+    ScanTimeEstimate slow;
+    slow.markTimeUs = 3.0e6;
+    EXPECT_CALL(listHandlers[0], getListTimeEstimate()).WillOnce(Return(fast));
+    EXPECT_CALL(listHandlers[1], getListTimeEstimate()).WillOnce(Return(slow));
+    for (int laser = 0; laser < 2; ++laser) {
+        EXPECT_CALL(listHandlers[laser], getLastExecutedListId()).WillRepeatedly(Return(1));
+        EXPECT_CALL(listHandlers[laser], waitForListCompletion(_)).WillRepeatedly(Return(false));
+    }
+
+    EXPECT_CALL(mockUI, displayMessage(::testing::StartsWith("Estimated scan time for Layer 0: 3.000 s")));
+
+    controller->run();
+}
+
+TEST_F(PrintControllerMultiLaserTest, Run_LaserIndexWithoutABoard_ThrowsConfigurationError) {
+    workPlane.add_vector_blocks()->set_laser_index(2);
+
+    for (int laser = 0; laser < 2; ++laser) {
+        EXPECT_CALL(listHandlers[laser], beginListPreparation()).Times(0);
+    }
+
     ASSERT_THROW(controller->run(), ConfigurationError);
 }
\ No newline at end of file
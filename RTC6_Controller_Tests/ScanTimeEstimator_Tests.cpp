@@ -0,0 +1,243 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "ScanTimeEstimator.h"
+#include "JobTimeEstimator.h"
+#include "CommandBuffer.h"
+#include "MachineConfig.h"
+
+namespace {
+    INT mm(double value) {
+        return static_cast<INT>(value * MachineConfig::MM_TO_BITS_CONVERSION_FACTOR);
+    }
+}
+
+TEST(ScanTimeEstimator_Test, JumpThenMarks_AccountsSpeedsAndDelays) {
+    ScanTimeEstimator estimator;
+    estimator.setMarkSpeed(1000.0);
+    estimator.jumpTo(mm(10.0), 0);
+    estimator.markTo(mm(20.0), 0);
+    estimator.markTo(mm(20.0), mm(10.0));
+
+    const ScanTimeEstimate result = estimator.current();
+
+    EXPECT_DOUBLE_EQ(result.jumpTimeUs, 10.0 / MachineConfig::SCANNER_JUMP_SPEED_MM_S * 1.0e6);
+    EXPECT_DOUBLE_EQ(result.markTimeUs, 20.0 / 1000.0 * 1.0e6);
+    EXPECT_DOUBLE_EQ(result.delayTimeUs,
+        MachineConfig::LIST_COMMAND_TIME_US         // set_mark_speed
+        + MachineConfig::SCANNER_JUMP_DELAY_US      // after the jump
+        + MachineConfig::SCANNER_POLYGON_DELAY_US   // between the two marks
+        + MachineConfig::SCANNER_MARK_DELAY_US);    // pending at the end of the list
+}
+
+TEST(ScanTimeEstimator_Test, LaserOn_AddsPeriodAndClosesMarkSequence) {
+    ScanTimeEstimator estimator;
+    estimator.setMarkSpeed(1000.0);
+    estimator.markTo(mm(1.0), 0);
+    estimator.laserOn(50);
+
+    const ScanTimeEstimate result = estimator.current();
+
+    EXPECT_DOUBLE_EQ(result.markTimeUs, 1000.0 + 500.0);
+    EXPECT_DOUBLE_EQ(result.delayTimeUs, MachineConfig::LIST_COMMAND_TIME_US + MachineConfig::SCANNER_MARK_DELAY_US);
+}
+
+TEST(ScanTimeEstimator_Test, Reset_ClearsTimesButKeepsPositionAndSpeed) {
+    ScanTimeEstimator estimator;
+    estimator.setMarkSpeed(500.0);
+    estimator.jumpTo(mm(5.0), 0);
+    estimator.reset();
+
+    estimator.markTo(mm(6.0), 0);
+    const ScanTimeEstimate result = estimator.current();
+
+    EXPECT_DOUBLE_EQ(result.jumpTimeUs, 0.0);
+    EXPECT_DOUBLE_EQ(result.markTimeUs, 1.0 / 500.0 * 1.0e6);
+}
+
+TEST(ScanTimeEstimator_Test, Estimate_OfRecordedCommands_MatchesIncrementalFeed) {
+    CommandBuffer buffer;
+    buffer.addSetMarkSpeed(800.0);
+    buffer.addSetLaserPower(1, 1000);
+    buffer.addJumpAbsolute(mm(1.0), mm(2.0));
+    buffer.addMarkAbsolute(mm(3.0), mm(2.0));
+    buffer.addJumpAbsolute3D(mm(4.0), mm(4.0), 400);
+    buffer.addMarkAbsolute3D(mm(5.0), mm(4.0), 800);
+    buffer.addLaserOn(3);
+
+    ScanTimeEstimator incremental;
+    incremental.setMarkSpeed(800.0);
+    incremental.parameterCommand();
+    incremental.jumpTo(mm(1.0), mm(2.0));
+    incremental.markTo(mm(3.0), mm(2.0));
+    incremental.jumpTo3D(mm(4.0), mm(4.0), 400);
+    incremental.markTo3D(mm(5.0), mm(4.0), 800);
+    incremental.laserOn(3);
+
+    EXPECT_DOUBLE_EQ(ScanTimeEstimator::estimate(buffer.commands()).totalUs(), incremental.current().totalUs());
+    EXPECT_DOUBLE_EQ(buffer.getListTimeEstimate().totalUs(), incremental.current().totalUs());
+}
+
+TEST(ScanTimeEstimator_Test, SetJumpSpeedAndScannerDelays_ReplaceTheDefaultTimingModel) {
+    ScanTimeEstimator estimator;
+    estimator.setMarkSpeed(1000.0);
+    estimator.setJumpSpeed(10000.0);
+    estimator.setScannerDelays(30.0, 20.0, 10.0);
+    estimator.jumpTo(mm(10.0), 0);
+    estimator.markTo(mm(11.0), 0);
+    estimator.markTo(mm(12.0), 0);
+
+    const ScanTimeEstimate result = estimator.current();
+
+    EXPECT_DOUBLE_EQ(result.jumpTimeUs, 1000.0);
+    EXPECT_DOUBLE_EQ(result.delayTimeUs, 3 * MachineConfig::LIST_COMMAND_TIME_US + 30.0 + 10.0 + 20.0);
+
+    CommandBuffer buffer;
+    buffer.addSetMarkSpeed(1000.0);
+    buffer.addSetJumpSpeed(10000.0);
+    buffer.addSetScannerDelays(3, 2, 1);
+    buffer.addJumpAbsolute(mm(10.0), 0);
+    buffer.addMarkAbsolute(mm(11.0), 0);
+    buffer.addMarkAbsolute(mm(12.0), 0);
+    EXPECT_DOUBLE_EQ(ScanTimeEstimator::estimate(buffer.commands()).totalUs(), result.totalUs());
+}
+
+TEST(ScanTimeEstimator_Test, SkyWriting_ReplacesMarkDelayWithRunInAndRunOut) {
+    ScanTimeEstimator estimator;
+    estimator.setMarkSpeed(1000.0);
+    estimator.setScannerDelays(30.0, 20.0, 10.0);
+    estimator.setSkyWritingRunInOut(90.0, 40.0);
+    estimator.setSkyWritingMode(1);
+    estimator.jumpTo(mm(10.0), 0);
+    estimator.markTo(mm(11.0), 0);
+    estimator.markTo(mm(12.0), 0);
+    estimator.jumpTo(0, 0);
+
+    const ScanTimeEstimate result = estimator.current();
+
+    // Run-in before the first mark, polygon delay at the corner, run-out instead of the mark delay.
+    EXPECT_DOUBLE_EQ(result.delayTimeUs, 4 * MachineConfig::LIST_COMMAND_TIME_US + 2 * 30.0 + 90.0 + 10.0 + 40.0);
+
+    CommandBuffer buffer;
+    buffer.addSetMarkSpeed(1000.0);
+    buffer.addSetScannerDelays(3, 2, 1);
+    buffer.addSetSkyWritingParams(174.0, 0, 9, 4);
+    buffer.addSetSkyWritingMode(1);
+    buffer.addJumpAbsolute(mm(10.0), 0);
+    buffer.addMarkAbsolute(mm(11.0), 0);
+    buffer.addMarkAbsolute(mm(12.0), 0);
+    buffer.addJumpAbsolute(0, 0);
+    EXPECT_DOUBLE_EQ(ScanTimeEstimator::estimate(buffer.commands()).totalUs(), result.totalUs());
+}
+
+TEST(ScanTimeEstimator_Test, ScanaheadDelayModel_UsesFixedSettlingTimesAndIgnoresListDelays) {
+    CommandBuffer buffer;
+    buffer.addSetMarkSpeed(1000.0);
+    buffer.addSetScannerDelays(30, 20, 10);
+    buffer.addJumpAbsolute(mm(10.0), 0);
+    buffer.addMarkAbsolute(mm(11.0), 0);
+    buffer.addMarkAbsolute(mm(12.0), 0);
+
+    const ScanTimeEstimate manual = ScanTimeEstimator::estimate(buffer.commands(), MachineConfig::DelayModel::Manual);
+    const ScanTimeEstimate scanahead = ScanTimeEstimator::estimate(buffer.commands(), MachineConfig::DelayModel::ScanaheadAuto);
+
+    EXPECT_DOUBLE_EQ(manual.delayTimeUs, 2 * MachineConfig::LIST_COMMAND_TIME_US + 300.0 + 100.0 + 200.0);
+    EXPECT_DOUBLE_EQ(scanahead.delayTimeUs, 2 * MachineConfig::LIST_COMMAND_TIME_US
+        + MachineConfig::SCANAHEAD_JUMP_DELAY_US + MachineConfig::SCANAHEAD_POLYGON_DELAY_US + MachineConfig::SCANAHEAD_MARK_DELAY_US);
+    EXPECT_DOUBLE_EQ(scanahead.markTimeUs, manual.markTimeUs);
+    EXPECT_DOUBLE_EQ(scanahead.jumpTimeUs, manual.jumpTimeUs);
+}
+
+TEST(ScanTimeEstimator_Test, JumpMode_UsesJumpModeSpeedAndDelay) {
+    ScanTimeEstimator estimator;
+    estimator.setJumpMode(true);
+    estimator.jumpTo(mm(30.0), 0);
+    estimator.setJumpMode(false);
+    estimator.jumpTo(mm(40.0), 0);
+
+    const ScanTimeEstimate result = estimator.current();
+
+    EXPECT_DOUBLE_EQ(result.jumpTimeUs, 30.0 / MachineConfig::JUMP_MODE_SPEED_MM_S * 1.0e6
+        + 10.0 / MachineConfig::SCANNER_JUMP_SPEED_MM_S * 1.0e6);
+    EXPECT_DOUBLE_EQ(result.delayTimeUs, 2 * MachineConfig::LIST_COMMAND_TIME_US
+        + MachineConfig::JUMP_MODE_DELAY_US + MachineConfig::SCANNER_JUMP_DELAY_US);
+}
+
+TEST(ScanTimeEstimator_Test, VariablePolygonDelay_ScalesDelayWithCornerAngle) {
+    ScanTimeEstimator estimator(MachineConfig::DelayModel::Manual);
+    estimator.setVariablePolygonDelay(true);
+    estimator.setMarkSpeed(1000.0);
+    estimator.setScannerDelays(0.0, 0.0, 100.0);
+    estimator.jumpTo(0, 0);
+    estimator.markTo(1000, 0);
+    estimator.markTo(2000, 0);      // Straight on: no delay.
+    estimator.markTo(2000, 1000);   // 90 degrees: half the delay.
+    estimator.markTo(2000, 0);      // Reversal: the full delay.
+    const double delaysWithVariableDelay = estimator.current().delayTimeUs;
+
+    ScanTimeEstimator constant(MachineConfig::DelayModel::Manual);
+    constant.setVariablePolygonDelay(false);
+    constant.setMarkSpeed(1000.0);
+    constant.setScannerDelays(0.0, 0.0, 100.0);
+    constant.jumpTo(0, 0);
+    constant.markTo(1000, 0);
+    constant.markTo(2000, 0);
+    constant.markTo(2000, 1000);
+    constant.markTo(2000, 0);
+
+    EXPECT_DOUBLE_EQ(delaysWithVariableDelay, 2 * MachineConfig::LIST_COMMAND_TIME_US + 50.0 + 100.0);
+    EXPECT_DOUBLE_EQ(constant.current().delayTimeUs, 2 * MachineConfig::LIST_COMMAND_TIME_US + 3 * 100.0);
+}
+
+TEST(JobTimeEstimator_Test, EstimatedJobUs_ExtrapolatesUnpreparedLayersAndAddsRecoating) {
+    JobTimeEstimator job(4, 100);
+    ScanTimeEstimate layer;
+    layer.markTimeUs = 2.0e6;
+    job.addLayerEstimate(layer);
+
+    // 4 layers x 2 s scanning + 4 x 100 ms recoating.
+    EXPECT_DOUBLE_EQ(job.estimatedJobUs(), 8.0e6 + 0.4e6);
+}
+
+TEST(JobTimeEstimator_Test, AddMeasurement_ScalesEstimatesByMeasuredToModelledRatio) {
+    JobTimeEstimator job(2, 0);
+    ScanTimeEstimate layer;
+    layer.jumpTimeUs = 1.0e6;
+    job.addLayerEstimate(layer);
+    EXPECT_DOUBLE_EQ(job.getCalibrationFactor(), 1.0);
+
+    job.addMeasurement(1.0e6, 1.5e6);
+    job.addMeasurement(3.0e6, 4.5e6);
+    job.addMeasurement(0.0, 1.0e6); // Ignored: nothing was modelled.
+
+    EXPECT_DOUBLE_EQ(job.getCalibrationFactor(), 1.5);
+    EXPECT_DOUBLE_EQ(job.calibratedLayerUs(layer), 1.5e6);
+    EXPECT_DOUBLE_EQ(job.estimatedJobUs(), 3.0e6);
+}
+
+TEST(ScanTimeEstimator_Test, ListLoop_CountsTheBodyOncePerPass) {
+    ScanTimeEstimator estimator;
+    estimator.setMarkSpeed(1000.0);
+    estimator.setJumpSpeed(10000.0);
+    estimator.setScannerDelays(30.0, 20.0, 10.0);
+    estimator.beginRepeat();
+    estimator.jumpTo(mm(10.0), 0);
+    estimator.markTo(mm(11.0), 0);
+    estimator.endRepeat(3);
+
+    const ScanTimeEstimate result = estimator.current();
+    const double commandUs = MachineConfig::LIST_COMMAND_TIME_US;
+
+    EXPECT_DOUBLE_EQ(result.jumpTimeUs, 3 * 1000.0);
+    EXPECT_DOUBLE_EQ(result.markTimeUs, 3 * 1000.0);
+    EXPECT_DOUBLE_EQ(result.delayTimeUs, 4 * commandUs + 3 * (30.0 + 20.0 + commandUs));
+
+    CommandBuffer buffer;
+    buffer.addSetMarkSpeed(1000.0);
+    buffer.addSetJumpSpeed(10000.0);
+    buffer.addSetScannerDelays(3, 2, 1);
+    buffer.addListRepeat();
+    buffer.addJumpAbsolute(mm(10.0), 0);
+    buffer.addMarkAbsolute(mm(11.0), 0);
+    buffer.addListUntil(3);
+    EXPECT_DOUBLE_EQ(ScanTimeEstimator::estimate(buffer.commands()).totalUs(), result.totalUs());
+}
\ No newline at end of file
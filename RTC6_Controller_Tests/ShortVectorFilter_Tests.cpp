@@ -0,0 +1,64 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "ShortVectorFilter.h"
+#include <vector>
+
+TEST(ShortVectorFilter_Test, FilterHatches_ZeroMinLength_LeavesBufferUntouched) {
+    std::vector<INT> hatches = { 0, 0, 1, 0,   10, 10, 10, 11 };
+    const auto result = ShortVectorFilter::filterHatches(hatches.data(), 2, 0.0, 5.0);
+
+    EXPECT_EQ(result.hatchCount, 2u);
+    EXPECT_EQ(result.droppedVectors, 0u);
+    EXPECT_EQ(result.mergedVectors, 0u);
+}
+
+TEST(ShortVectorFilter_Test, FilterHatches_IsolatedMicroHatch_IsDroppedAndOthersCompacted) {
+    std::vector<INT> hatches = {
+        0, 0, 1000, 0,        // long
+        5000, 5000, 5010, 5000, // 10 bits, isolated
+        0, 100, 1000, 100     // long
+    };
+    const auto result = ShortVectorFilter::filterHatches(hatches.data(), 3, 40.0, 8.0);
+
+    ASSERT_EQ(result.hatchCount, 2u);
+    EXPECT_EQ(result.droppedVectors, 1u);
+    EXPECT_DOUBLE_EQ(result.droppedLengthBits, 10.0);
+    EXPECT_EQ(std::vector<INT>(hatches.begin(), hatches.begin() + 8),
+        (std::vector<INT>{ 0, 0, 1000, 0, 0, 100, 1000, 100 }));
+}
+
+TEST(ShortVectorFilter_Test, FilterHatches_CollinearMicroHatchesWithinTolerance_AreMergedIntoOne) {
+    std::vector<INT> hatches = {
+        0, 0, 30, 0,
+        33, 1, 60, 1,   // gap 3 bits, 1 bit off the line
+        62, 0, 90, 0
+    };
+    const auto result = ShortVectorFilter::filterHatches(hatches.data(), 3, 40.0, 4.0);
+
+    ASSERT_EQ(result.hatchCount, 1u);
+    EXPECT_EQ(result.mergedVectors, 2u);
+    EXPECT_EQ(result.droppedVectors, 0u);
+    EXPECT_EQ(std::vector<INT>(hatches.begin(), hatches.begin() + 4), (std::vector<INT>{ 0, 0, 90, 0 }));
+}
+
+TEST(ShortVectorFilter_Test, FilterHatches_MicroHatchesNotMergeable_AreDropped) {
+    std::vector<INT> hatches = {
+        0, 0, 30, 0,
+        30, 0, 0, 0,     // opposite direction (typical alternating hatch)
+        100, 0, 130, 0,  // gap too large
+        130, 0, 130, 30  // perpendicular
+    };
+    const auto result = ShortVectorFilter::filterHatches(hatches.data(), 4, 40.0, 4.0);
+
+    EXPECT_EQ(result.hatchCount, 0u);
+    EXPECT_EQ(result.mergedVectors, 0u);
+    EXPECT_EQ(result.droppedVectors, 4u);
+}
+
+TEST(ShortVectorFilter_Test, FilterHatches_TwoLongCollinearHatches_AreNotMerged) {
+    std::vector<INT> hatches = { 0, 0, 1000, 0,   1001, 0, 2000, 0 };
+    const auto result = ShortVectorFilter::filterHatches(hatches.data(), 2, 40.0, 4.0);
+
+    EXPECT_EQ(result.hatchCount, 2u);
+    EXPECT_EQ(result.mergedVectors, 0u);
+}
\ No newline at end of file
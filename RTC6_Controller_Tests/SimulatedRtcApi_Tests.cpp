@@ -0,0 +1,203 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "SimulatedRtcApi.h"
+#include "ListHandler.h"
+#include "MachineConfig.h"
+#include "Rtc6Constants.h"
+
+namespace {
+    INT mm(double value) {
+        return static_cast<INT>(value * MachineConfig::MM_TO_BITS_CONVERSION_FACTOR);
+    }
+
+    // The speed unit of set_jump_speed for a speed in mm/s.
+    double bitsPerMs(double mmPerS) {
+        return mmPerS * MachineConfig::MM_TO_BITS_CONVERSION_FACTOR / 1000.0;
+    }
+
+    // One list that jumps 10 mm at 10000 mm/s: 1 ms of travel plus the jump delay and two
+    // parameter commands.
+    void loadJumpList(SimulatedRtcApi& board, UINT listNo) {
+        board.api_set_start_list(listNo);
+        board.api_set_jump_speed(bitsPerMs(10000.0));
+        board.api_set_scanner_delays(10, 0, 0);
+        board.api_jump_abs(listNo == 1 ? mm(10.0) : 0, 0);
+        board.api_set_end_of_list();
+    }
+
+    constexpr double JUMP_LIST_US = 1000.0 + 100.0 + 2 * MachineConfig::LIST_COMMAND_TIME_US;
+}
+
+TEST(SimulatedRtcApi_Test, ExecuteList_RunsForTheModelledTimeWithBusyBitSet) {
+    SimulatedRtcApi board;
+    loadJumpList(board, 1);
+
+    board.api_execute_list(1);
+    const double startUs = board.nowUs();
+    EXPECT_EQ(board.api_read_status(), Rtc6Constants::Status::BUSY1);
+
+    board.advanceUs(JUMP_LIST_US - (board.nowUs() - startUs) - 5.0);
+    board.api_jump_abs(0, 0); // No list open: rejected, but ends the poll streak.
+    EXPECT_EQ(board.api_read_status(), Rtc6Constants::Status::BUSY1);
+    board.advanceUs(10.0);
+    EXPECT_EQ(board.api_read_status(), 0u);
+
+    const SimulationStats stats = board.stats();
+    EXPECT_EQ(stats.listsExecuted, 1u);
+    EXPECT_DOUBLE_EQ(stats.busyUs, JUMP_LIST_US);
+    EXPECT_EQ(stats.rejectedCalls, 1u);
+}
+
+TEST(SimulatedRtcApi_Test, WaitLoop_FastForwardsVirtualTimeToTheListEnd) {
+    SimulatedRtcApi board;
+    loadJumpList(board, 1);
+    board.api_execute_list(1);
+
+    int polls = 0;
+    while (board.api_read_status() != 0) {
+        ASSERT_LT(++polls, 10);
+    }
+
+    EXPECT_GE(board.nowUs(), JUMP_LIST_US);
+    EXPECT_LT(board.nowUs(), JUMP_LIST_US + 20.0);
+}
+
+TEST(SimulatedRtcApi_Test, AutoChange_StartsTheOtherListWithoutAGap) {
+    SimulatedRtcApi board;
+    loadJumpList(board, 1);
+    board.api_execute_list(1);
+    loadJumpList(board, 2);
+    board.api_auto_change();
+
+    board.advanceUs(JUMP_LIST_US);
+    EXPECT_EQ(board.api_read_status(), Rtc6Constants::Status::BUSY2);
+    board.advanceUs(JUMP_LIST_US);
+    EXPECT_EQ(board.api_read_status(), 0u);
+
+    const SimulationStats stats = board.stats();
+    EXPECT_EQ(stats.listsExecuted, 2u);
+    EXPECT_EQ(stats.gapCount, 0u);
+    EXPECT_DOUBLE_EQ(stats.idleUs, 0.0);
+}
+
+TEST(SimulatedRtcApi_Test, AutoChangeWhileIdle_StaysPendingAndRestartsTheOldList) {
+    SimulatedRtcApi board;
+    loadJumpList(board, 1);
+    board.api_execute_list(1);
+    board.advanceUs(JUMP_LIST_US + 10.0);
+    loadJumpList(board, 2);
+    board.api_auto_change(); // Too late: list 1 has already ended.
+    board.api_execute_list(2);
+
+    board.advanceUs(JUMP_LIST_US);
+    EXPECT_EQ(board.api_read_status(), Rtc6Constants::Status::BUSY1);
+
+    const SimulationStats stats = board.stats();
+    EXPECT_EQ(stats.staleAutoChanges, 1u);
+    EXPECT_EQ(stats.listsExecuted, 3u);
+}
+
+TEST(SimulatedRtcApi_Test, StopExecution_CancelsAPendingAutoChange) {
+    SimulatedRtcApi board;
+    loadJumpList(board, 1);
+    board.api_execute_list(1);
+    board.advanceUs(JUMP_LIST_US + 10.0);
+    loadJumpList(board, 2);
+    board.api_auto_change();
+    board.api_stop_execution();
+    board.api_execute_list(2);
+
+    board.advanceUs(JUMP_LIST_US);
+    EXPECT_EQ(board.api_read_status(), 0u);
+    EXPECT_EQ(board.stats().listsExecuted, 2u);
+}
+
+TEST(SimulatedRtcApi_Test, ExecuteAfterIdle_RecordsTheGap) {
+    SimulatedRtcApi board;
+    loadJumpList(board, 1);
+    board.api_execute_list(1);
+    board.advanceUs(JUMP_LIST_US + 500.0);
+    loadJumpList(board, 2);
+    board.api_execute_list(2);
+
+    const SimulationStats stats = board.stats();
+    EXPECT_EQ(stats.gapCount, 1u);
+    EXPECT_GT(stats.idleUs, 500.0);
+    EXPECT_DOUBLE_EQ(stats.maxGapUs, stats.idleUs);
+}
+
+TEST(SimulatedRtcApi_Test, ListLoop_RunsItsBodyOncePerPass) {
+    SimulatedRtcApi board;
+    board.api_set_start_list(1);
+    board.api_set_jump_speed(bitsPerMs(10000.0));
+    board.api_set_scanner_delays(10, 0, 0);
+    board.api_list_repeat();
+    board.api_jump_abs(mm(10.0), 0);
+    board.api_jump_abs(0, 0);
+    board.api_list_until(3);
+    board.api_set_end_of_list();
+
+    board.api_execute_list(1);
+    board.advanceUs(1.0e6);
+
+    const double commandUs = MachineConfig::LIST_COMMAND_TIME_US;
+    EXPECT_DOUBLE_EQ(board.stats().busyUs, 3 * commandUs + 3 * (2 * (1000.0 + 100.0) + commandUs));
+}
+
+TEST(SimulatedRtcApi_Test, SubCall_RunsTheSubroutineFromTheCurrentPosition) {
+    SimulatedRtcApi board;
+    board.api_set_start_list(1);
+    board.api_set_jump_speed(bitsPerMs(10000.0));
+    board.api_set_scanner_delays(10, 0, 0);
+    board.api_load_sub(0);
+    board.api_jump_rel(mm(10.0), 0);
+    board.api_jump_rel(-mm(10.0), 0);
+    board.api_list_return();
+    board.api_load_list(1, 2);
+    board.api_sub_call(0);
+    board.api_sub_call(0);
+    board.api_set_end_of_list();
+
+    board.api_execute_list(1);
+    board.advanceUs(1.0e6);
+
+    // Each call: sub_call and list_return as commands, two 10 mm jumps in between.
+    const double commandUs = MachineConfig::LIST_COMMAND_TIME_US;
+    EXPECT_EQ(board.stats().rejectedCalls, 0u);
+    EXPECT_DOUBLE_EQ(board.stats().busyUs, 2 * commandUs + 2 * (2 * commandUs + 2 * (1000.0 + 100.0)));
+}
+
+TEST(SimulatedRtcApi_Test, FullList_RejectsFurtherCommandsAndReportsNoSpace) {
+    SimulatedRtcApi board(SimulatedTime::Virtual, 1.0, 2);
+    board.api_set_start_list(1);
+    EXPECT_EQ(board.api_get_list_space(), 2u);
+    board.api_jump_abs(1, 1);
+    board.api_mark_abs(2, 2);
+    EXPECT_EQ(board.api_get_list_space(), 0u);
+    board.api_mark_abs(3, 3);
+
+    EXPECT_EQ(board.stats().rejectedCalls, 1u);
+}
+
+TEST(SimulatedRtcApi_Test, ListHandlerStreamingAChunkedLayer_KeepsTheBoardBusyBetweenChunks) {
+    constexpr UINT capacity = MachineConfig::LIST_RESERVED_POSITIONS + 50;
+    SimulatedRtcApi board(SimulatedTime::Virtual, 1.0, capacity);
+    SimulatedCommunicator communicator;
+    communicator.connectAndSetupBoard();
+    ListHandler listHandler(communicator, board);
+
+    listHandler.beginListPreparation();
+    listHandler.addSetMarkSpeed(100.0);
+    for (INT i = 0; i < 400; ++i) {
+        listHandler.addMarkAbsolute(mm(i % 2 == 0 ? 5.0 : 0.0), mm(i * 0.01));
+    }
+    listHandler.endListPreparation();
+    listHandler.executeCurrentListAndCycle();
+    listHandler.waitForListCompletion(listHandler.getLastExecutedListId());
+
+    const SimulationStats stats = board.stats();
+    EXPECT_EQ(stats.listsExecuted, 9u); // 401 commands in chunks of 50.
+    EXPECT_EQ(stats.gapCount, 0u);
+    EXPECT_EQ(stats.rejectedCalls, 0u);
+    EXPECT_EQ(board.api_read_status(), 0u);
+}
\ No newline at end of file
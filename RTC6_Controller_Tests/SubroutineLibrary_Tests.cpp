@@ -0,0 +1,106 @@
+#include "pch.h"
+#include "gtest/gtest.h"
+#include "SubroutineLibrary.h"
+
+namespace {
+    // A square of the given size, drawn from its first corner.
+    std::vector<ListCommand> square(INT size) {
+        return {
+            { ListCommand::Type::MarkRel, size, 0 },
+            { ListCommand::Type::MarkRel, 0, size },
+            { ListCommand::Type::MarkRel, -size, 0 },
+            { ListCommand::Type::MarkRel, 0, -size },
+        };
+    }
+}
+
+TEST(SubroutineLibrary_Test, Lookup_RepeatedShape_IsWrittenOutThenLoadedThenCalled) {
+    SubroutineLibrary library(4, 1000, 2);
+
+    EXPECT_EQ(library.lookup(square(10)).action, SubroutineLibrary::Action::Inline);
+    const SubroutineLibrary::Lookup second = library.lookup(square(10));
+    EXPECT_EQ(second.action, SubroutineLibrary::Action::Load);
+    EXPECT_EQ(second.index, 0u);
+    const SubroutineLibrary::Lookup third = library.lookup(square(10));
+    EXPECT_EQ(third.action, SubroutineLibrary::Action::Call);
+    EXPECT_EQ(third.index, 0u);
+
+    EXPECT_EQ(library.loadedCount(), 1u);
+    EXPECT_EQ(library.usedPositions(), 5u); // Four moves and the list_return.
+}
+
+TEST(SubroutineLibrary_Test, Lookup_DifferentOrShortShapes_AreNeverShared) {
+    SubroutineLibrary library(4, 1000, 2);
+    std::vector<ListCommand> jumped = square(10);
+    jumped[1].type = ListCommand::Type::JumpRel;
+
+    library.lookup(square(10));
+    EXPECT_EQ(library.lookup(square(20)).action, SubroutineLibrary::Action::Inline);
+    EXPECT_EQ(library.lookup(jumped).action, SubroutineLibrary::Action::Inline);
+
+    const std::vector<ListCommand> single = { { ListCommand::Type::MarkRel, 5, 5 } };
+    library.lookup(single);
+    EXPECT_EQ(library.lookup(single).action, SubroutineLibrary::Action::Inline);
+    EXPECT_EQ(library.loadedCount(), 0u);
+}
+
+TEST(SubroutineLibrary_Test, Lookup_NoIndexOrMemoryLeft_WritesTheShapeOut) {
+    SubroutineLibrary oneIndex(1, 1000, 1);
+    oneIndex.lookup(square(10));
+    oneIndex.lookup(square(10));
+    oneIndex.lookup(square(20));
+    EXPECT_EQ(oneIndex.lookup(square(20)).action, SubroutineLibrary::Action::Inline);
+
+    SubroutineLibrary smallMemory(4, 4, 1);
+    smallMemory.lookup(square(10));
+    EXPECT_EQ(smallMemory.lookup(square(10)).action, SubroutineLibrary::Action::Inline);
+}
+
+TEST(SubroutineLibrary_Test, BeginLayer_ForgetsShapesSeenOnceButKeepsSubroutines) {
+    SubroutineLibrary library(4, 1000, 2);
+    library.lookup(square(10));
+    library.lookup(square(10));
+    library.lookup(square(20));
+
+    library.beginLayer();
+
+    EXPECT_EQ(library.lookup(square(10)).action, SubroutineLibrary::Action::Call);
+    EXPECT_EQ(library.lookup(square(20)).action, SubroutineLibrary::Action::Inline);
+}
+TEST(SubroutineLibrary_Test, Lookup_LibraryFull_EvictsASubroutineNoListCanStillRun) {
+    SubroutineLibrary library(1, 1000, 1);
+    library.lookup(square(10));
+    library.lookup(square(10));               // Loaded as 0 in layer 1.
+    library.beginLayer();
+    library.lookup(square(20));
+    EXPECT_EQ(library.lookup(square(20)).action, SubroutineLibrary::Action::Inline); // Layer 1 may still run.
+    EXPECT_EQ(library.refusedLoads(), 1u);
+
+    library.beginLayer();
+    library.lookup(square(20));
+    const SubroutineLibrary::Lookup loaded = library.lookup(square(20));
+    EXPECT_EQ(loaded.action, SubroutineLibrary::Action::Load);
+    EXPECT_EQ(loaded.index, 0u);
+    EXPECT_EQ(library.loadedCount(), 1u);
+    EXPECT_EQ(library.usedPositions(), 5u);
+    EXPECT_EQ(library.refusedLoads(), 0u);
+    EXPECT_EQ(library.lookup(square(10)).action, SubroutineLibrary::Action::Inline);
+}
+
+TEST(SubroutineLibrary_Test, Lookup_LibraryFull_KeepsSubroutinesCalledInThePreviousLayer) {
+    SubroutineLibrary library(2, 1000, 1);
+    library.lookup(square(10));
+    library.lookup(square(10));               // 0, called again in layer 2.
+    library.lookup(square(20));
+    library.lookup(square(20));               // 1, last called in layer 1.
+    library.beginLayer();
+    library.lookup(square(10));
+    library.beginLayer();
+
+    library.lookup(square(30));
+    const SubroutineLibrary::Lookup loaded = library.lookup(square(30));
+
+    EXPECT_EQ(loaded.action, SubroutineLibrary::Action::Load);
+    EXPECT_EQ(loaded.index, 1u);
+    EXPECT_EQ(library.lookup(square(10)).action, SubroutineLibrary::Action::Call);
+}
@@ -4,6 +4,8 @@
 #include <chrono>
 #include <stdexcept>
 #include <sstream>
+#include <iomanip>
+#include <algorithm>
 
 PrintController::PrintController(
     InterfaceCommunicator& communicator,
@@ -12,13 +14,22 @@ PrintController::PrintController(
     InterfaceListHandler& listHandler,
     InterfaceGeometryHandler& geoHandler,
     const PrintJobConfig& config
-) : m_communicator(communicator),
-m_parser(parser),
+) : PrintController(parser, ui, { LaserChannel{ communicator, listHandler, geoHandler } }, config) {
+}
+
+PrintController::PrintController(
+    InterfaceOvfParser& parser,
+    InterfaceUI& ui,
+    std::vector<LaserChannel> lasers,
+    const PrintJobConfig& config
+) : m_parser(parser),
 m_ui(ui),
-m_listHandler(listHandler),
-m_geoHandler(geoHandler),
-m_config(config) {
-    // Constructor body is empty, all work is done in the member initializer list.
+m_lasers(std::move(lasers)),
+m_config(config),
+m_laserPool(static_cast<unsigned>(m_lasers.size())) {
+    if (m_lasers.empty()) {
+        throw ConfigurationError("PrintController needs at least one laser.");
+    }
 }
 
 /**
@@ -26,9 +37,11 @@ m_config(config) {
  */
 void PrintController::run() {
     m_ui.displayMessage("--- Initializing Hardware ---");
-    if (!m_communicator.connectAndSetupBoard()) {
-        m_ui.displayError("Hardware initialization failed. Aborting print job.");
-        return;
+    for (auto& laser : m_lasers) {
+        if (!laser.communicator.connectAndSetupBoard()) {
+            m_ui.displayError("Hardware initialization failed. Aborting print job.");
+            return;
+        }
     }
     m_ui.displayMessage("Hardware successfully initialized.");
 
@@ -57,7 +70,8 @@ void PrintController::processOvfJob() {
 
     m_ui.displayMessage("\n--- Starting Layer Processing ---");
 
-    UINT lastListExecuted = 0;
+    std::vector<UINT> lastListExecuted(m_lasers.size(), 0);
+    m_jobTime = JobTimeEstimator(num_layers, m_config.recoatingDelayMs);
 
     for (int i = 0; i < num_layers; ++i) {
         const auto work_plane = m_parser.getWorkPlane(i);
@@ -66,25 +80,88 @@ void PrintController::processOvfJob() {
         waitForPreviousLayer(lastListExecuted);
         executeLayer(work_plane);
 
-        lastListExecuted = m_listHandler.getLastExecutedListId();
+        for (size_t laser = 0; laser < m_lasers.size(); ++laser) {
+            lastListExecuted[laser] = m_lasers[laser].listHandler.getLastExecutedListId();
+        }
     }
 
     waitForPreviousLayer(lastListExecuted);
     m_ui.displayMessage("\n--- All " + std::to_string(num_layers) + " Layers Processed ---");
+    reportHandoverLatency();
 }
 
 void PrintController::prepareLayer(const open_vector_format::WorkPlane& workPlane, const open_vector_format::Job& jobShell) {
-    std::string progressMsg = "Preparing geometry on List " + std::to_string(m_listHandler.getCurrentFillListId());
+    // Every board fills and executes the same list ids in lockstep, so the first one speaks for all.
+    std::string progressMsg = "Preparing geometry on List " + std::to_string(m_lasers.front().listHandler.getCurrentFillListId());
     m_ui.displayProgress(progressMsg, workPlane.work_plane_number(), m_parser.getNumberOfWorkPlanes());
 
-    m_listHandler.beginListPreparation();
-    for (const auto& block : workPlane.vector_blocks()) {
+    splitBlocksByLaser(workPlane);
+    m_laserPool.run(m_lasers.size(), [&](unsigned, size_t laser) {
+        prepareLaserLayer(laser, workPlane, jobShell);
+    });
+
+    // The boards scan in parallel, so the layer takes as long as its slowest laser.
+    ScanTimeEstimate layerEstimate;
+    for (auto& laser : m_lasers) {
+        const ScanTimeEstimate estimate = laser.listHandler.getListTimeEstimate();
+        if (estimate.totalUs() > layerEstimate.totalUs()) {
+            layerEstimate = estimate;
+        }
+    }
+    // The layer is scanned once and then repeated, each pass taking as long as the first.
+    const double passes = 1.0 + workPlane.repeats();
+    layerEstimate.markTimeUs *= passes;
+    layerEstimate.jumpTimeUs *= passes;
+    layerEstimate.delayTimeUs *= passes;
+    m_preparedLayerModelledUs = layerEstimate.totalUs();
+    m_jobTime.addLayerEstimate(layerEstimate);
+    reportLayerEstimate(workPlane, layerEstimate);
+
+    ShortVectorStats shortVectors;
+    for (auto& laser : m_lasers) {
+        shortVectors += laser.geoHandler.getShortVectorStats();
+    }
+    if (shortVectors.droppedVectors > 0 || shortVectors.mergedVectors > 0) {
+        std::stringstream filter_ss;
+        filter_ss << "Short-vector filter: dropped " << shortVectors.droppedVectors
+            << ", merged " << shortVectors.mergedVectors
+            << " vector(s), est. " << shortVectors.estimatedTimeSavedUs / 1000.0 << " ms saved.";
+        m_ui.displayMessage(filter_ss.str());
+    }
+}
+
+void PrintController::splitBlocksByLaser(const open_vector_format::WorkPlane& workPlane) {
+    m_laserBlocks.assign(m_lasers.size(), {});
+    for (int i = 0; i < workPlane.vector_blocks_size(); ++i) {
+        size_t laser = 0;
+        if (m_lasers.size() > 1) {
+            const int32_t laserIndex = workPlane.vector_blocks(i).laser_index();
+            if (laserIndex < 0 || laserIndex >= static_cast<int32_t>(m_lasers.size())) {
+                std::stringstream error_ss;
+                error_ss << "Vector block " << i << " of layer " << workPlane.work_plane_number()
+                    << " has laser_index " << laserIndex << ", but the machine has " << m_lasers.size() << " lasers.";
+                throw ConfigurationError(error_ss.str());
+            }
+            laser = static_cast<size_t>(laserIndex);
+        }
+        m_laserBlocks[laser].push_back(i);
+    }
+}
+
+// Runs on a pool worker and only touches the handlers of its own laser.
+void PrintController::prepareLaserLayer(size_t laser, const open_vector_format::WorkPlane& workPlane, const open_vector_format::Job& jobShell) {
+    LaserChannel& channel = m_lasers[laser];
+    channel.listHandler.retainLayerForRepeat(workPlane.repeats() > 0);
+    channel.listHandler.beginListPreparation();
+    channel.geoHandler.beginWorkPlane(workPlane);
+    for (const int index : m_laserBlocks[laser]) {
+        const auto& block = workPlane.vector_blocks(index);
         const auto& params_map = jobShell.marking_params_map();
         auto it = params_map.find(block.marking_params_key());
 
         if (it != params_map.end()) {
             const auto& params = it->second;
-            m_geoHandler.processVectorBlock(block, params);
+            channel.geoHandler.processVectorBlock(block, params);
         }
         else {
             std::stringstream error_ss;
@@ -93,19 +170,31 @@ void PrintController::prepareLayer(const open_vector_format::WorkPlane& workPlan
             throw ConfigurationError(error_ss.str());
         }
     }
-    m_listHandler.endListPreparation();
+    channel.geoHandler.endWorkPlane();
+    channel.listHandler.endListPreparation();
 }
 
-void PrintController::waitForPreviousLayer(UINT listId) {
-    if (listId == 0) {
+void PrintController::waitForPreviousLayer(const std::vector<UINT>& listIds) {
+    if (std::all_of(listIds.begin(), listIds.end(), [](UINT listId) { return listId == 0; })) {
         return;
     }
 
-    m_ui.displayMessage("Waiting for previous layer on List " + std::to_string(listId) + " to finish...");
-    while (m_listHandler.isListBusy(listId)) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    bool wasStillBusy = false;
+    for (size_t laser = 0; laser < m_lasers.size(); ++laser) {
+        const UINT listId = listIds[laser];
+        if (listId == 0) {
+            continue;
+        }
+        m_ui.displayMessage(laserLabel(laser) + "Waiting for previous layer on List " + std::to_string(listId) + " to finish...");
+        wasStillBusy = m_lasers[laser].listHandler.waitForListCompletion(listId) || wasStillBusy;
+        m_ui.displayMessage(laserLabel(laser) + "List " + std::to_string(listId) + " is now free.");
+    }
+    // Only a list that was still running when we started waiting gives a usable
+    // measurement; otherwise it finished at some unknown point during preparation.
+    if (wasStillBusy) {
+        const auto measured = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_layerStartTime);
+        m_jobTime.addMeasurement(m_executingLayerModelledUs, measured.count());
     }
-    m_ui.displayMessage("List " + std::to_string(listId) + " is now free.");
 
     std::stringstream recoat_ss;
     recoat_ss << "Simulating " << m_config.recoatingDelayMs << "ms for powder bed recoating...";
@@ -115,7 +204,86 @@ void PrintController::waitForPreviousLayer(UINT listId) {
 
 void PrintController::executeLayer(const open_vector_format::WorkPlane& workPlane) {
     std::stringstream exec_ss;
-    exec_ss << "Executing Layer " << workPlane.work_plane_number() << " on List " << m_listHandler.getCurrentFillListId() << ".";
+    exec_ss << "Executing Layer " << workPlane.work_plane_number() << " on List " << m_lasers.front().listHandler.getCurrentFillListId() << ".";
     m_ui.displayMessage(exec_ss.str());
-    m_listHandler.executeCurrentListAndCycle();
+    m_executingLayerModelledUs = m_preparedLayerModelledUs;
+    m_layerStartTime = std::chrono::steady_clock::now();
+    // Executing a layer that did not fit into one list also streams its remaining chunks,
+    // which only returns once the last chunk is loaded, so each board needs its own thread.
+    m_laserPool.run(m_lasers.size(), [this](unsigned, size_t laser) {
+        m_lasers[laser].listHandler.executeCurrentListAndCycle();
+    });
+    repeatLayer(workPlane);
+}
+
+/**
+ * @brief Scans the layer again for each of its repeats, without recoating in between.
+ *
+ * Each pass starts once the previous one has finished; the last pass runs while the
+ * next layer is prepared, as a single pass would.
+ * @throws HardwareError if a board cannot run a pass, so the layer is never reported
+ *         as done with a pass missing.
+ */
+void PrintController::repeatLayer(const open_vector_format::WorkPlane& workPlane) {
+    const uint32_t repeats = workPlane.repeats();
+    for (uint32_t pass = 1; pass <= repeats; ++pass) {
+        std::stringstream repeat_ss;
+        repeat_ss << "Repeating Layer " << workPlane.work_plane_number() << " (pass " << pass + 1 << " of " << repeats + 1 << ").";
+        m_ui.displayMessage(repeat_ss.str());
+        m_laserPool.run(m_lasers.size(), [this, &workPlane, pass](unsigned, size_t laser) {
+            if (!m_lasers[laser].listHandler.repeatLastLayer()) {
+                std::stringstream error_ss;
+                error_ss << laserLabel(laser) << "Pass " << pass + 1 << " of Layer " << workPlane.work_plane_number()
+                    << " could not be started.";
+                throw HardwareError(error_ss.str());
+            }
+        });
+    }
+}
+
+std::string PrintController::laserLabel(size_t laser) const {
+    return m_lasers.size() > 1 ? "Laser " + std::to_string(laser + 1) + ": " : std::string();
+}
+
+/**
+ * @brief Summarizes how long the host took to notice that a list had ended.
+ *
+ * Only waits that actually blocked contribute, so nothing is shown if every list
+ * had already finished by the time the next layer was ready.
+ */
+void PrintController::reportHandoverLatency() {
+    for (size_t laser = 0; laser < m_lasers.size(); ++laser) {
+        const LatencyHistogram latency = m_lasers[laser].listHandler.getHandoverLatency();
+        if (latency.count() == 0) {
+            continue;
+        }
+
+        std::stringstream latency_ss;
+        latency_ss << std::fixed << std::setprecision(0) << laserLabel(laser)
+            << "List hand-over latency over " << latency.count() << " wait(s): p50 <= " << latency.percentileUs(50.0)
+            << " us, p99 <= " << latency.percentileUs(99.0) << " us, max " << latency.maxUs() << " us.";
+        m_ui.displayMessage(latency_ss.str());
+    }
+}
+
+/**
+ * @brief Shows the scan-time estimate of the layer just prepared and the updated job estimate.
+ *
+ * Both are scaled by the calibration factor learned from earlier measured layers.
+ * Nothing is shown for a layer without any modelled scan time.
+ */
+void PrintController::reportLayerEstimate(const open_vector_format::WorkPlane& workPlane, const ScanTimeEstimate& estimate) {
+    if (estimate.totalUs() <= 0.0) {
+        return;
+    }
+
+    const double factor = m_jobTime.getCalibrationFactor();
+    std::stringstream est_ss;
+    est_ss << std::fixed << std::setprecision(3)
+        << "Estimated scan time for Layer " << workPlane.work_plane_number() << ": "
+        << m_jobTime.calibratedLayerUs(estimate) / 1.0e6 << " s (mark " << estimate.markTimeUs * factor / 1.0e6
+        << " s, jump " << estimate.jumpTimeUs * factor / 1.0e6
+        << " s, delays " << estimate.delayTimeUs * factor / 1.0e6 << " s). "
+        << std::setprecision(1) << "Estimated job time: " << m_jobTime.estimatedJobUs() / 60.0e6 << " min.";
+    m_ui.displayMessage(est_ss.str());
 }
\ No newline at end of file
@@ -8,6 +8,20 @@
 #include "InterfaceUI.h"
 
 #include "PrintJobConfig.h"
+#include "JobTimeEstimator.h"
+#include "WorkerPool.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The handlers that drive the RTC6 board of one laser.
+ */
+struct LaserChannel {
+    InterfaceCommunicator& communicator;
+    InterfaceListHandler& listHandler;
+    InterfaceGeometryHandler& geoHandler;
+};
 
 class PrintController : public InterfacePrintController {
 public:
@@ -20,19 +34,49 @@ public:
         InterfaceGeometryHandler& geoHandler,
         const PrintJobConfig& config);
 
+    /**
+     * @brief A controller for a machine with one board per laser.
+     *
+     * Each layer's vector blocks are split by laser_index, and every laser's list is
+     * filled and executed on its own thread. A layer ends when all boards are idle.
+     * @param lasers One channel per laser, in laser_index order. Must not be empty.
+     */
+    PrintController(
+        InterfaceOvfParser& parser,
+        InterfaceUI& ui,
+        std::vector<LaserChannel> lasers,
+        const PrintJobConfig& config);
+
     void run() override;
 
 private:
     void processOvfJob();
     void prepareLayer(const open_vector_format::WorkPlane& workPlane, const open_vector_format::Job& jobShell);
-    void waitForPreviousLayer(UINT listId);
+    // Assigns the layer's blocks to the lasers. With one laser, all blocks go to it.
+    void splitBlocksByLaser(const open_vector_format::WorkPlane& workPlane);
+    void prepareLaserLayer(size_t laser, const open_vector_format::WorkPlane& workPlane, const open_vector_format::Job& jobShell);
+    // Blocks until every laser's last list is idle. Entries of 0 have nothing to wait for.
+    void waitForPreviousLayer(const std::vector<UINT>& listIds);
     void executeLayer(const open_vector_format::WorkPlane& workPlane);
+    void repeatLayer(const open_vector_format::WorkPlane& workPlane);
+    void reportLayerEstimate(const open_vector_format::WorkPlane& workPlane, const ScanTimeEstimate& estimate);
+    void reportHandoverLatency();
+    // "Laser n: " on a multi-laser machine, empty otherwise.
+    std::string laserLabel(size_t laser) const;
 
     // --- Member variables are INTERFACES ---
-    InterfaceCommunicator& m_communicator;
     InterfaceOvfParser& m_parser;
     InterfaceUI& m_ui;
-    InterfaceListHandler& m_listHandler;
-    InterfaceGeometryHandler& m_geoHandler;
+    std::vector<LaserChannel> m_lasers;
     const PrintJobConfig& m_config;
+
+    // --- Multi-laser dispatch ---
+    WorkerPool m_laserPool;                          // One worker per laser.
+    std::vector<std::vector<int>> m_laserBlocks;     // Block indices of the current layer, per laser.
+
+    // --- Scan-time estimation ---
+    JobTimeEstimator m_jobTime{ 0, 0 };
+    double m_preparedLayerModelledUs = 0.0;   // Estimate of the list prepared last.
+    double m_executingLayerModelledUs = 0.0;  // Estimate of the list started last.
+    std::chrono::steady_clock::time_point m_layerStartTime;
 };
\ No newline at end of file